@@ -0,0 +1,108 @@
+#ifndef LATENCY_BENCH_H_
+#define LATENCY_BENCH_H_
+
+#include "sdkconfig.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// latency benchmark: CONFIG_LATENCY_BENCH_WARMUP untimed calls, then
+// CONFIG_LATENCY_BENCH_ITERATIONS timed ones, each timed on its own with the
+// CPU cycle counter; the distribution (min, median, p90, p99, max and a
+// histogram) is what a latency SLO is checked against, a single sample isn't
+//
+// LATENCY_BENCH_CRITICAL runs every call inside a critical section: the cost
+// of the code alone, but interrupts on that core wait for the whole call;
+// LATENCY_BENCH_PREEMPTIBLE leaves interrupts and the scheduler alone, so the
+// samples include the ISRs and higher-priority tasks that preempt the call,
+// as in production
+//
+// each core has its own cycle counter, so the caller should be pinned to a
+// core (app_main is); a preemptible sample during which the task moved cores
+// is dropped and counted in migrated
+//
+// weights and code run in place from flash, through the cache: a device that
+// wakes up for one inference pays the cold-cache latency, which the warm runs
+// above never see; latency_bench_run_cold (CONFIG_LATENCY_BENCH_COLD) times
+// every call right after latency_bench_evict
+
+#ifndef CONFIG_LATENCY_BENCH_BUCKETS
+#define CONFIG_LATENCY_BENCH_BUCKETS 16
+#endif
+
+typedef enum
+{
+    LATENCY_BENCH_CRITICAL = 0,
+    LATENCY_BENCH_PREEMPTIBLE = 1,
+} latency_bench_mode_t;
+
+// -----------------------------------------------------------------------------
+// 32-bit cycle counter extended to 64 bits: it wraps every 2^32 cycles (~18 s
+// at 240 MHz), so a run longer than that can't be timed with one subtraction;
+// latency_bench_cycles must be called at least once per wrap
+typedef struct
+{
+    uint32_t last;
+    uint64_t high;
+} latency_bench_clock_t;
+
+// -----------------------------------------------------------------------------
+// cycles, over the timed samples
+typedef struct
+{
+    latency_bench_mode_t mode;
+    int cold;               // latency_bench_run_cold
+    uint32_t count;         // samples kept
+    uint32_t migrated;      // dropped, see above
+    uint32_t min;
+    uint32_t median;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t max;
+    uint32_t mean;
+    uint64_t total;         // first timed call to last, wall clock (evictions included)
+    uint32_t cpu_mhz;
+    uint32_t bucket_width;  // bucket b counts [min + b * width, min + (b + 1) * width)
+    uint32_t buckets[CONFIG_LATENCY_BENCH_BUCKETS];
+    uint32_t above_p99;
+} latency_bench_stats_t;
+
+typedef void (*latency_bench_fn)(void *arg);
+
+// -----------------------------------------------------------------------------
+uint64_t latency_bench_cycles(latency_bench_clock_t *clock);
+
+// -----------------------------------------------------------------------------
+// run fn(arg) CONFIG_LATENCY_BENCH_WARMUP + CONFIG_LATENCY_BENCH_ITERATIONS
+// times in mode; returns 0, or -1 if the samples can't be allocated or every
+// sample was dropped
+int latency_bench_run(latency_bench_mode_t mode, latency_bench_fn fn, void *arg, latency_bench_stats_t *stats);
+
+// -----------------------------------------------------------------------------
+// stream the data partition CONFIG_LATENCY_BENCH_EVICT_PARTITION (mapped on
+// first use) through the flash cache, one read per cache line, so the next
+// reads from flash (.rodata weights, a mapped model partition) miss; targets
+// with a unified cache (ESP32, ESP32-C3) lose the cached code as well, the
+// ESP32-S3's separate instruction cache keeps it; returns -1 without that
+// partition or CONFIG_LATENCY_BENCH_COLD
+int latency_bench_evict(void);
+
+// -----------------------------------------------------------------------------
+// run fn(arg) CONFIG_LATENCY_BENCH_COLD_ITERATIONS times in mode, each after
+// latency_bench_evict, without warm-up; returns -1 as latency_bench_run, or
+// if latency_bench_evict fails
+int latency_bench_run_cold(latency_bench_mode_t mode, latency_bench_fn fn, void *arg, latency_bench_stats_t *stats);
+
+// -----------------------------------------------------------------------------
+// log the statistics and the histogram under tag
+void latency_bench_print(const char *tag, const char *name, const latency_bench_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,285 @@
+#include "latency_bench.h"
+
+#include "esp_cpu.h"
+#include "esp_log.h"
+#if CONFIG_LATENCY_BENCH_COLD
+#include "esp_partition.h"
+#endif
+#include "esp_rom_sys.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HISTOGRAM_BAR   40
+// smallest cache line of the supported targets
+#define EVICT_STRIDE    16
+
+static portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// -----------------------------------------------------------------------------
+uint64_t latency_bench_cycles(latency_bench_clock_t *clock)
+{
+    uint32_t now = esp_cpu_get_cycle_count();
+    if (now < clock->last)
+    {
+        clock->high += 1ull << 32;
+    }
+    clock->last = now;
+    return clock->high | now;
+}
+
+// -----------------------------------------------------------------------------
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// -----------------------------------------------------------------------------
+// nearest-rank percentile over sorted samples
+static uint32_t percentile(const uint32_t *sorted, uint32_t count, uint32_t pct)
+{
+    uint32_t rank = (uint32_t)(((uint64_t)pct * count + 99) / 100);
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+    return sorted[rank - 1];
+}
+
+// -----------------------------------------------------------------------------
+// one timed call; returns 0 if the task moved cores mid-call (the two cycle
+// counts then come from different counters)
+static int sample(latency_bench_mode_t mode, latency_bench_fn fn, void *arg, uint32_t *cycles)
+{
+    uint32_t start, end;
+
+    if (mode == LATENCY_BENCH_CRITICAL)
+    {
+        portENTER_CRITICAL(&g_lock);
+        start = esp_cpu_get_cycle_count();
+        fn(arg);
+        end = esp_cpu_get_cycle_count();
+        portEXIT_CRITICAL(&g_lock);
+        *cycles = end - start;
+        return 1;
+    }
+
+    int core = esp_cpu_get_core_id();
+    start = esp_cpu_get_cycle_count();
+    fn(arg);
+    end = esp_cpu_get_cycle_count();
+    // modular: one call is far shorter than a wrap
+    *cycles = end - start;
+    return esp_cpu_get_core_id() == core;
+}
+
+// -----------------------------------------------------------------------------
+static void compute_stats(uint32_t *samples, latency_bench_stats_t *stats)
+{
+    uint32_t count = stats->count;
+    uint64_t sum = 0;
+
+    qsort(samples, count, sizeof(uint32_t), compare_u32);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        sum += samples[i];
+    }
+
+    stats->min = samples[0];
+    stats->median = percentile(samples, count, 50);
+    stats->p90 = percentile(samples, count, 90);
+    stats->p99 = percentile(samples, count, 99);
+    stats->max = samples[count - 1];
+    stats->mean = (uint32_t)(sum / count);
+
+    // [min, p99] in equal buckets, the tail in above_p99
+    uint32_t span = stats->p99 - stats->min + 1;
+    stats->bucket_width = (span + CONFIG_LATENCY_BENCH_BUCKETS - 1) / CONFIG_LATENCY_BENCH_BUCKETS;
+    memset(stats->buckets, 0, sizeof(stats->buckets));
+    stats->above_p99 = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (samples[i] > stats->p99)
+        {
+            ++stats->above_p99;
+            continue;
+        }
+        ++stats->buckets[(samples[i] - stats->min) / stats->bucket_width];
+    }
+}
+
+// -----------------------------------------------------------------------------
+// warmup untimed calls, then iterations timed ones, each after
+// latency_bench_evict if cold
+static int run(
+    latency_bench_mode_t mode,
+    uint32_t warmup,
+    uint32_t iterations,
+    int cold,
+    latency_bench_fn fn,
+    void *arg,
+    latency_bench_stats_t *stats)
+{
+    uint32_t *samples = malloc(iterations * sizeof(uint32_t));
+    if (samples == NULL)
+    {
+        return -1;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->mode = mode;
+    stats->cold = cold;
+    stats->cpu_mhz = esp_rom_get_cpu_ticks_per_us();
+
+    uint32_t cycles;
+    for (uint32_t i = 0; i < warmup; ++i)
+    {
+        sample(mode, fn, arg, &cycles);
+    }
+
+    latency_bench_clock_t clock = {0, 0};
+    uint64_t start = latency_bench_cycles(&clock);
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        if (cold && latency_bench_evict() != 0)
+        {
+            free(samples);
+            return -1;
+        }
+        if (sample(mode, fn, arg, &cycles))
+        {
+            samples[stats->count++] = cycles;
+        }
+        else
+        {
+            ++stats->migrated;
+        }
+        latency_bench_cycles(&clock);
+    }
+    stats->total = latency_bench_cycles(&clock) - start;
+
+    if (stats->count == 0)
+    {
+        free(samples);
+        return -1;
+    }
+    compute_stats(samples, stats);
+
+    free(samples);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+int latency_bench_run(latency_bench_mode_t mode, latency_bench_fn fn, void *arg, latency_bench_stats_t *stats)
+{
+    return run(mode, CONFIG_LATENCY_BENCH_WARMUP, CONFIG_LATENCY_BENCH_ITERATIONS, 0, fn, arg, stats);
+}
+
+#if CONFIG_LATENCY_BENCH_COLD
+// -----------------------------------------------------------------------------
+// the eviction partition, mapped on first use and kept mapped
+static const uint8_t *g_evict_data = NULL;
+static uint32_t g_evict_size = 0;
+
+// -----------------------------------------------------------------------------
+int latency_bench_evict(void)
+{
+    if (g_evict_data == NULL)
+    {
+        const esp_partition_t *partition = esp_partition_find_first(
+            ESP_PARTITION_TYPE_DATA,
+            ESP_PARTITION_SUBTYPE_ANY,
+            CONFIG_LATENCY_BENCH_EVICT_PARTITION);
+        if (partition == NULL)
+        {
+            return -1;
+        }
+
+        const void *data;
+        esp_partition_mmap_handle_t handle;
+        if (esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &data, &handle) != ESP_OK)
+        {
+            return -1;
+        }
+        g_evict_data = (const uint8_t *)data;
+        g_evict_size = (uint32_t)partition->size;
+    }
+
+    // one read per cache line, through the flash cache
+    const volatile uint8_t *data = g_evict_data;
+    for (uint32_t i = 0; i < g_evict_size; i += EVICT_STRIDE)
+    {
+        (void)data[i];
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+int latency_bench_run_cold(latency_bench_mode_t mode, latency_bench_fn fn, void *arg, latency_bench_stats_t *stats)
+{
+    return run(mode, 0, CONFIG_LATENCY_BENCH_COLD_ITERATIONS, 1, fn, arg, stats);
+}
+#else
+// -----------------------------------------------------------------------------
+int latency_bench_evict(void)
+{
+    return -1;
+}
+
+// -----------------------------------------------------------------------------
+int latency_bench_run_cold(latency_bench_mode_t mode, latency_bench_fn fn, void *arg, latency_bench_stats_t *stats)
+{
+    (void)mode;
+    (void)fn;
+    (void)arg;
+    (void)stats;
+    return -1;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+void latency_bench_print(const char *tag, const char *name, const latency_bench_stats_t *stats)
+{
+    uint32_t mhz = (stats->cpu_mhz > 0) ? stats->cpu_mhz : 1;
+    uint32_t peak = stats->above_p99;
+    for (uint32_t b = 0; b < CONFIG_LATENCY_BENCH_BUCKETS; ++b)
+    {
+        peak = (stats->buckets[b] > peak) ? stats->buckets[b] : peak;
+    }
+
+    ESP_LOGI(tag, "%s, %s, %s cache: %" PRIu32 " samples (%" PRIu32 " migrated) in %" PRIu64 " ms",
+             name,
+             (stats->mode == LATENCY_BENCH_CRITICAL) ? "critical section" : "preemptible",
+             stats->cold ? "cold" : "warm",
+             stats->count,
+             stats->migrated,
+             stats->total / mhz / 1000);
+    ESP_LOGI(tag, "  cycles: min %" PRIu32 ", median %" PRIu32 ", p90 %" PRIu32 ", p99 %" PRIu32 ", max %" PRIu32 ", mean %" PRIu32,
+             stats->min, stats->median, stats->p90, stats->p99, stats->max, stats->mean);
+    ESP_LOGI(tag, "  us:     min %.1f, median %.1f, p90 %.1f, p99 %.1f, max %.1f, mean %.1f",
+             (double)stats->min / mhz, (double)stats->median / mhz, (double)stats->p90 / mhz,
+             (double)stats->p99 / mhz, (double)stats->max / mhz, (double)stats->mean / mhz);
+
+    char bar[HISTOGRAM_BAR + 1];
+    for (uint32_t b = 0; b <= CONFIG_LATENCY_BENCH_BUCKETS; ++b)
+    {
+        uint32_t count = (b < CONFIG_LATENCY_BENCH_BUCKETS) ? stats->buckets[b] : stats->above_p99;
+        uint32_t length = (uint32_t)((uint64_t)count * HISTOGRAM_BAR / peak);
+        memset(bar, '#', length);
+        bar[length] = '\0';
+        if (b < CONFIG_LATENCY_BENCH_BUCKETS)
+        {
+            ESP_LOGI(tag, "  %10" PRIu32 " | %-*s %" PRIu32, stats->min + b * stats->bucket_width, HISTOGRAM_BAR, bar, count);
+        }
+        else
+        {
+            ESP_LOGI(tag, "  %10s | %-*s %" PRIu32, "> p99", HISTOGRAM_BAR, bar, count);
+        }
+    }
+}
@@ -0,0 +1,260 @@
+#include "container.h"
+#include "mlp_config.h"
+#include "params.h"
+#include "plan.h"
+
+#include <stddef.h>
+
+_Static_assert(sizeof(mlp_container_header_t) == 48, "container header layout");
+_Static_assert(sizeof(mlp_tensor_desc_t) == 32, "tensor descriptor layout");
+
+// -----------------------------------------------------------------------------
+// the tensors mlp_model_load resolves, with the dtype and shape the engine was
+// built for; cols == 0 accepts any rank 1 size (the plan); tensors with other
+// ids are skipped, so writers can add some without a version bump
+typedef struct
+{
+    uint16_t id;
+    uint8_t dtype;
+    uint8_t required;
+    uint32_t rows;
+    uint32_t cols;
+} expected_tensor_t;
+
+static const expected_tensor_t k_expected[] = {
+    {MLP_TENSOR_HIDDEN_WEIGHTS, MLP_DTYPE_INT8, 1, HIDDEN_SIZE, INPUT_SIZE},
+    {MLP_TENSOR_HIDDEN_BIASES, MLP_DTYPE_INT32, 1, HIDDEN_SIZE, 1},
+    {MLP_TENSOR_HIDDEN_WEIGHT_ZPS, MLP_DTYPE_INT8, 0, HIDDEN_SIZE, 1},
+    {MLP_TENSOR_HIDDEN_FOLDED_BIASES, MLP_DTYPE_INT32, 1, HIDDEN_SIZE, 1},
+    {MLP_TENSOR_HIDDEN_MULTIPLIERS, MLP_DTYPE_UINT32, 1, HIDDEN_SIZE, 1},
+    {MLP_TENSOR_HIDDEN_SHIFTS, MLP_DTYPE_INT32, 1, HIDDEN_SIZE, 1},
+    {MLP_TENSOR_OUTPUT_WEIGHTS, MLP_DTYPE_INT8, 1, OUTPUT_SIZE, HIDDEN_SIZE},
+    {MLP_TENSOR_OUTPUT_BIASES, MLP_DTYPE_INT32, 0, OUTPUT_SIZE, 1},
+    {MLP_TENSOR_OUTPUT_WEIGHT_ZPS, MLP_DTYPE_INT8, 0, OUTPUT_SIZE, 1},
+    {MLP_TENSOR_OUTPUT_FOLDED_BIASES, MLP_DTYPE_INT32, 1, OUTPUT_SIZE, 1},
+    {MLP_TENSOR_OUTPUT_MULTIPLIERS, MLP_DTYPE_UINT32, 1, OUTPUT_SIZE, 1},
+    {MLP_TENSOR_OUTPUT_SHIFTS, MLP_DTYPE_INT32, 1, OUTPUT_SIZE, 1},
+    {MLP_TENSOR_SOFTMAX_PARAMS, MLP_DTYPE_INT32, 1, sizeof(softmax_params_t) / sizeof(int32_t), 1},
+    {MLP_TENSOR_PLAN, MLP_DTYPE_UINT8, CONFIG_MLP_PLAN_EXECUTOR, 0, 0},
+    {MLP_TENSOR_HIDDEN_ACTIVATION, MLP_DTYPE_INT8, 0, 0, 0},
+};
+
+#define NUM_EXPECTED (sizeof(k_expected) / sizeof(k_expected[0]))
+
+// -----------------------------------------------------------------------------
+uint32_t mlp_container_crc32(uint32_t crc, const uint8_t *data, uint32_t size)
+{
+    // reflected 0xedb88320, a nibble at a time
+    static const uint32_t table[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+        0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+        0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+    };
+
+    crc = ~crc;
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ table[crc & 0x0f];
+        crc = (crc >> 4) ^ table[crc & 0x0f];
+    }
+    return ~crc;
+}
+
+// -----------------------------------------------------------------------------
+static inline const mlp_tensor_desc_t *tensor_table(const uint8_t *container)
+{
+    return (const mlp_tensor_desc_t *)&container[sizeof(mlp_container_header_t)];
+}
+
+// -----------------------------------------------------------------------------
+const mlp_tensor_desc_t *mlp_container_tensor(const uint8_t *container, uint32_t id)
+{
+    const mlp_container_header_t *header = (const mlp_container_header_t *)container;
+    const mlp_tensor_desc_t *tensors = tensor_table(container);
+
+    for (uint32_t t = 0; t < header->tensor_count; ++t)
+    {
+        if (tensors[t].id == id)
+        {
+            return &tensors[t];
+        }
+    }
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+static uint32_t dtype_size(uint8_t dtype)
+{
+    switch (dtype)
+    {
+    case MLP_DTYPE_UINT8:
+    case MLP_DTYPE_INT8:
+        return 1;
+    case MLP_DTYPE_INT32:
+    case MLP_DTYPE_UINT32:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+// -----------------------------------------------------------------------------
+static const expected_tensor_t *expected_tensor(uint32_t id)
+{
+    for (uint32_t e = 0; e < NUM_EXPECTED; ++e)
+    {
+        if (k_expected[e].id == id)
+        {
+            return &k_expected[e];
+        }
+    }
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+// a tensor of the data section checked against what the engine expects
+static int tensor_valid(const mlp_tensor_desc_t *tensor, const expected_tensor_t *expected, uint32_t data_size)
+{
+    uint32_t element_size = dtype_size(tensor->dtype);
+    uint32_t cols = (tensor->rank == 2) ? tensor->shape[1] : 1;
+
+    if (element_size == 0 || tensor->dtype != expected->dtype ||
+        (tensor->rank != 1 && tensor->rank != 2) || (tensor->rank == 1 && tensor->shape[1] != 1) ||
+        (tensor->offset % MLP_CONTAINER_ALIGN) != 0 ||
+        tensor->offset > data_size || tensor->size > data_size - tensor->offset ||
+        (uint64_t)tensor->shape[0] * cols * element_size != tensor->size)
+    {
+        return 0;
+    }
+    if (expected->cols == 0)
+    {
+        return tensor->rank == 1;
+    }
+    return tensor->shape[0] == expected->rows && cols == expected->cols && tensor->rank == ((expected->cols == 1) ? 1 : 2);
+}
+
+// -----------------------------------------------------------------------------
+int mlp_container_check(const mlp_container_header_t *header, const mlp_tensor_desc_t *tensors, uint32_t size)
+{
+    // 1) header
+    if (header->magic != MLP_CONTAINER_MAGIC || header->version != MLP_CONTAINER_VERSION ||
+        header->header_size != sizeof(mlp_container_header_t) + header->tensor_count * sizeof(mlp_tensor_desc_t) ||
+        header->header_size > header->data_offset || (header->data_offset % MLP_CONTAINER_ALIGN) != 0 ||
+        header->data_offset > size || header->data_size > size - header->data_offset ||
+        header->input_size != INPUT_SIZE || header->hidden_size != HIDDEN_SIZE || header->output_size != OUTPUT_SIZE)
+    {
+        return -1;
+    }
+
+    // 2) tensor table: known tensors once each, in range and of the expected
+    // dtype/shape, required ones present
+    uint32_t seen = 0;
+    for (uint32_t t = 0; t < header->tensor_count; ++t)
+    {
+        const expected_tensor_t *expected = expected_tensor(tensors[t].id);
+        if (expected == NULL)
+        {
+            continue;
+        }
+        if ((seen & (1u << tensors[t].id)) != 0 || !tensor_valid(&tensors[t], expected, header->data_size))
+        {
+            return -1;
+        }
+        seen |= 1u << tensors[t].id;
+    }
+    for (uint32_t e = 0; e < NUM_EXPECTED; ++e)
+    {
+        if (k_expected[e].required && (seen & (1u << k_expected[e].id)) == 0)
+        {
+            return -1;
+        }
+    }
+
+    // without the plan the hidden layer is always dense+ReLU
+    if (!CONFIG_MLP_PLAN_EXECUTOR && (seen & (1u << MLP_TENSOR_HIDDEN_ACTIVATION)) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+#if !MLP_WEIGHTS_DERIVED
+// -----------------------------------------------------------------------------
+// weight zero-points, or NULL when they are missing or all zero (the kernels
+// skip the correction then)
+static const int8_t *weight_zps_or_null(const uint8_t *data, const mlp_tensor_desc_t *tensor)
+{
+    if (tensor == NULL)
+    {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < tensor->size; ++i)
+    {
+        if (data[tensor->offset + i] != 0)
+        {
+            return (const int8_t *)&data[tensor->offset];
+        }
+    }
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+int mlp_model_load(mlp_model_t *model, const uint8_t *container, uint32_t size)
+{
+    const mlp_container_header_t *header = (const mlp_container_header_t *)container;
+
+    if (((uintptr_t)container % MLP_CONTAINER_ALIGN) != 0 || size < sizeof(mlp_container_header_t) ||
+        mlp_container_check(header, tensor_table(container), size) != 0)
+    {
+        return -1;
+    }
+
+    // 3) contents
+    const uint8_t *data = &container[header->data_offset];
+    if (mlp_container_crc32(0, data, header->data_size) != header->data_crc32)
+    {
+        return -1;
+    }
+
+#define TENSOR(type, id) ((const type *)&data[mlp_container_tensor(container, id)->offset])
+    model->params = data;
+    model->hidden_weights = TENSOR(int8_t, MLP_TENSOR_HIDDEN_WEIGHTS);
+    model->hidden_weight_zps = weight_zps_or_null(data, mlp_container_tensor(container, MLP_TENSOR_HIDDEN_WEIGHT_ZPS));
+    model->hidden_biases = TENSOR(int32_t, MLP_TENSOR_HIDDEN_BIASES);
+    model->hidden_folded_biases = TENSOR(int32_t, MLP_TENSOR_HIDDEN_FOLDED_BIASES);
+    model->hidden_multipliers = TENSOR(uint32_t, MLP_TENSOR_HIDDEN_MULTIPLIERS);
+    model->hidden_shifts = TENSOR(int32_t, MLP_TENSOR_HIDDEN_SHIFTS);
+    model->output_weights = TENSOR(int8_t, MLP_TENSOR_OUTPUT_WEIGHTS);
+    model->output_weight_zps = weight_zps_or_null(data, mlp_container_tensor(container, MLP_TENSOR_OUTPUT_WEIGHT_ZPS));
+    model->output_folded_biases = TENSOR(int32_t, MLP_TENSOR_OUTPUT_FOLDED_BIASES);
+    model->output_multipliers = TENSOR(uint32_t, MLP_TENSOR_OUTPUT_MULTIPLIERS);
+    model->output_shifts = TENSOR(int32_t, MLP_TENSOR_OUTPUT_SHIFTS);
+    model->output_weight_sums = NULL;
+    model->output_weight_norms = NULL;
+    model->softmax = TENSOR(softmax_params_t, MLP_TENSOR_SOFTMAX_PARAMS);
+    model->input_zp = header->input_zp;
+    model->hidden_zp = header->hidden_zp;
+    model->output_zp = header->output_zp;
+    model->hidden_epilogue.min = header->hidden_zp;
+    model->hidden_epilogue.max = INT8_MAX;
+    model->hidden_epilogue.lut = NULL;
+#undef TENSOR
+
+#if CONFIG_MLP_PLAN_EXECUTOR
+    // the top-k, batched and delta passes run the built-in sequence over
+    // INPUT_SIZE/OUTPUT_SIZE buffers, whatever the plan says
+    model->plan = mlp_plan_get(data, header->data_size, mlp_container_tensor(container, MLP_TENSOR_PLAN)->offset, PLAN_ARENA_SIZE);
+    if (model->plan == NULL || model->plan->input_size != INPUT_SIZE || model->plan->output_size != OUTPUT_SIZE)
+    {
+        return -1;
+    }
+    mlp_plan_epilogue(model->plan, data, 0, &model->hidden_epilogue);
+#else
+    model->plan = NULL;
+#endif
+
+    return 0;
+}
+#endif
@@ -0,0 +1,54 @@
+#include "container.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if !MLP_WEIGHTS_DERIVED
+// -----------------------------------------------------------------------------
+// host backend of mlp_model_map: a read-only private mapping of the file
+int mlp_model_map(const char *name, mlp_model_t *model, mlp_model_mapping_t *mapping)
+{
+    int fd = open(name, O_RDONLY);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || (uint64_t)st.st_size > UINT32_MAX)
+    {
+        close(fd);
+        return -1;
+    }
+
+    // the mapping outlives the descriptor
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return -1;
+    }
+
+    mapping->data = (const uint8_t *)data;
+    mapping->size = (uint32_t)st.st_size;
+    mapping->handle = (uintptr_t)st.st_size;
+
+    if (mlp_model_load(model, mapping->data, mapping->size) != 0)
+    {
+        mlp_model_unmap(mapping);
+        return -1;
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+void mlp_model_unmap(mlp_model_mapping_t *mapping)
+{
+    munmap((void *)mapping->data, (size_t)mapping->handle);
+    mapping->data = NULL;
+    mapping->size = 0;
+}
+#endif
@@ -0,0 +1,46 @@
+#include "container.h"
+
+#include "esp_partition.h"
+
+#include <stddef.h>
+
+#if !MLP_WEIGHTS_DERIVED
+// -----------------------------------------------------------------------------
+// device backend of mlp_model_map: the whole data partition mapped through the
+// flash MMU (reads go through the flash cache, as for g_params); the container
+// is usually smaller than the partition, the header says how much of it is used
+int mlp_model_map(const char *name, mlp_model_t *model, mlp_model_mapping_t *mapping)
+{
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, name);
+    if (partition == NULL)
+    {
+        return -1;
+    }
+
+    const void *data;
+    esp_partition_mmap_handle_t handle;
+    if (esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &data, &handle) != ESP_OK)
+    {
+        return -1;
+    }
+
+    mapping->data = (const uint8_t *)data;
+    mapping->size = (uint32_t)partition->size;
+    mapping->handle = (uintptr_t)handle;
+
+    if (mlp_model_load(model, mapping->data, mapping->size) != 0)
+    {
+        mlp_model_unmap(mapping);
+        return -1;
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+void mlp_model_unmap(mlp_model_mapping_t *mapping)
+{
+    esp_partition_munmap((esp_partition_mmap_handle_t)mapping->handle);
+    mapping->data = NULL;
+    mapping->size = 0;
+}
+#endif
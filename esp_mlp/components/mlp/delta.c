@@ -0,0 +1,141 @@
+#include "delta.h"
+#include "dense.h"
+#include "mlp_config.h"
+#include "profile.h"
+#include "softmax.h"
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+void mlp_delta_init(mlp_delta_t *delta, const mlp_model_t *model)
+{
+    delta->model = model;
+    delta->full_threshold = CONFIG_MLP_DELTA_FULL_THRESHOLD * INPUT_SIZE / 100;
+    delta->valid = 0;
+}
+
+// -----------------------------------------------------------------------------
+void mlp_delta_reset(mlp_delta_t *delta)
+{
+    delta->valid = 0;
+}
+
+// -----------------------------------------------------------------------------
+// gather (index, new - old) for every pixel that changed and store the new
+// frame; returns the number of changed pixels
+static uint32_t gather_changes(mlp_delta_t *delta, const int8_t *inputs, uint16_t *indices, int16_t *deltas)
+{
+    uint32_t count = 0;
+    for (uint32_t ic = 0; ic < INPUT_SIZE; ++ic)
+    {
+        int16_t d = (int16_t)((int32_t)inputs[ic] - (int32_t)delta->inputs[ic]);
+        if (d != 0)
+        {
+            indices[count] = (uint16_t)ic;
+            deltas[count] = d;
+            delta->inputs[ic] = inputs[ic];
+            ++count;
+        }
+    }
+    return count;
+}
+
+// -----------------------------------------------------------------------------
+// forward pass:
+//   1) hidden accumulators: delta MACs over the changed pixels, or in full
+//   2) requantization + hidden activation, one pass
+//   3) dense for the logits
+//   4) softmax
+uint32_t mlp_delta_forward(mlp_delta_t *delta, const int8_t *inputs, int8_t *outputs)
+{
+    uint16_t indices[INPUT_SIZE];
+    int16_t deltas[INPUT_SIZE];
+    int8_t hiddens[HIDDEN_SIZE] __attribute__((aligned(16)));
+    const mlp_model_t *model = delta->model;
+    uint32_t count = INPUT_SIZE;
+
+    MLP_PROFILE_BEGIN(MLP_SCOPE_FORWARD);
+
+    // 1) hidden accumulators
+    MLP_PROFILE_BEGIN(MLP_SCOPE_DENSE1);
+    if (delta->valid)
+    {
+        count = gather_changes(delta, inputs, indices, deltas);
+    }
+    if (!delta->valid || count > delta->full_threshold)
+    {
+        memcpy(delta->inputs, inputs, INPUT_SIZE);
+        dense_int8_accumulate(
+            inputs,
+            model->hidden_weights,
+            model->hidden_weight_zps,
+            model->hidden_folded_biases,
+            delta->accumulators,
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        delta->valid = 1;
+    }
+    else
+    {
+        dense_int8_accumulate_delta(
+            indices,
+            deltas,
+            count,
+            model->hidden_weights,
+            model->hidden_weight_zps,
+            delta->accumulators,
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+    }
+    MLP_PROFILE_END(MLP_SCOPE_DENSE1);
+
+    // 2) requantization + hidden activation, one pass
+    MLP_PROFILE_BEGIN(MLP_SCOPE_REQUANT);
+    dense_requantize_int8_fused(
+        delta->accumulators,
+        hiddens,
+        model->hidden_zp,
+        model->hidden_multipliers,
+        model->hidden_shifts,
+        &model->hidden_epilogue,
+        HIDDEN_SIZE);
+    MLP_PROFILE_END(MLP_SCOPE_REQUANT);
+
+    // 3) dense (no activation) for final logits
+    MLP_PROFILE_BEGIN(MLP_SCOPE_DENSE2);
+#if DENSE_SIMD_PIE
+    dense_int8_simd(
+        hiddens,
+        model->output_weights,
+        model->output_weight_zps,
+        model->output_folded_biases,
+        outputs,
+        model->output_zp,
+        model->output_multipliers,
+        model->output_shifts,
+        HIDDEN_SIZE,
+        OUTPUT_SIZE);
+#else
+    dense_int8_folded(
+        hiddens,
+        model->output_weights,
+        model->output_weight_zps,
+        model->output_folded_biases,
+        outputs,
+        model->output_zp,
+        model->output_multipliers,
+        model->output_shifts,
+        HIDDEN_SIZE,
+        OUTPUT_SIZE);
+#endif
+    MLP_PROFILE_END(MLP_SCOPE_DENSE2);
+
+    // 4) in-place quantized softmax
+    MLP_PROFILE_BEGIN(MLP_SCOPE_SOFTMAX);
+    softmax_int8(outputs, outputs, OUTPUT_SIZE, model->softmax);
+    MLP_PROFILE_END(MLP_SCOPE_SOFTMAX);
+
+    MLP_PROFILE_END(MLP_SCOPE_FORWARD);
+
+    return count;
+}
@@ -0,0 +1,1034 @@
+#include "dense.h"
+#include "epilogue.h"
+#include "quant.h"
+
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+// dense (int8), the clamp [min, max] fused into the output pass (see
+// epilogue_int8)
+static inline void dense_int8_clamped(
+    const int8_t *inputs,
+    int8_t input_zp,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    int8_t min,
+    int8_t max,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        // accumulate in 32-bit
+        int32_t acc = 0;
+
+        // weighted sum
+        for (uint32_t ic = 0, wc = oc * input_size; ic < input_size; ++ic, ++wc)
+        {
+            int32_t x = (int32_t)inputs[ic] - (int32_t)input_zp;
+            int32_t w = (int32_t)weights[wc] - (int32_t)weight_zps[oc];
+            acc += x * w;
+        }
+
+        acc += biases[oc];
+
+        outputs[oc] = epilogue_int8(acc, multipliers[oc], shifts[oc], output_zp, min, max, NULL);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8)
+void dense_int8(
+    const int8_t *inputs,
+    int8_t input_zp,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_clamped(
+        inputs,
+        input_zp,
+        weights,
+        weight_zps,
+        biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        INT8_MIN,
+        INT8_MAX,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// dense + ReLU (int8): ReLU is the clamp at output_zp, no second pass
+void dense_relu_int8(
+    const int8_t *inputs,
+    int8_t input_zp,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_clamped(
+        inputs,
+        input_zp,
+        weights,
+        weight_zps,
+        biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        output_zp,
+        INT8_MAX,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// fold input/weight zero-points into the biases:
+//   sum((x - xz) * (w - wz)) + b
+//     = sum(x * w) - wz * sum(x) + (b - xz * sum(w) + K * xz * wz)
+void dense_fold_zero_points(
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t input_zp,
+    int32_t *folded_biases,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        int32_t weight_sum = 0;
+        for (uint32_t ic = 0, wc = oc * input_size; ic < input_size; ++ic, ++wc)
+        {
+            weight_sum += (int32_t)weights[wc];
+        }
+
+        folded_biases[oc] = biases[oc] -
+                            (int32_t)input_zp * weight_sum +
+                            (int32_t)input_size * (int32_t)input_zp * (int32_t)weight_zps[oc];
+    }
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) with zero-points folded into the biases and the epilogue
+// [min, max] + lut fused into the output pass
+//   weight_zps == NULL selects the symmetric-weights fast path
+static inline void dense_int8_folded_epilogue(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    int8_t min,
+    int8_t max,
+    const int8_t *lut,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    // sum(x) is only needed to correct for non-zero weight zero-points
+    int32_t input_sum = 0;
+    if (weight_zps != NULL)
+    {
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            input_sum += (int32_t)inputs[ic];
+        }
+    }
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        const int8_t *row = &weights[oc * input_size];
+
+        // pure int8 x int8 MAC
+        int32_t acc = 0;
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            acc += (int32_t)inputs[ic] * (int32_t)row[ic];
+        }
+
+        if (weight_zps != NULL)
+        {
+            acc -= (int32_t)weight_zps[oc] * input_sum;
+        }
+
+        acc += folded_biases[oc];
+
+        outputs[oc] = epilogue_int8(acc, multipliers[oc], shifts[oc], output_zp, min, max, lut);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) with zero-points folded into the biases
+void dense_int8_folded(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_folded_epilogue(
+        inputs,
+        weights,
+        weight_zps,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        INT8_MIN,
+        INT8_MAX,
+        NULL,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// dense + ReLU (int8) with zero-points folded into the biases
+void dense_relu_int8_folded(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_folded_epilogue(
+        inputs,
+        weights,
+        weight_zps,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        output_zp,
+        INT8_MAX,
+        NULL,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) with zero-points folded into the biases and a fused epilogue
+void dense_int8_fused(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_folded_epilogue(
+        inputs,
+        weights,
+        weight_zps,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        epilogue->min,
+        epilogue->max,
+        epilogue->lut,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// in-place ReLU (int8)
+void relu_int8_inplace(int8_t *data, int8_t zero_point, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        data[i] = relu_int8(data[i], zero_point);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// transpose row-major [output_size][input_size] weights to column-major
+// [input_size][output_size]
+void dense_transpose_weights(
+    const int8_t *weights,
+    int8_t *transposed,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            transposed[ic * output_size + oc] = weights[oc * input_size + ic];
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// compact list of the inputs that differ from the input zero-point
+//   indices: input positions
+//   values: x - input_zp
+//   returns the number of entries
+uint32_t dense_gather_nonzero(
+    const int8_t *inputs,
+    int8_t input_zp,
+    uint16_t *indices,
+    int16_t *values,
+    uint32_t input_size)
+{
+    uint32_t count = 0;
+    for (uint32_t ic = 0; ic < input_size; ++ic)
+    {
+        int16_t x = (int16_t)((int32_t)inputs[ic] - (int32_t)input_zp);
+        if (x != 0)
+        {
+            indices[count] = (uint16_t)ic;
+            values[count] = x;
+            ++count;
+        }
+    }
+    return count;
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over the gathered non-zero-point inputs, row-major weights,
+// the epilogue [min, max] + lut fused into the output pass
+static inline void dense_int8_sparse_epilogue(
+    const uint16_t *indices,
+    const int16_t *values,
+    uint32_t count,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    int8_t min,
+    int8_t max,
+    const int8_t *lut,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    // sum(x - input_zp) is only needed to correct for non-zero weight zero-points
+    int32_t value_sum = 0;
+    if (weight_zps != NULL)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            value_sum += (int32_t)values[i];
+        }
+    }
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        const int8_t *row = &weights[oc * input_size];
+
+        int32_t acc = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            acc += (int32_t)values[i] * (int32_t)row[indices[i]];
+        }
+
+        if (weight_zps != NULL)
+        {
+            acc -= (int32_t)weight_zps[oc] * value_sum;
+        }
+
+        acc += biases[oc];
+
+        outputs[oc] = epilogue_int8(acc, multipliers[oc], shifts[oc], output_zp, min, max, lut);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over the gathered non-zero-point inputs, row-major weights
+void dense_int8_sparse(
+    const uint16_t *indices,
+    const int16_t *values,
+    uint32_t count,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_sparse_epilogue(
+        indices,
+        values,
+        count,
+        weights,
+        weight_zps,
+        biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        INT8_MIN,
+        INT8_MAX,
+        NULL,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over the gathered non-zero-point inputs, row-major weights,
+// and a fused epilogue
+void dense_int8_sparse_fused(
+    const uint16_t *indices,
+    const int16_t *values,
+    uint32_t count,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_sparse_epilogue(
+        indices,
+        values,
+        count,
+        weights,
+        weight_zps,
+        biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        epilogue->min,
+        epilogue->max,
+        epilogue->lut,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over the gathered non-zero-point inputs, column-major weights:
+// only the columns of the gathered inputs are ever read; the epilogue
+// [min, max] + lut fused into the output pass
+static inline void dense_int8_sparse_colmajor_epilogue(
+    const uint16_t *indices,
+    const int16_t *values,
+    uint32_t count,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int32_t *accumulators,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    int8_t min,
+    int8_t max,
+    const int8_t *lut,
+    uint32_t output_size)
+{
+    int32_t value_sum = 0;
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        accumulators[oc] = 0;
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const int8_t *column = &weights[(uint32_t)indices[i] * output_size];
+        int32_t x = (int32_t)values[i];
+
+        for (uint32_t oc = 0; oc < output_size; ++oc)
+        {
+            accumulators[oc] += x * (int32_t)column[oc];
+        }
+
+        value_sum += x;
+    }
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        int32_t acc = accumulators[oc];
+
+        if (weight_zps != NULL)
+        {
+            acc -= (int32_t)weight_zps[oc] * value_sum;
+        }
+
+        acc += biases[oc];
+
+        outputs[oc] = epilogue_int8(acc, multipliers[oc], shifts[oc], output_zp, min, max, lut);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over the gathered non-zero-point inputs, column-major weights
+void dense_int8_sparse_colmajor(
+    const uint16_t *indices,
+    const int16_t *values,
+    uint32_t count,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int32_t *accumulators,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t output_size)
+{
+    dense_int8_sparse_colmajor_epilogue(
+        indices,
+        values,
+        count,
+        weights,
+        weight_zps,
+        biases,
+        accumulators,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        INT8_MIN,
+        INT8_MAX,
+        NULL,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over the gathered non-zero-point inputs, column-major weights,
+// and a fused epilogue
+void dense_int8_sparse_colmajor_fused(
+    const uint16_t *indices,
+    const int16_t *values,
+    uint32_t count,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int32_t *accumulators,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t output_size)
+{
+    dense_int8_sparse_colmajor_epilogue(
+        indices,
+        values,
+        count,
+        weights,
+        weight_zps,
+        biases,
+        accumulators,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        epilogue->min,
+        epilogue->max,
+        epilogue->lut,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// dense_int8_folded up to the requantization: the int32 pre-activations, kept
+// by callers that update them incrementally (dense_int8_accumulate_delta)
+void dense_int8_accumulate(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int32_t *accumulators,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    int32_t input_sum = 0;
+    if (weight_zps != NULL)
+    {
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            input_sum += (int32_t)inputs[ic];
+        }
+    }
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        const int8_t *row = &weights[oc * input_size];
+
+        int32_t acc = 0;
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            acc += (int32_t)inputs[ic] * (int32_t)row[ic];
+        }
+
+        if (weight_zps != NULL)
+        {
+            acc -= (int32_t)weight_zps[oc] * input_sum;
+        }
+
+        accumulators[oc] = acc + folded_biases[oc];
+    }
+}
+
+// -----------------------------------------------------------------------------
+// the accumulators are linear in the inputs, so a change of d in input ic
+// moves output oc by d * (w[oc][ic] - weight_zp[oc]); exact, no drift
+void dense_int8_accumulate_delta(
+    const uint16_t *indices,
+    const int16_t *deltas,
+    uint32_t count,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    int32_t *accumulators,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    int32_t delta_sum = 0;
+    if (weight_zps != NULL)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            delta_sum += (int32_t)deltas[i];
+        }
+    }
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        const int8_t *row = &weights[oc * input_size];
+
+        int32_t acc = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            acc += (int32_t)deltas[i] * (int32_t)row[indices[i]];
+        }
+
+        if (weight_zps != NULL)
+        {
+            acc -= (int32_t)weight_zps[oc] * delta_sum;
+        }
+
+        accumulators[oc] += acc;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// requantize int32 accumulators to int8, the epilogue [min, max] + lut fused
+// into the same pass
+static inline void dense_requantize_int8_epilogue(
+    const int32_t *accumulators,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    int8_t min,
+    int8_t max,
+    const int8_t *lut,
+    uint32_t size)
+{
+    for (uint32_t oc = 0; oc < size; ++oc)
+    {
+        outputs[oc] = epilogue_int8(accumulators[oc], multipliers[oc], shifts[oc], output_zp, min, max, lut);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// requantize int32 accumulators to int8
+void dense_requantize_int8(
+    const int32_t *accumulators,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t size)
+{
+    dense_requantize_int8_epilogue(
+        accumulators,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        INT8_MIN,
+        INT8_MAX,
+        NULL,
+        size);
+}
+
+// -----------------------------------------------------------------------------
+// requantize int32 accumulators to int8 with a fused epilogue
+void dense_requantize_int8_fused(
+    const int32_t *accumulators,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t size)
+{
+    dense_requantize_int8_epilogue(
+        accumulators,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        epilogue->min,
+        epilogue->max,
+        epilogue->lut,
+        size);
+}
+
+// -----------------------------------------------------------------------------
+// batched dense (int8) over folded biases:
+//   inputs: [batch][input_size]
+//   outputs: [batch][output_size]
+// every weight loaded is reused across DENSE_BATCH_BLOCK inputs held in
+// registers, so the weight matrix is streamed once per batch; the epilogue
+// [min, max] + lut fused into the output pass
+static inline void dense_int8_batch_epilogue(
+    const int8_t *inputs,
+    uint32_t batch,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    int8_t min,
+    int8_t max,
+    const int8_t *lut,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        const int8_t *row = &weights[oc * input_size];
+        int32_t weight_zp = (weight_zps != NULL) ? (int32_t)weight_zps[oc] : 0;
+        uint32_t b = 0;
+
+        for (; b + DENSE_BATCH_BLOCK <= batch; b += DENSE_BATCH_BLOCK)
+        {
+            const int8_t *x0 = &inputs[(b + 0) * input_size];
+            const int8_t *x1 = &inputs[(b + 1) * input_size];
+            const int8_t *x2 = &inputs[(b + 2) * input_size];
+            const int8_t *x3 = &inputs[(b + 3) * input_size];
+
+            int32_t acc0 = 0;
+            int32_t acc1 = 0;
+            int32_t acc2 = 0;
+            int32_t acc3 = 0;
+            int32_t sum0 = 0;
+            int32_t sum1 = 0;
+            int32_t sum2 = 0;
+            int32_t sum3 = 0;
+
+            for (uint32_t ic = 0; ic < input_size; ++ic)
+            {
+                int32_t w = (int32_t)row[ic];
+                acc0 += (int32_t)x0[ic] * w;
+                acc1 += (int32_t)x1[ic] * w;
+                acc2 += (int32_t)x2[ic] * w;
+                acc3 += (int32_t)x3[ic] * w;
+            }
+
+            if (weight_zp != 0)
+            {
+                for (uint32_t ic = 0; ic < input_size; ++ic)
+                {
+                    sum0 += (int32_t)x0[ic];
+                    sum1 += (int32_t)x1[ic];
+                    sum2 += (int32_t)x2[ic];
+                    sum3 += (int32_t)x3[ic];
+                }
+            }
+
+            outputs[(b + 0) * output_size + oc] = epilogue_int8(acc0 - weight_zp * sum0 + folded_biases[oc], multipliers[oc], shifts[oc], output_zp, min, max, lut);
+            outputs[(b + 1) * output_size + oc] = epilogue_int8(acc1 - weight_zp * sum1 + folded_biases[oc], multipliers[oc], shifts[oc], output_zp, min, max, lut);
+            outputs[(b + 2) * output_size + oc] = epilogue_int8(acc2 - weight_zp * sum2 + folded_biases[oc], multipliers[oc], shifts[oc], output_zp, min, max, lut);
+            outputs[(b + 3) * output_size + oc] = epilogue_int8(acc3 - weight_zp * sum3 + folded_biases[oc], multipliers[oc], shifts[oc], output_zp, min, max, lut);
+        }
+
+        // remainder of the batch, one input at a time
+        for (; b < batch; ++b)
+        {
+            const int8_t *x = &inputs[b * input_size];
+
+            int32_t acc = 0;
+            int32_t sum = 0;
+            for (uint32_t ic = 0; ic < input_size; ++ic)
+            {
+                acc += (int32_t)x[ic] * (int32_t)row[ic];
+            }
+
+            if (weight_zp != 0)
+            {
+                for (uint32_t ic = 0; ic < input_size; ++ic)
+                {
+                    sum += (int32_t)x[ic];
+                }
+            }
+
+            outputs[b * output_size + oc] = epilogue_int8(acc - weight_zp * sum + folded_biases[oc], multipliers[oc], shifts[oc], output_zp, min, max, lut);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// batched dense (int8) over folded biases
+void dense_int8_batch(
+    const int8_t *inputs,
+    uint32_t batch,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_batch_epilogue(
+        inputs,
+        batch,
+        weights,
+        weight_zps,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        INT8_MIN,
+        INT8_MAX,
+        NULL,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// batched dense (int8) over folded biases with a fused epilogue
+void dense_int8_batch_fused(
+    const int8_t *inputs,
+    uint32_t batch,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_batch_epilogue(
+        inputs,
+        batch,
+        weights,
+        weight_zps,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        epilogue->min,
+        epilogue->max,
+        epilogue->lut,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// repack row-major [output_size][input_size] weights into blocks of
+// DENSE_PACK_BLOCK output channels interleaved per input:
+//   packed[block][ic][0..DENSE_PACK_BLOCK)
+// the last block is zero-padded
+void dense_pack_weights(
+    const int8_t *weights,
+    int8_t *packed,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    uint32_t blocks = DENSE_PACKED_BLOCKS(output_size);
+
+    for (uint32_t block = 0; block < blocks; ++block)
+    {
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            for (uint32_t lane = 0; lane < DENSE_PACK_BLOCK; ++lane)
+            {
+                uint32_t oc = block * DENSE_PACK_BLOCK + lane;
+                *packed++ = (oc < output_size) ? weights[oc * input_size + ic] : 0;
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over packed weights and folded biases: DENSE_PACK_BLOCK
+// accumulators live at once, each input loaded once per block; the epilogue
+// [min, max] + lut fused into the output pass
+_Static_assert(DENSE_PACK_BLOCK == 4, "dense_int8_packed is unrolled for 4 lanes");
+
+static inline void dense_int8_packed_epilogue(
+    const int8_t *inputs,
+    const int8_t *packed_weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    int8_t min,
+    int8_t max,
+    const int8_t *lut,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    int32_t input_sum = 0;
+    if (weight_zps != NULL)
+    {
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            input_sum += (int32_t)inputs[ic];
+        }
+    }
+
+    uint32_t blocks = DENSE_PACKED_BLOCKS(output_size);
+    const int8_t *w = packed_weights;
+
+    for (uint32_t block = 0; block < blocks; ++block)
+    {
+        int32_t accs[DENSE_PACK_BLOCK] = {0};
+
+        for (uint32_t ic = 0; ic < input_size; ++ic, w += DENSE_PACK_BLOCK)
+        {
+            int32_t x = (int32_t)inputs[ic];
+            accs[0] += x * (int32_t)w[0];
+            accs[1] += x * (int32_t)w[1];
+            accs[2] += x * (int32_t)w[2];
+            accs[3] += x * (int32_t)w[3];
+        }
+
+        for (uint32_t lane = 0; lane < DENSE_PACK_BLOCK; ++lane)
+        {
+            uint32_t oc = block * DENSE_PACK_BLOCK + lane;
+            if (oc >= output_size)
+            {
+                break;
+            }
+
+            int32_t acc = accs[lane];
+
+            if (weight_zps != NULL)
+            {
+                acc -= (int32_t)weight_zps[oc] * input_sum;
+            }
+
+            outputs[oc] = epilogue_int8(acc + folded_biases[oc], multipliers[oc], shifts[oc], output_zp, min, max, lut);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over packed weights and folded biases
+void dense_int8_packed(
+    const int8_t *inputs,
+    const int8_t *packed_weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_packed_epilogue(
+        inputs,
+        packed_weights,
+        weight_zps,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        INT8_MIN,
+        INT8_MAX,
+        NULL,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over packed weights and folded biases with a fused epilogue
+void dense_int8_packed_fused(
+    const int8_t *inputs,
+    const int8_t *packed_weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_packed_epilogue(
+        inputs,
+        packed_weights,
+        weight_zps,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        epilogue->min,
+        epilogue->max,
+        epilogue->lut,
+        input_size,
+        output_size);
+}
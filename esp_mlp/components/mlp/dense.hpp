@@ -0,0 +1,204 @@
+#ifndef DENSE_HPP_
+#define DENSE_HPP_
+
+#include "quant.h"
+
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// dense (int8) layers specialized at compile time: the shape, the activation
+// and the requantization are template parameters, so the compiler sees
+// constant trip counts (no tails to test at runtime, small layers unroll
+// fully, the MACs vectorize wherever the target has int8 vectors) and inlines
+// the whole epilogue (bias, requantization, zero-point, activation,
+// saturation) into the layer:
+//
+//   mlp::Dense<INPUT_SIZE, HIDDEN_SIZE, mlp::Relu>::run(...)
+//
+// activations with runtime parameters (Relu6, Lut) are passed to run() as the
+// last argument; the stateless ones default-construct
+//
+// same semantics as dense_int8_folded: symmetric weights when weight_zps is
+// NULL, zero-points folded into the biases (dense_fold_zero_points)
+
+namespace mlp
+{
+
+// -----------------------------------------------------------------------------
+// activations, on the requantized value with the output zero-point added
+struct Linear
+{
+    static inline int32_t apply(int32_t x, int32_t zero_point)
+    {
+        (void)zero_point;
+        return x;
+    }
+};
+
+struct Relu
+{
+    static inline int32_t apply(int32_t x, int32_t zero_point)
+    {
+        return (x < zero_point) ? zero_point : x;
+    }
+};
+
+// ReLU6: max is the quantized 6 (dense_relu6_max)
+struct Relu6
+{
+    int32_t max;
+
+    inline int32_t apply(int32_t x, int32_t zero_point) const
+    {
+        x = (x < zero_point) ? zero_point : x;
+        return (x > max) ? max : x;
+    }
+};
+
+// lookup table activation (sigmoid, tanh): DENSE_LUT_SIZE entries indexed by
+// the saturated output (dense_activation_lut)
+struct Lut
+{
+    const int8_t *table;
+
+    inline int32_t apply(int32_t x, int32_t zero_point) const
+    {
+        (void)zero_point;
+        return table[saturate_to_int8(x) - INT8_MIN];
+    }
+};
+
+// -----------------------------------------------------------------------------
+// requantization backends (see quant.h); RequantConfig follows
+// CONFIG_MLP_REQUANT_*
+struct RequantConfig
+{
+    static inline int32_t apply(int32_t acc, uint32_t multiplier, int32_t shift)
+    {
+        return multiply_by_quantized_multiplier(acc, multiplier, shift);
+    }
+};
+
+struct RequantExact64
+{
+    static inline int32_t apply(int32_t acc, uint32_t multiplier, int32_t shift)
+    {
+        return requant_exact64(acc, multiplier, shift);
+    }
+};
+
+struct RequantApprox32
+{
+    static inline int32_t apply(int32_t acc, uint32_t multiplier, int32_t shift)
+    {
+        return requant_approx32(acc, multiplier, shift);
+    }
+};
+
+struct RequantPot
+{
+    static inline int32_t apply(int32_t acc, uint32_t multiplier, int32_t shift)
+    {
+        return requant_pot(acc, multiplier, shift);
+    }
+};
+
+struct RequantFloat
+{
+    static inline int32_t apply(int32_t acc, uint32_t multiplier, int32_t shift)
+    {
+        return requant_float(acc, multiplier, shift);
+    }
+};
+
+// -----------------------------------------------------------------------------
+template <uint32_t In, uint32_t Out, typename Activation = Linear, typename Requant = RequantConfig>
+struct Dense
+{
+    static_assert(In > 0 && Out > 0, "empty layer");
+    static_assert((uint64_t)In * 127 * 128 <= INT32_MAX, "accumulator may overflow");
+
+    static constexpr uint32_t input_size = In;
+    static constexpr uint32_t output_size = Out;
+
+    // output rows per pass over the inputs: every input load feeds Rows
+    // accumulators
+    static constexpr uint32_t Rows = (Out >= 4) ? 4 : Out;
+
+    static void run(
+        const int8_t *__restrict inputs,
+        const int8_t *__restrict weights,
+        const int8_t *__restrict weight_zps,
+        const int32_t *__restrict folded_biases,
+        int8_t *__restrict outputs,
+        int8_t output_zp,
+        const uint32_t *__restrict multipliers,
+        const int32_t *__restrict shifts,
+        const Activation &activation = Activation())
+    {
+        // sum(x) is only needed to correct for non-zero weight zero-points
+        int32_t input_sum = 0;
+        if (weight_zps != nullptr)
+        {
+            for (uint32_t ic = 0; ic < In; ++ic)
+            {
+                input_sum += (int32_t)inputs[ic];
+            }
+        }
+
+        for (uint32_t oc = 0; oc + Rows <= Out; oc += Rows)
+        {
+            rows<Rows>(oc, inputs, weights, weight_zps, input_sum, folded_biases, outputs, output_zp, multipliers, shifts, activation);
+        }
+        if constexpr (Out % Rows != 0)
+        {
+            rows<Out % Rows>(Out - Out % Rows, inputs, weights, weight_zps, input_sum, folded_biases, outputs, output_zp, multipliers, shifts, activation);
+        }
+    }
+
+private:
+    // -------------------------------------------------------------------------
+    template <uint32_t R>
+    static inline __attribute__((always_inline)) void rows(
+        uint32_t first,
+        const int8_t *__restrict inputs,
+        const int8_t *__restrict weights,
+        const int8_t *__restrict weight_zps,
+        int32_t input_sum,
+        const int32_t *__restrict folded_biases,
+        int8_t *__restrict outputs,
+        int8_t output_zp,
+        const uint32_t *__restrict multipliers,
+        const int32_t *__restrict shifts,
+        const Activation &activation)
+    {
+        // pure int8 x int8 MACs, constant trip counts
+        const int8_t *row = &weights[first * In];
+        int32_t acc[R] = {};
+        for (uint32_t ic = 0; ic < In; ++ic)
+        {
+            int32_t x = (int32_t)inputs[ic];
+            for (uint32_t r = 0; r < R; ++r)
+            {
+                acc[r] += x * (int32_t)row[r * In + ic];
+            }
+        }
+
+        // epilogue: bias, requantization, zero-point, activation, saturation
+        for (uint32_t r = 0; r < R; ++r)
+        {
+            uint32_t oc = first + r;
+            int32_t value = acc[r] + folded_biases[oc];
+            if (weight_zps != nullptr)
+            {
+                value -= (int32_t)weight_zps[oc] * input_sum;
+            }
+            value = Requant::apply(value, multipliers[oc], shifts[oc]) + (int32_t)output_zp;
+            outputs[oc] = saturate_to_int8(activation.apply(value, output_zp));
+        }
+    }
+};
+
+} // namespace mlp
+
+#endif
@@ -0,0 +1,270 @@
+#include "dense.h"
+#include "epilogue.h"
+#include "quant.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// block-sparse weights: each output row is split into 1xDENSE_SPARSE_BLOCK
+// blocks of consecutive inputs and only the blocks that survive pruning are
+// stored (CSR over blocks):
+//   row_ptr[oc]..row_ptr[oc + 1]   blocks of output channel oc
+//   block_cols[b]                  input block index (first input / DENSE_SPARSE_BLOCK)
+//   values[b * DENSE_SPARSE_BLOCK] weights of block b, zero-padded past input_size
+
+// -----------------------------------------------------------------------------
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// -----------------------------------------------------------------------------
+static uint32_t block_norm(const int8_t *row, uint32_t ic0, uint32_t input_size)
+{
+    uint32_t norm = 0;
+    for (uint32_t ic = ic0; ic < ic0 + DENSE_SPARSE_BLOCK && ic < input_size; ++ic)
+    {
+        norm += (uint32_t)abs((int32_t)row[ic]);
+    }
+    return norm;
+}
+
+// -----------------------------------------------------------------------------
+// magnitude pruning over the whole layer: drop the sparsity_pct percent of
+// blocks with the smallest L1 norm
+int dense_prune_blocks(
+    const int8_t *weights,
+    uint8_t *mask,
+    uint32_t sparsity_pct,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    uint32_t row_blocks = DENSE_SPARSE_ROW_BLOCKS(input_size);
+    uint32_t total = row_blocks * output_size;
+    uint32_t pruned = (uint32_t)(((uint64_t)total * sparsity_pct) / 100);
+
+    uint32_t *norms = malloc(2 * total * sizeof(uint32_t));
+    if (norms == NULL)
+    {
+        return -1;
+    }
+    uint32_t *sorted = &norms[total];
+
+    for (uint32_t oc = 0, b = 0; oc < output_size; ++oc)
+    {
+        for (uint32_t c = 0; c < row_blocks; ++c, ++b)
+        {
+            norms[b] = block_norm(&weights[oc * input_size], c * DENSE_SPARSE_BLOCK, input_size);
+        }
+    }
+
+    // blocks strictly below the threshold norm go first, ties in storage order
+    uint32_t threshold = 0;
+    uint32_t ties = 0;
+    if (pruned > 0)
+    {
+        memcpy(sorted, norms, total * sizeof(uint32_t));
+        qsort(sorted, total, sizeof(uint32_t), compare_u32);
+        threshold = sorted[pruned - 1];
+        for (uint32_t b = pruned; b > 0 && sorted[b - 1] == threshold; --b)
+        {
+            ++ties;
+        }
+    }
+
+    for (uint32_t b = 0; b < total; ++b)
+    {
+        int drop = 0;
+        if (pruned > 0 && norms[b] < threshold)
+        {
+            drop = 1;
+        }
+        else if (pruned > 0 && norms[b] == threshold && ties > 0)
+        {
+            drop = 1;
+            --ties;
+        }
+        mask[b] = drop ? 0 : 1;
+    }
+
+    free(norms);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// encode the blocks kept by mask (mask == NULL: every block with a non-zero
+// weight) and fold input_zp into the biases over the kept weights only
+uint32_t dense_encode_block_sparse(
+    const int8_t *weights,
+    const int32_t *biases,
+    int8_t input_zp,
+    const uint8_t *mask,
+    uint32_t *row_ptr,
+    uint16_t *block_cols,
+    int8_t *values,
+    int32_t *folded_biases,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    uint32_t row_blocks = DENSE_SPARSE_ROW_BLOCKS(input_size);
+    uint32_t count = 0;
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        const int8_t *row = &weights[oc * input_size];
+        int32_t weight_sum = 0;
+
+        row_ptr[oc] = count;
+        for (uint32_t c = 0; c < row_blocks; ++c)
+        {
+            uint32_t ic0 = c * DENSE_SPARSE_BLOCK;
+            int keep = (mask != NULL) ? mask[oc * row_blocks + c] != 0 : block_norm(row, ic0, input_size) != 0;
+            if (!keep)
+            {
+                continue;
+            }
+
+            int8_t *block = &values[count * DENSE_SPARSE_BLOCK];
+            memset(block, 0, DENSE_SPARSE_BLOCK);
+            for (uint32_t j = 0; j < DENSE_SPARSE_BLOCK && ic0 + j < input_size; ++j)
+            {
+                block[j] = row[ic0 + j];
+                weight_sum += (int32_t)row[ic0 + j];
+            }
+            block_cols[count++] = (uint16_t)c;
+        }
+
+        folded_biases[oc] = biases[oc] - (int32_t)input_zp * weight_sum;
+    }
+    row_ptr[output_size] = count;
+
+    return count;
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over block-sparse weights and folded biases: one unrolled
+// 8-wide MAC per stored block, pruned blocks cost nothing; the epilogue
+// [min, max] + lut fused into the output pass
+static inline void dense_int8_block_sparse_epilogue(
+    const int8_t *inputs,
+    const uint32_t *row_ptr,
+    const uint16_t *block_cols,
+    const int8_t *values,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    int8_t min,
+    int8_t max,
+    const int8_t *lut,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    _Static_assert(DENSE_SPARSE_BLOCK == 8, "dense_int8_block_sparse is unrolled for 1x8 blocks");
+
+    // blocks whose first input is below full_end lie entirely inside inputs
+    uint32_t full_end = (input_size / DENSE_SPARSE_BLOCK) * DENSE_SPARSE_BLOCK;
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        int32_t acc = folded_biases[oc];
+
+        for (uint32_t b = row_ptr[oc]; b < row_ptr[oc + 1]; ++b)
+        {
+            uint32_t ic0 = (uint32_t)block_cols[b] * DENSE_SPARSE_BLOCK;
+            const int8_t *x = &inputs[ic0];
+            const int8_t *w = &values[b * DENSE_SPARSE_BLOCK];
+
+            if (ic0 < full_end)
+            {
+                acc += (int32_t)x[0] * (int32_t)w[0];
+                acc += (int32_t)x[1] * (int32_t)w[1];
+                acc += (int32_t)x[2] * (int32_t)w[2];
+                acc += (int32_t)x[3] * (int32_t)w[3];
+                acc += (int32_t)x[4] * (int32_t)w[4];
+                acc += (int32_t)x[5] * (int32_t)w[5];
+                acc += (int32_t)x[6] * (int32_t)w[6];
+                acc += (int32_t)x[7] * (int32_t)w[7];
+            }
+            else
+            {
+                for (uint32_t j = 0; ic0 + j < input_size; ++j)
+                {
+                    acc += (int32_t)x[j] * (int32_t)w[j];
+                }
+            }
+        }
+
+        outputs[oc] = epilogue_int8(acc, multipliers[oc], shifts[oc], output_zp, min, max, lut);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over block-sparse weights and folded biases
+void dense_int8_block_sparse(
+    const int8_t *inputs,
+    const uint32_t *row_ptr,
+    const uint16_t *block_cols,
+    const int8_t *values,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_block_sparse_epilogue(
+        inputs,
+        row_ptr,
+        block_cols,
+        values,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        INT8_MIN,
+        INT8_MAX,
+        NULL,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over block-sparse weights and folded biases with a fused
+// epilogue
+void dense_int8_block_sparse_fused(
+    const int8_t *inputs,
+    const uint32_t *row_ptr,
+    const uint16_t *block_cols,
+    const int8_t *values,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_block_sparse_epilogue(
+        inputs,
+        row_ptr,
+        block_cols,
+        values,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        epilogue->min,
+        epilogue->max,
+        epilogue->lut,
+        input_size,
+        output_size);
+}
@@ -0,0 +1,334 @@
+#include "dense.h"
+#include "epilogue.h"
+#include "quant.h"
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// codebook (weight-clustered) layout: every output channel has centroid_count
+// int16 centroids (weight value minus weight zero-point) and one
+// DENSE_CODEBOOK_BITS-bit centroid index per input, packed LSB-first into a
+// bit stream with rows padded to whole bytes
+
+#define CODEBOOK_KMEANS_ITERATIONS 32
+
+// -----------------------------------------------------------------------------
+static void put_index(uint8_t *row, uint32_t ic, uint32_t bits, uint32_t index)
+{
+    uint32_t bit = ic * bits;
+    uint32_t value = index << (bit % 8);
+    row[bit / 8] |= (uint8_t)value;
+    if ((bit % 8) + bits > 8)
+    {
+        row[bit / 8 + 1] |= (uint8_t)(value >> 8);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// 1-D k-means over one channel's weight histogram, centroids kept integral so
+// the clustered weights stay on the int8 grid
+static void cluster_channel(const uint32_t *histogram, uint32_t total, int32_t *centroids, uint32_t centroid_count)
+{
+    // initial centroids at evenly spaced quantiles
+    for (uint32_t k = 0, seen = 0, v = 0; k < centroid_count; ++k)
+    {
+        uint32_t target = (uint32_t)(((uint64_t)(2 * k + 1) * total) / (2 * centroid_count));
+        while (v < 255 && seen + histogram[v] <= target)
+        {
+            seen += histogram[v++];
+        }
+        centroids[k] = (int32_t)v - 128;
+        // keep the centroids distinct where the weights pile up on one value
+        if (k > 0 && centroids[k] <= centroids[k - 1] && centroids[k - 1] < 127)
+        {
+            centroids[k] = centroids[k - 1] + 1;
+        }
+    }
+
+    for (uint32_t it = 0; it < CODEBOOK_KMEANS_ITERATIONS; ++it)
+    {
+        int64_t sums[DENSE_CODEBOOK_MAX_CENTROIDS] = {0};
+        uint32_t counts[DENSE_CODEBOOK_MAX_CENTROIDS] = {0};
+
+        for (uint32_t v = 0; v < 256; ++v)
+        {
+            if (histogram[v] == 0)
+            {
+                continue;
+            }
+            uint32_t best = 0;
+            int32_t best_dist = 1 << 30;
+            for (uint32_t k = 0; k < centroid_count; ++k)
+            {
+                int32_t dist = (int32_t)v - 128 - centroids[k];
+                dist = dist < 0 ? -dist : dist;
+                if (dist < best_dist)
+                {
+                    best_dist = dist;
+                    best = k;
+                }
+            }
+            sums[best] += (int64_t)histogram[v] * ((int32_t)v - 128);
+            counts[best] += histogram[v];
+        }
+
+        int changed = 0;
+        for (uint32_t k = 0; k < centroid_count; ++k)
+        {
+            if (counts[k] == 0)
+            {
+                continue;
+            }
+            // round half away from zero
+            int64_t twice = 2 * sums[k];
+            int32_t mean = (int32_t)((twice + (twice >= 0 ? (int64_t)counts[k] : -(int64_t)counts[k])) / (2 * (int64_t)counts[k]));
+            changed |= mean != centroids[k];
+            centroids[k] = mean;
+        }
+        if (!changed)
+        {
+            break;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// cluster each output channel's weights into centroid_count shared values
+// (offline); produces the packed indices, the centroids relative to the weight
+// zero-point and biases folded for input_zp over the clustered weights
+int dense_cluster_weights(
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t input_zp,
+    uint32_t centroid_count,
+    uint8_t *indices,
+    int16_t *centroids,
+    int32_t *folded_biases,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    if (centroid_count != 16 && centroid_count != 32)
+    {
+        return -1;
+    }
+
+    uint32_t bits = DENSE_CODEBOOK_BITS(centroid_count);
+    uint32_t row_bytes = DENSE_CODEBOOK_ROW_SIZE(input_size, centroid_count);
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        const int8_t *row = &weights[oc * input_size];
+        uint8_t *packed = &indices[oc * row_bytes];
+        int16_t *codebook = &centroids[oc * centroid_count];
+        uint32_t histogram[256] = {0};
+        int32_t values[DENSE_CODEBOOK_MAX_CENTROIDS];
+        uint8_t nearest[256];
+
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            ++histogram[(int32_t)row[ic] + 128];
+        }
+        cluster_channel(histogram, input_size, values, centroid_count);
+
+        for (uint32_t v = 0; v < 256; ++v)
+        {
+            uint32_t best = 0;
+            int32_t best_dist = 1 << 30;
+            for (uint32_t k = 0; k < centroid_count; ++k)
+            {
+                int32_t dist = (int32_t)v - 128 - values[k];
+                dist = dist < 0 ? -dist : dist;
+                if (dist < best_dist)
+                {
+                    best_dist = dist;
+                    best = k;
+                }
+            }
+            nearest[v] = (uint8_t)best;
+        }
+
+        int32_t weight_sum = 0;
+        memset(packed, 0, row_bytes);
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            uint32_t k = nearest[(int32_t)row[ic] + 128];
+            put_index(packed, ic, bits, k);
+            weight_sum += values[k] - (int32_t)weight_zps[oc];
+        }
+        for (uint32_t k = 0; k < centroid_count; ++k)
+        {
+            codebook[k] = (int16_t)(values[k] - (int32_t)weight_zps[oc]);
+        }
+
+        folded_biases[oc] = biases[oc] - (int32_t)input_zp * weight_sum;
+    }
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// per-centroid input sums for one row of 4-bit indices (two per byte)
+static inline void bin_inputs_4bit(const int8_t *inputs, const uint8_t *row, int32_t *bins, uint32_t input_size)
+{
+    uint32_t pairs = input_size / 2;
+    for (uint32_t i = 0; i < pairs; ++i)
+    {
+        uint8_t b = row[i];
+        bins[b & 0xf] += (int32_t)inputs[2 * i];
+        bins[b >> 4] += (int32_t)inputs[2 * i + 1];
+    }
+    if (input_size % 2)
+    {
+        bins[row[pairs] & 0xf] += (int32_t)inputs[input_size - 1];
+    }
+}
+
+// -----------------------------------------------------------------------------
+// per-centroid input sums for one row of 5-bit indices (eight per five bytes)
+static inline void bin_inputs_5bit(const int8_t *inputs, const uint8_t *row, int32_t *bins, uint32_t input_size)
+{
+    uint32_t groups = input_size / 8;
+    for (uint32_t g = 0; g < groups; ++g)
+    {
+        const uint8_t *p = &row[g * 5];
+        uint64_t v = (uint64_t)p[0] |
+                     ((uint64_t)p[1] << 8) |
+                     ((uint64_t)p[2] << 16) |
+                     ((uint64_t)p[3] << 24) |
+                     ((uint64_t)p[4] << 32);
+        const int8_t *x = &inputs[g * 8];
+        bins[(v >> 0) & 0x1f] += (int32_t)x[0];
+        bins[(v >> 5) & 0x1f] += (int32_t)x[1];
+        bins[(v >> 10) & 0x1f] += (int32_t)x[2];
+        bins[(v >> 15) & 0x1f] += (int32_t)x[3];
+        bins[(v >> 20) & 0x1f] += (int32_t)x[4];
+        bins[(v >> 25) & 0x1f] += (int32_t)x[5];
+        bins[(v >> 30) & 0x1f] += (int32_t)x[6];
+        bins[(v >> 35) & 0x1f] += (int32_t)x[7];
+    }
+    for (uint32_t ic = groups * 8; ic < input_size; ++ic)
+    {
+        uint32_t bit = ic * 5;
+        uint32_t v = row[bit / 8];
+        if ((bit % 8) + 5 > 8)
+        {
+            v |= (uint32_t)row[bit / 8 + 1] << 8;
+        }
+        bins[(v >> (bit % 8)) & 0x1f] += (int32_t)inputs[ic];
+    }
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over codebook weights and folded biases: per output channel,
+// sum the inputs into one bin per centroid, then one multiply per centroid
+//   acc = sum_k centroid[k] * sum_{ic: index[ic] == k} x[ic]
+// the epilogue [min, max] + lut fused into the output pass
+static inline void dense_int8_codebook_epilogue(
+    const int8_t *inputs,
+    const uint8_t *indices,
+    const int16_t *centroids,
+    uint32_t centroid_count,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    int8_t min,
+    int8_t max,
+    const int8_t *lut,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    uint32_t row_bytes = DENSE_CODEBOOK_ROW_SIZE(input_size, centroid_count);
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        const uint8_t *row = &indices[oc * row_bytes];
+        const int16_t *codebook = &centroids[oc * centroid_count];
+        int32_t bins[DENSE_CODEBOOK_MAX_CENTROIDS] = {0};
+
+        if (DENSE_CODEBOOK_BITS(centroid_count) == 4)
+        {
+            bin_inputs_4bit(inputs, row, bins, input_size);
+        }
+        else
+        {
+            bin_inputs_5bit(inputs, row, bins, input_size);
+        }
+
+        int32_t acc = folded_biases[oc];
+        for (uint32_t k = 0; k < centroid_count; ++k)
+        {
+            acc += (int32_t)codebook[k] * bins[k];
+        }
+
+        outputs[oc] = epilogue_int8(acc, multipliers[oc], shifts[oc], output_zp, min, max, lut);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over codebook weights and folded biases
+void dense_int8_codebook(
+    const int8_t *inputs,
+    const uint8_t *indices,
+    const int16_t *centroids,
+    uint32_t centroid_count,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_codebook_epilogue(
+        inputs,
+        indices,
+        centroids,
+        centroid_count,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        INT8_MIN,
+        INT8_MAX,
+        NULL,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over codebook weights and folded biases with a fused
+// epilogue
+void dense_int8_codebook_fused(
+    const int8_t *inputs,
+    const uint8_t *indices,
+    const int16_t *centroids,
+    uint32_t centroid_count,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_codebook_epilogue(
+        inputs,
+        indices,
+        centroids,
+        centroid_count,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        epilogue->min,
+        epilogue->max,
+        epilogue->lut,
+        input_size,
+        output_size);
+}
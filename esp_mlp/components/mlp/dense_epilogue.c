@@ -0,0 +1,46 @@
+// -----------------------------------------------------------------------------
+// fused epilogue (see dense_epilogue_t): clamp bounds and activation lookup
+// tables, built offline from the layer scales
+
+#include "dense.h"
+
+#include <math.h>
+
+// -----------------------------------------------------------------------------
+// real -> int8 at scale/zero_point, rounded half away from zero
+static int8_t quantize_int8(double real, float scale, int8_t zero_point)
+{
+    double q = round(real / (double)scale) + (double)zero_point;
+    if (q < (double)INT8_MIN)
+    {
+        return INT8_MIN;
+    }
+    if (q > (double)INT8_MAX)
+    {
+        return INT8_MAX;
+    }
+    return (int8_t)q;
+}
+
+// -----------------------------------------------------------------------------
+int8_t dense_relu6_max(float output_scale, int8_t output_zp)
+{
+    return quantize_int8(6.0, output_scale, output_zp);
+}
+
+// -----------------------------------------------------------------------------
+void dense_activation_lut(
+    dense_lut_function_t function,
+    float input_scale,
+    int8_t input_zp,
+    float output_scale,
+    int8_t output_zp,
+    int8_t *lut)
+{
+    for (int32_t i = 0; i < DENSE_LUT_SIZE; ++i)
+    {
+        double x = (double)(i + INT8_MIN - input_zp) * (double)input_scale;
+        double y = (function == DENSE_LUT_SIGMOID) ? 1.0 / (1.0 + exp(-x)) : tanh(x);
+        lut[i] = quantize_int8(y, output_scale, output_zp);
+    }
+}
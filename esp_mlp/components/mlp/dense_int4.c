@@ -0,0 +1,192 @@
+#include "dense.h"
+#include "epilogue.h"
+#include "quant.h"
+#include "quantize.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+// -----------------------------------------------------------------------------
+// sign-extend the low/high nibble of a packed byte
+static inline int32_t int4_low(uint8_t b)
+{
+    return (int32_t)(int8_t)(uint8_t)(b << 4) >> 4;
+}
+
+static inline int32_t int4_high(uint8_t b)
+{
+    return (int32_t)(int8_t)b >> 4;
+}
+
+// -----------------------------------------------------------------------------
+// re-quantize per-channel int8 weights to symmetric int4 in [-7, 7]:
+//   s4 = s8 * max|w8| / 7 per output channel, so the bias (scale s_in * s8) and
+//   the requantization multiplier (s_in * s8 / s_out) scale by the same ratio
+// weights are dequantized against their zero-points first, so asymmetric int8
+// weights become symmetric int4; the biases come out folded for input_zp
+int dense_quantize_int4(
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    int8_t input_zp,
+    uint8_t *int4_weights,
+    int32_t *int4_folded_biases,
+    uint32_t *int4_multipliers,
+    int32_t *int4_shifts,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    uint32_t row_bytes = DENSE_INT4_ROW_SIZE(input_size);
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        const int8_t *row = &weights[oc * input_size];
+        uint8_t *packed = &int4_weights[oc * row_bytes];
+
+        int32_t max_abs = 0;
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            int32_t w = abs((int32_t)row[ic] - (int32_t)weight_zps[oc]);
+            if (w > max_abs)
+            {
+                max_abs = w;
+            }
+        }
+
+        double ratio = (max_abs > 0) ? (double)max_abs / 7.0 : 1.0;
+
+        int32_t weight_sum = 0;
+        for (uint32_t i = 0; i < row_bytes; ++i)
+        {
+            packed[i] = 0;
+        }
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            int32_t w4 = (int32_t)lround((double)((int32_t)row[ic] - (int32_t)weight_zps[oc]) / ratio);
+            if (w4 > 7)
+            {
+                w4 = 7;
+            }
+            else if (w4 < -7)
+            {
+                w4 = -7;
+            }
+
+            weight_sum += w4;
+            packed[ic / 2] |= (uint8_t)((w4 & 0xf) << ((ic % 2) * 4));
+        }
+
+        int32_t bias = (int32_t)lround((double)biases[oc] / ratio);
+        int4_folded_biases[oc] = bias - (int32_t)input_zp * weight_sum;
+
+        double real = dequantize_multiplier(multipliers[oc], shifts[oc]) * ratio;
+        if (quantize_multiplier(real, &int4_multipliers[oc], &int4_shifts[oc]) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// dense over int4 weights (two per byte, low nibble first) and folded biases:
+// unpack each byte into two sign-extended weights and MAC; the epilogue
+// [min, max] + lut fused into the output pass
+static inline void dense_int8_int4w_epilogue(
+    const int8_t *inputs,
+    const uint8_t *int4_weights,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    int8_t min,
+    int8_t max,
+    const int8_t *lut,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    uint32_t row_bytes = DENSE_INT4_ROW_SIZE(input_size);
+    uint32_t pairs = input_size / 2;
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        const uint8_t *row = &int4_weights[oc * row_bytes];
+
+        int32_t acc = 0;
+        for (uint32_t i = 0; i < pairs; ++i)
+        {
+            uint8_t b = row[i];
+            acc += (int32_t)inputs[2 * i] * int4_low(b);
+            acc += (int32_t)inputs[2 * i + 1] * int4_high(b);
+        }
+        if (input_size % 2)
+        {
+            acc += (int32_t)inputs[input_size - 1] * int4_low(row[pairs]);
+        }
+
+        acc += folded_biases[oc];
+
+        outputs[oc] = epilogue_int8(acc, multipliers[oc], shifts[oc], output_zp, min, max, lut);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// dense over int4 weights and folded biases
+void dense_int8_int4w(
+    const int8_t *inputs,
+    const uint8_t *int4_weights,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_int4w_epilogue(
+        inputs,
+        int4_weights,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        INT8_MIN,
+        INT8_MAX,
+        NULL,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// dense over int4 weights and folded biases with a fused epilogue
+void dense_int8_int4w_fused(
+    const int8_t *inputs,
+    const uint8_t *int4_weights,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_int4w_epilogue(
+        inputs,
+        int4_weights,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        epilogue->min,
+        epilogue->max,
+        epilogue->lut,
+        input_size,
+        output_size);
+}
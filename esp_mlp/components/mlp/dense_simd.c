@@ -0,0 +1,199 @@
+#include "dense.h"
+#include "epilogue.h"
+#include "quant.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// int8 dot product, GCC vector extensions (lowered to SSE/NEON on host, or to
+// scalar code where the target has no vector unit)
+typedef int8_t v16i8 __attribute__((vector_size(16)));
+typedef int16_t v16i16 __attribute__((vector_size(32)));
+typedef int32_t v16i32 __attribute__((vector_size(64)));
+
+static inline int32_t dot_int8_vec(const int8_t *a, const int8_t *b, uint32_t size)
+{
+    v16i32 acc = {0};
+    uint32_t i = 0;
+
+    for (; i + 16 <= size; i += 16)
+    {
+        v16i8 va;
+        v16i8 vb;
+        memcpy(&va, &a[i], sizeof(va));
+        memcpy(&vb, &b[i], sizeof(vb));
+
+        // |int8 * int8| <= 2^14, so the products are exact in int16
+        v16i16 products = __builtin_convertvector(va, v16i16) * __builtin_convertvector(vb, v16i16);
+        acc += __builtin_convertvector(products, v16i32);
+    }
+
+    int32_t sum = 0;
+    for (uint32_t lane = 0; lane < 16; ++lane)
+    {
+        sum += acc[lane];
+    }
+
+    for (; i < size; ++i)
+    {
+        sum += (int32_t)a[i] * (int32_t)b[i];
+    }
+
+    return sum;
+}
+
+#if DENSE_SIMD_PIE
+// -----------------------------------------------------------------------------
+// int8 dot product, ESP32-S3 PIE: 16 MACs per EE.VMULAS.S8.ACCX into the
+// 40-bit ACCX accumulator; a and b must be 16-byte aligned (EE.VLD.128 ignores
+// the low address bits) and blocks > 0
+static inline int32_t dot_int8_pie(const int8_t *a, const int8_t *b, uint32_t blocks)
+{
+    int32_t acc;
+
+    __asm__ volatile(
+        "ee.zero.accx\n"
+        "1:\n"
+        "ee.vld.128.ip q0, %[a], 16\n"
+        "ee.vld.128.ip q1, %[b], 16\n"
+        "addi %[blocks], %[blocks], -1\n"
+        "ee.vmulas.s8.accx q0, q1\n"
+        "bnez %[blocks], 1b\n"
+        "rur.accx_0 %[acc]\n"
+        : [acc] "=r"(acc), [a] "+r"(a), [b] "+r"(b), [blocks] "+r"(blocks)
+        :
+        : "memory");
+
+    return acc;
+}
+
+// -----------------------------------------------------------------------------
+static inline int is_aligned_16(const void *p)
+{
+    return ((uintptr_t)p & 15u) == 0;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// int8 dot product on the build's SIMD backend
+static inline int32_t dot_int8(const int8_t *a, const int8_t *b, uint32_t size)
+{
+#if DENSE_SIMD_PIE
+    uint32_t blocks = size / 16;
+    if (blocks > 0 && is_aligned_16(a) && is_aligned_16(b))
+    {
+        int32_t sum = dot_int8_pie(a, b, blocks);
+        for (uint32_t i = blocks * 16; i < size; ++i)
+        {
+            sum += (int32_t)a[i] * (int32_t)b[i];
+        }
+        return sum;
+    }
+#endif
+    return dot_int8_vec(a, b, size);
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over folded biases, SIMD dot product per output channel, the
+// epilogue [min, max] + lut fused into the output pass
+static inline void dense_int8_simd_epilogue(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    int8_t min,
+    int8_t max,
+    const int8_t *lut,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    int32_t input_sum = 0;
+    if (weight_zps != NULL)
+    {
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            input_sum += (int32_t)inputs[ic];
+        }
+    }
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        int32_t acc = dot_int8(inputs, &weights[oc * input_size], input_size);
+
+        if (weight_zps != NULL)
+        {
+            acc -= (int32_t)weight_zps[oc] * input_sum;
+        }
+
+        acc += folded_biases[oc];
+
+        outputs[oc] = epilogue_int8(acc, multipliers[oc], shifts[oc], output_zp, min, max, lut);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over folded biases, SIMD dot product per output channel
+void dense_int8_simd(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_simd_epilogue(
+        inputs,
+        weights,
+        weight_zps,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        INT8_MIN,
+        INT8_MAX,
+        NULL,
+        input_size,
+        output_size);
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over folded biases, SIMD dot product per output channel, with a
+// fused epilogue
+void dense_int8_simd_fused(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    dense_int8_simd_epilogue(
+        inputs,
+        weights,
+        weight_zps,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        epilogue->min,
+        epilogue->max,
+        epilogue->lut,
+        input_size,
+        output_size);
+}
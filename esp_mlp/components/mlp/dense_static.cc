@@ -0,0 +1,80 @@
+#include "dense_static.h"
+#include "dense.hpp"
+#include "params.h"
+
+// -----------------------------------------------------------------------------
+template <typename Activation>
+static void hidden(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const Activation &activation = Activation())
+{
+    mlp::Dense<INPUT_SIZE, HIDDEN_SIZE, Activation>::run(
+        inputs,
+        weights,
+        weight_zps,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts,
+        activation);
+}
+
+// -----------------------------------------------------------------------------
+void dense_static_hidden(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue)
+{
+    if (epilogue->lut != nullptr)
+    {
+        hidden(inputs, weights, weight_zps, folded_biases, outputs, output_zp, multipliers, shifts, mlp::Lut{epilogue->lut});
+    }
+    else if (epilogue->min == INT8_MIN && epilogue->max == INT8_MAX)
+    {
+        hidden<mlp::Linear>(inputs, weights, weight_zps, folded_biases, outputs, output_zp, multipliers, shifts);
+    }
+    else if (epilogue->max == INT8_MAX)
+    {
+        hidden<mlp::Relu>(inputs, weights, weight_zps, folded_biases, outputs, output_zp, multipliers, shifts);
+    }
+    else
+    {
+        hidden(inputs, weights, weight_zps, folded_biases, outputs, output_zp, multipliers, shifts, mlp::Relu6{epilogue->max});
+    }
+}
+
+// -----------------------------------------------------------------------------
+void dense_static_output(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts)
+{
+    mlp::Dense<HIDDEN_SIZE, OUTPUT_SIZE>::run(
+        inputs,
+        weights,
+        weight_zps,
+        folded_biases,
+        outputs,
+        output_zp,
+        multipliers,
+        shifts);
+}
@@ -0,0 +1,176 @@
+#include "dense.h"
+#include "quant.h"
+
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+// marks a dropped row in the lower bounds
+#define ROW_DROPPED INT32_MIN
+
+// -----------------------------------------------------------------------------
+static inline int32_t requantize_bound(int64_t acc, uint32_t multiplier, int32_t shift, int8_t output_zp)
+{
+    // requantization is monotonic, so clamping keeps the bound
+    acc = (acc > INT32_MAX) ? INT32_MAX : (acc < INT32_MIN) ? INT32_MIN : acc;
+    return (int32_t)saturate_to_int8(multiply_by_quantized_multiplier((int32_t)acc, multiplier, shift) + (int32_t)output_zp);
+}
+
+// -----------------------------------------------------------------------------
+// k-th largest of the lower bounds of the rows still running
+static int32_t kth_lower_bound(const int32_t *lower, uint32_t k, uint32_t output_size)
+{
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        if (lower[oc] == ROW_DROPPED)
+        {
+            continue;
+        }
+
+        uint32_t greater = 0;
+        uint32_t greater_equal = 0;
+        for (uint32_t other = 0; other < output_size; ++other)
+        {
+            greater += (lower[other] > lower[oc]) ? 1 : 0;
+            greater_equal += (lower[other] >= lower[oc]) ? 1 : 0;
+        }
+        if (greater < k && k <= greater_equal)
+        {
+            return lower[oc];
+        }
+    }
+    return ROW_DROPPED;
+}
+
+// -----------------------------------------------------------------------------
+// dense (int8) over folded biases, DENSE_TOPK_CHUNK inputs at a time; before
+// each chunk every running row gets bounds on its final output from its
+// accumulator so far and the rest of the row (m = min(x), Cauchy-Schwarz on
+// the remaining inputs r):
+//   acc + m * sum(w_r) +- ||x_r - m|| * ||w_r||
+// a row whose upper bound is below the k-th best lower bound of the others
+// can't make the top k and stops there
+uint32_t dense_int8_topk(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    const int32_t *weight_sums,
+    const int32_t *weight_norms,
+    int32_t *scratch,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t k,
+    int finish,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    int32_t *accumulators = scratch;
+    int32_t *lower = &scratch[output_size];
+    uint32_t chunks = DENSE_TOPK_CHUNKS(input_size);
+    uint32_t running = output_size;
+
+    int32_t input_min = inputs[0];
+    int32_t input_sum = 0;
+    for (uint32_t ic = 0; ic < input_size; ++ic)
+    {
+        int32_t x = (int32_t)inputs[ic];
+        input_min = (x < input_min) ? x : input_min;
+        input_sum += x;
+    }
+
+    // ||x_r - m||^2 over the inputs not consumed yet
+    uint32_t input_squares = 0;
+    for (uint32_t ic = 0; ic < input_size; ++ic)
+    {
+        int32_t d = (int32_t)inputs[ic] - input_min;
+        input_squares += (uint32_t)(d * d);
+    }
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        // sum(x) * weight_zp up front, so the MACs (and the bounds) run on
+        // raw weights
+        accumulators[oc] = folded_biases[oc] - ((weight_zps != NULL) ? (int32_t)weight_zps[oc] * input_sum : 0);
+        lower[oc] = 0;
+    }
+
+    for (uint32_t c = 0; c < chunks; ++c)
+    {
+        uint32_t begin = c * DENSE_TOPK_CHUNK;
+        uint32_t end = (begin + DENSE_TOPK_CHUNK > input_size) ? input_size : begin + DENSE_TOPK_CHUNK;
+
+        if (c > 0 && running > k)
+        {
+            int64_t input_norm = ceil_sqrt(input_squares);
+            for (uint32_t oc = 0; oc < output_size; ++oc)
+            {
+                if (lower[oc] != ROW_DROPPED)
+                {
+                    int64_t base = (int64_t)accumulators[oc] + (int64_t)input_min * weight_sums[oc * chunks + c];
+                    lower[oc] = requantize_bound(base - input_norm * weight_norms[oc * chunks + c], multipliers[oc], shifts[oc], output_zp);
+                }
+            }
+
+            int32_t threshold = kth_lower_bound(lower, k, output_size);
+            for (uint32_t oc = 0; oc < output_size; ++oc)
+            {
+                if (lower[oc] != ROW_DROPPED)
+                {
+                    int64_t base = (int64_t)accumulators[oc] + (int64_t)input_min * weight_sums[oc * chunks + c];
+                    int32_t upper = requantize_bound(base + input_norm * weight_norms[oc * chunks + c], multipliers[oc], shifts[oc], output_zp);
+                    if (upper < threshold)
+                    {
+                        lower[oc] = ROW_DROPPED;
+                        --running;
+                    }
+                }
+            }
+        }
+
+        if (!finish && running <= k)
+        {
+            break;
+        }
+
+        for (uint32_t oc = 0; oc < output_size; ++oc)
+        {
+            if (lower[oc] == ROW_DROPPED)
+            {
+                continue;
+            }
+            const int8_t *row = &weights[oc * input_size];
+            int32_t acc = 0;
+            for (uint32_t ic = begin; ic < end; ++ic)
+            {
+                acc += (int32_t)inputs[ic] * (int32_t)row[ic];
+            }
+            accumulators[oc] += acc;
+        }
+
+        for (uint32_t ic = begin; ic < end; ++ic)
+        {
+            int32_t d = (int32_t)inputs[ic] - input_min;
+            input_squares -= (uint32_t)(d * d);
+        }
+    }
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        if (lower[oc] == ROW_DROPPED)
+        {
+            outputs[oc] = INT8_MIN;
+        }
+        else if (!finish && running <= k)
+        {
+            outputs[oc] = INT8_MAX;
+        }
+        else
+        {
+            outputs[oc] = saturate_to_int8(multiply_by_quantized_multiplier(accumulators[oc], multipliers[oc], shifts[oc]) + (int32_t)output_zp);
+        }
+    }
+
+    return running;
+}
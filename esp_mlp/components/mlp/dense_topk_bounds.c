@@ -0,0 +1,38 @@
+// -----------------------------------------------------------------------------
+// top-k bounds of dense_int8_topk, built offline from the weights (apart
+// from dense_topk.c, which CONFIG_MLP_KERNELS_IN_IRAM maps to IRAM)
+
+#include "dense.h"
+#include "quant.h"
+
+// -----------------------------------------------------------------------------
+void dense_topk_weight_bounds(
+    const int8_t *weights,
+    int32_t *weight_sums,
+    int32_t *weight_norms,
+    uint32_t input_size,
+    uint32_t output_size)
+{
+    uint32_t chunks = DENSE_TOPK_CHUNKS(input_size);
+
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        const int8_t *row = &weights[oc * input_size];
+        int32_t sum = 0;
+        uint32_t squares = 0;
+
+        // suffixes: entry c covers chunk c to the end of the row
+        for (uint32_t c = chunks; c-- > 0;)
+        {
+            uint32_t end = (c + 1) * DENSE_TOPK_CHUNK;
+            end = (end > input_size) ? input_size : end;
+            for (uint32_t ic = c * DENSE_TOPK_CHUNK; ic < end; ++ic)
+            {
+                sum += (int32_t)row[ic];
+                squares += (uint32_t)((int32_t)row[ic] * (int32_t)row[ic]);
+            }
+            weight_sums[oc * chunks + c] = sum;
+            weight_norms[oc * chunks + c] = (int32_t)ceil_sqrt(squares);
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef EPILOGUE_H_
+#define EPILOGUE_H_
+
+#include "dense.h"
+#include "quant.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// fused epilogue (see dense_epilogue_t) of one accumulator, bias and
+// zero-point corrections already added: requantization, output zero-point,
+// clamp, lookup; the clamp also saturates to int8, and kernels that inline it
+// with constant bounds and lut == NULL are left with a plain saturation or ReLU
+static inline int8_t epilogue_int8(
+    int32_t acc,
+    uint32_t multiplier,
+    int32_t shift,
+    int8_t output_zp,
+    int8_t min,
+    int8_t max,
+    const int8_t *lut)
+{
+    acc = multiply_by_quantized_multiplier(acc, multiplier, shift);
+
+    acc += (int32_t)output_zp;
+
+    if (acc < (int32_t)min)
+    {
+        acc = min;
+    }
+    else if (acc > (int32_t)max)
+    {
+        acc = max;
+    }
+
+    return (lut != NULL) ? lut[acc - INT8_MIN] : (int8_t)acc;
+}
+
+#endif
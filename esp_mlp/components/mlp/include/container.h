@@ -0,0 +1,164 @@
+#ifndef CONTAINER_H_
+#define CONTAINER_H_
+
+#include "mlp.h"
+#include "mlp_config.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// model container: a self-describing, memory-mappable replacement for the
+// compiled-in g_params blob, so a model update is a flash write instead of a
+// rebuild; little-endian, laid out as
+//
+//   mlp_container_header_t
+//   mlp_tensor_desc_t[tensor_count]
+//   data section (data_offset, data_size bytes)
+//
+// every tensor sits in the data section at an offset that is a multiple of
+// MLP_CONTAINER_ALIGN, and the data section itself starts at such an offset
+// from the start of the container; the loader checks that the container
+// itself is mapped MLP_CONTAINER_ALIGN-aligned, so the weight matrices keep
+// the 16-byte alignment the SIMD kernels want without a copy; plan offsets
+// (see plan.h) are relative to the data section
+
+#define MLP_CONTAINER_MAGIC     0x4d504c4d // "MLPM"
+#define MLP_CONTAINER_VERSION   1
+#define MLP_CONTAINER_ALIGN     16
+
+#define MLP_CONTAINER_ALIGN_UP(size) (((size) + MLP_CONTAINER_ALIGN - 1) & ~(uint32_t)(MLP_CONTAINER_ALIGN - 1))
+
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    MLP_TENSOR_HIDDEN_WEIGHTS = 1,
+    MLP_TENSOR_HIDDEN_BIASES = 2,
+    MLP_TENSOR_HIDDEN_WEIGHT_ZPS = 3,
+    MLP_TENSOR_HIDDEN_FOLDED_BIASES = 4,
+    MLP_TENSOR_HIDDEN_MULTIPLIERS = 5,
+    MLP_TENSOR_HIDDEN_SHIFTS = 6,
+    MLP_TENSOR_OUTPUT_WEIGHTS = 7,
+    MLP_TENSOR_OUTPUT_BIASES = 8,
+    MLP_TENSOR_OUTPUT_WEIGHT_ZPS = 9,
+    MLP_TENSOR_OUTPUT_FOLDED_BIASES = 10,
+    MLP_TENSOR_OUTPUT_MULTIPLIERS = 11,
+    MLP_TENSOR_OUTPUT_SHIFTS = 12,
+    MLP_TENSOR_SOFTMAX_PARAMS = 13,
+    MLP_TENSOR_PLAN = 14,
+    MLP_TENSOR_HIDDEN_ACTIVATION = 15, // plan activation parameters (see plan.h)
+} mlp_tensor_id_t;
+
+typedef enum
+{
+    MLP_DTYPE_UINT8 = 1,
+    MLP_DTYPE_INT8 = 2,
+    MLP_DTYPE_INT32 = 3,
+    MLP_DTYPE_UINT32 = 4,
+} mlp_dtype_t;
+
+// quantization of a weight/bias tensor: per-channel tensors keep one scale per
+// index along quant_axis (the zero-points in the matching *_WEIGHT_ZPS
+// tensor), per-tensor ones a single zero_point/scale
+typedef enum
+{
+    MLP_QUANT_NONE = 0,
+    MLP_QUANT_PER_TENSOR = 1,
+    MLP_QUANT_PER_CHANNEL = 2,
+} mlp_quant_t;
+
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t tensor_count;
+    uint32_t header_size;   // header + tensor table
+    uint32_t data_offset;
+    uint32_t data_size;
+    uint32_t data_crc32;    // CRC-32 (IEEE 802.3, as zlib) of the data section
+    uint32_t input_size;
+    uint32_t hidden_size;
+    uint32_t output_size;
+    int8_t input_zp;
+    int8_t hidden_zp;
+    int8_t output_zp;
+    uint8_t reserved[9];
+} mlp_container_header_t;
+
+// -----------------------------------------------------------------------------
+// one tensor; rank 1 tensors have shape[1] == 1; scale is 0 when only the
+// fixed-point multipliers are known (as for containers converted from
+// g_params)
+typedef struct
+{
+    uint16_t id;            // mlp_tensor_id_t
+    uint8_t dtype;          // mlp_dtype_t
+    uint8_t rank;
+    uint32_t shape[2];
+    uint32_t offset;        // from the start of the data section
+    uint32_t size;          // bytes
+    uint8_t quant;          // mlp_quant_t
+    uint8_t quant_axis;
+    uint16_t reserved;
+    int32_t zero_point;
+    float scale;
+} mlp_tensor_desc_t;
+
+// -----------------------------------------------------------------------------
+// a container mapped into the address space by mlp_model_map
+typedef struct
+{
+    const uint8_t *data;
+    uint32_t size;
+    uintptr_t handle;       // esp_partition_mmap_handle_t / mmap length
+} mlp_model_mapping_t;
+
+// -----------------------------------------------------------------------------
+// CRC-32 (IEEE 802.3) of size bytes, continuing from crc (0 to start)
+uint32_t mlp_container_crc32(uint32_t crc, const uint8_t *data, uint32_t size);
+
+// -----------------------------------------------------------------------------
+// the descriptor of tensor id in a container mlp_model_load accepted, or NULL
+const mlp_tensor_desc_t *mlp_container_tensor(const uint8_t *container, uint32_t id);
+
+// -----------------------------------------------------------------------------
+// the header and tensor table checks of mlp_model_load (everything but the
+// data CRC and the plan) for a size-byte container that isn't mapped, read
+// piecewise (see stream.h); tensors holds header->tensor_count descriptors;
+// returns 0 if they pass, -1 otherwise
+int mlp_container_check(const mlp_container_header_t *header, const mlp_tensor_desc_t *tensors, uint32_t size);
+
+// -----------------------------------------------------------------------------
+// validate a size-byte container once (magic, version, bounds, alignment,
+// dtypes/shapes against INPUT_SIZE/HIDDEN_SIZE/OUTPUT_SIZE, data CRC and,
+// with CONFIG_MLP_PLAN_EXECUTOR, the plan, which must map INPUT_SIZE inputs to
+// OUTPUT_SIZE outputs; a hidden activation other than ReLU needs the plan) and
+// resolve its tensors in place: the model points into the container, which
+// must stay mapped as long as it is in use, and mlp_model_forward runs without
+// further checks; returns 0 on success, -1 if the container is rejected; only
+// built with the row-major weight layout, the others run tables derived from
+// g_params (MLP_WEIGHTS_DERIVED)
+#if !MLP_WEIGHTS_DERIVED
+int mlp_model_load(mlp_model_t *model, const uint8_t *container, uint32_t size);
+
+// -----------------------------------------------------------------------------
+// map a container zero-copy and load it (mlp_model_load): name is the label
+// of a data partition on device (esp_partition_mmap) and a file path on the
+// host (mmap); returns 0 on success, -1 if it can't be mapped or is rejected
+int mlp_model_map(const char *name, mlp_model_t *model, mlp_model_mapping_t *mapping);
+
+// -----------------------------------------------------------------------------
+// unmap a container mapped by mlp_model_map; models loaded from it are invalid
+// afterwards
+void mlp_model_unmap(mlp_model_mapping_t *mapping);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
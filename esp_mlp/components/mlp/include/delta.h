@@ -0,0 +1,52 @@
+#ifndef DELTA_H_
+#define DELTA_H_
+
+#include "mlp.h"
+#include "params.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// incremental inference for inputs that change a few pixels per frame: the
+// context keeps the last inputs and the hidden layer's int32 accumulators;
+// a new frame only runs the weight columns of the changed pixels, then the
+// requantization+hidden activation (one pass), output layer and softmax; above
+// full_threshold changed pixels it recomputes the hidden layer instead (starts
+// at CONFIG_MLP_DELTA_FULL_THRESHOLD percent of INPUT_SIZE)
+//
+// always runs the int8 row-major hidden weights of the model, whatever
+// hidden layer variant forward_pass is built with; bit-exact with
+// mlp_model_forward on those
+typedef struct
+{
+    const mlp_model_t *model;
+    uint32_t full_threshold;
+    int valid;
+    int8_t inputs[INPUT_SIZE];
+    int32_t accumulators[HIDDEN_SIZE];
+} mlp_delta_t;
+
+// -----------------------------------------------------------------------------
+// bind a context to a model (which must outlive it); the first frame runs in
+// full
+void mlp_delta_init(mlp_delta_t *delta, const mlp_model_t *model);
+
+// -----------------------------------------------------------------------------
+// forget the cached frame: the next one runs in full
+void mlp_delta_reset(mlp_delta_t *delta);
+
+// -----------------------------------------------------------------------------
+// forward pass over a new frame, same inputs/outputs as forward_pass; returns
+// the number of pixels that changed since the last frame (INPUT_SIZE after a
+// reset)
+uint32_t mlp_delta_forward(mlp_delta_t *delta, const int8_t *inputs, int8_t *outputs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
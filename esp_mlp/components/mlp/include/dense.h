@@ -0,0 +1,605 @@
+#ifndef DENSE_H_
+#define DENSE_H_
+
+#include "mlp_config.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// dense (int8)
+void dense_int8(
+    const int8_t *inputs,
+    int8_t input_zp,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense + ReLU (int8)
+void dense_relu_int8(
+    const int8_t *inputs,
+    int8_t input_zp,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// fold input/weight zero-points into per-output-channel biases (offline)
+void dense_fold_zero_points(
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t input_zp,
+    int32_t *folded_biases,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense (int8) over folded biases; weight_zps may be NULL when all zero
+void dense_int8_folded(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense + ReLU (int8) over folded biases
+void dense_relu_int8_folded(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// in-place ReLU (int8)
+void relu_int8_inplace(int8_t *data, int8_t zero_point, uint32_t size);
+
+// -----------------------------------------------------------------------------
+// fused epilogue of a dense layer, applied to every accumulator in the same
+// pass as the bias, requantization and output zero-point:
+//   y = clamp(requantize(acc) + output_zp, min, max)
+//   y = lut[y - INT8_MIN] when lut != NULL
+// the clamp is the activation for NONE ([INT8_MIN, INT8_MAX]), ReLU
+// ([output_zp, INT8_MAX]) and ReLU6 ([output_zp, dense_relu6_max]); other
+// activations are a lookup table built offline (dense_activation_lut)
+#define DENSE_LUT_SIZE 256
+
+typedef struct
+{
+    int8_t min;
+    int8_t max;
+    const int8_t *lut;
+} dense_epilogue_t;
+
+typedef enum
+{
+    DENSE_LUT_SIGMOID = 0,
+    DENSE_LUT_TANH = 1,
+} dense_lut_function_t;
+
+// -----------------------------------------------------------------------------
+// the quantized 6.0 of a ReLU6 output (offline)
+int8_t dense_relu6_max(float output_scale, int8_t output_zp);
+
+// -----------------------------------------------------------------------------
+// DENSE_LUT_SIZE-entry table of function from the dense layer's output
+// quantization (input_scale/input_zp) to the activation's (offline)
+void dense_activation_lut(
+    dense_lut_function_t function,
+    float input_scale,
+    int8_t input_zp,
+    float output_scale,
+    int8_t output_zp,
+    int8_t *lut);
+
+// -----------------------------------------------------------------------------
+// dense (int8) over folded biases with a fused epilogue
+void dense_int8_fused(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// transpose row-major weights to column-major (offline)
+void dense_transpose_weights(
+    const int8_t *weights,
+    int8_t *transposed,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// gather (index, x - input_zp) for every input that differs from input_zp;
+// returns the number of gathered inputs
+uint32_t dense_gather_nonzero(
+    const int8_t *inputs,
+    int8_t input_zp,
+    uint16_t *indices,
+    int16_t *values,
+    uint32_t input_size);
+
+// -----------------------------------------------------------------------------
+// dense (int8) over gathered inputs, row-major weights
+void dense_int8_sparse(
+    const uint16_t *indices,
+    const int16_t *values,
+    uint32_t count,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense_int8_sparse with a fused epilogue
+void dense_int8_sparse_fused(
+    const uint16_t *indices,
+    const int16_t *values,
+    uint32_t count,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense (int8) over gathered inputs, column-major weights;
+// accumulators: output_size int32 scratch
+void dense_int8_sparse_colmajor(
+    const uint16_t *indices,
+    const int16_t *values,
+    uint32_t count,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int32_t *accumulators,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense_int8_sparse_colmajor with a fused epilogue
+void dense_int8_sparse_colmajor_fused(
+    const uint16_t *indices,
+    const int16_t *values,
+    uint32_t count,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int32_t *accumulators,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense (int8) accumulators before requantization over folded biases
+void dense_int8_accumulate(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int32_t *accumulators,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// add gathered input changes (index, new - old value) to dense_int8_accumulate
+// accumulators, row-major weights
+void dense_int8_accumulate_delta(
+    const uint16_t *indices,
+    const int16_t *deltas,
+    uint32_t count,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    int32_t *accumulators,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// requantize int32 accumulators to int8
+void dense_requantize_int8(
+    const int32_t *accumulators,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t size);
+
+// -----------------------------------------------------------------------------
+// dense_requantize_int8 with a fused epilogue
+void dense_requantize_int8_fused(
+    const int32_t *accumulators,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t size);
+
+// -----------------------------------------------------------------------------
+// batched dense (int8) over folded biases; inputs/outputs are [batch][size]
+#define DENSE_BATCH_BLOCK 4
+
+void dense_int8_batch(
+    const int8_t *inputs,
+    uint32_t batch,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense_int8_batch with a fused epilogue
+void dense_int8_batch_fused(
+    const int8_t *inputs,
+    uint32_t batch,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// weights packed in blocks of DENSE_PACK_BLOCK interleaved output channels
+#define DENSE_PACK_BLOCK 4
+#define DENSE_PACKED_BLOCKS(output_size) (((output_size) + DENSE_PACK_BLOCK - 1) / DENSE_PACK_BLOCK)
+#define DENSE_PACKED_SIZE(input_size, output_size) (DENSE_PACKED_BLOCKS(output_size) * DENSE_PACK_BLOCK * (input_size))
+
+// -----------------------------------------------------------------------------
+// repack row-major weights into DENSE_PACK_BLOCK-interleaved blocks (offline
+// or at boot); packed must hold DENSE_PACKED_SIZE(input_size, output_size)
+void dense_pack_weights(
+    const int8_t *weights,
+    int8_t *packed,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense (int8) over packed weights and folded biases
+void dense_int8_packed(
+    const int8_t *inputs,
+    const int8_t *packed_weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense_int8_packed with a fused epilogue
+void dense_int8_packed_fused(
+    const int8_t *inputs,
+    const int8_t *packed_weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// SIMD backend of dense_int8_simd, chosen at build time:
+//   ESP32-S3: PIE (EE.VMULAS.S8.ACCX) for 16-byte aligned operands
+//   elsewhere: GCC vector extensions
+#if CONFIG_IDF_TARGET_ESP32S3
+#define DENSE_SIMD_PIE 1
+#define DENSE_SIMD_BACKEND "esp32s3-pie"
+#else
+#define DENSE_SIMD_PIE 0
+#define DENSE_SIMD_BACKEND "gcc-vector"
+#endif
+
+// -----------------------------------------------------------------------------
+// dense (int8) over folded biases, SIMD backend; bit-exact with dense_int8
+void dense_int8_simd(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense_int8_simd with a fused epilogue
+void dense_int8_simd_fused(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// int4 weights: two per byte, low nibble first, rows padded to whole bytes
+#define DENSE_INT4_ROW_SIZE(input_size) (((input_size) + 1) / 2)
+#define DENSE_INT4_SIZE(input_size, output_size) (DENSE_INT4_ROW_SIZE(input_size) * (output_size))
+
+// -----------------------------------------------------------------------------
+// re-quantize int8 weights to per-channel symmetric int4 (offline); produces
+// the int4 weights, biases folded for input_zp and the adjusted requantization
+// multipliers/shifts; returns 0 on success
+int dense_quantize_int4(
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    int8_t input_zp,
+    uint8_t *int4_weights,
+    int32_t *int4_folded_biases,
+    uint32_t *int4_multipliers,
+    int32_t *int4_shifts,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense (int8 inputs) over int4 weights and folded biases
+void dense_int8_int4w(
+    const int8_t *inputs,
+    const uint8_t *int4_weights,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense_int8_int4w with a fused epilogue
+void dense_int8_int4w_fused(
+    const int8_t *inputs,
+    const uint8_t *int4_weights,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// block-sparse weights: 1xDENSE_SPARSE_BLOCK blocks of consecutive inputs per
+// output channel, stored CSR-style (see dense_block_sparse.c)
+#define DENSE_SPARSE_BLOCK 8
+#define DENSE_SPARSE_ROW_BLOCKS(input_size) (((input_size) + DENSE_SPARSE_BLOCK - 1) / DENSE_SPARSE_BLOCK)
+#define DENSE_SPARSE_MAX_BLOCKS(input_size, output_size) (DENSE_SPARSE_ROW_BLOCKS(input_size) * (output_size))
+
+// -----------------------------------------------------------------------------
+// magnitude pruning mask (offline): one byte per block, [output_size][row
+// blocks], 0 = pruned; returns 0 on success
+int dense_prune_blocks(
+    const int8_t *weights,
+    uint8_t *mask,
+    uint32_t sparsity_pct,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// encode symmetric (zero weight zero-point) row-major weights as block-sparse
+// (offline); row_ptr holds output_size + 1 entries, block_cols/values room for
+// DENSE_SPARSE_MAX_BLOCKS blocks; returns the number of blocks kept
+uint32_t dense_encode_block_sparse(
+    const int8_t *weights,
+    const int32_t *biases,
+    int8_t input_zp,
+    const uint8_t *mask,
+    uint32_t *row_ptr,
+    uint16_t *block_cols,
+    int8_t *values,
+    int32_t *folded_biases,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense (int8) over block-sparse weights and folded biases; bit-exact with
+// dense_int8 over the pruned dense weights
+void dense_int8_block_sparse(
+    const int8_t *inputs,
+    const uint32_t *row_ptr,
+    const uint16_t *block_cols,
+    const int8_t *values,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense_int8_block_sparse with a fused epilogue
+void dense_int8_block_sparse_fused(
+    const int8_t *inputs,
+    const uint32_t *row_ptr,
+    const uint16_t *block_cols,
+    const int8_t *values,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// codebook weights: 16 or 32 centroids per output channel and one 4- or 5-bit
+// centroid index per weight, packed LSB-first, rows padded to whole bytes
+#define DENSE_CODEBOOK_MAX_CENTROIDS 32
+#define DENSE_CODEBOOK_BITS(centroid_count) ((centroid_count) <= 16 ? 4 : 5)
+#define DENSE_CODEBOOK_ROW_SIZE(input_size, centroid_count) \
+    (((input_size) * DENSE_CODEBOOK_BITS(centroid_count) + 7) / 8)
+#define DENSE_CODEBOOK_SIZE(input_size, output_size, centroid_count) \
+    (DENSE_CODEBOOK_ROW_SIZE(input_size, centroid_count) * (output_size))
+
+// -----------------------------------------------------------------------------
+// cluster per-channel int8 weights into 16 or 32 centroids (offline, 1-D
+// k-means); centroids are stored relative to the weight zero-point and the
+// biases come out folded for input_zp; returns 0 on success
+int dense_cluster_weights(
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *biases,
+    int8_t input_zp,
+    uint32_t centroid_count,
+    uint8_t *indices,
+    int16_t *centroids,
+    int32_t *folded_biases,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense (int8) over codebook weights and folded biases: per-centroid input
+// sums, then centroid_count multiplies per output channel
+void dense_int8_codebook(
+    const int8_t *inputs,
+    const uint8_t *indices,
+    const int16_t *centroids,
+    uint32_t centroid_count,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense_int8_codebook with a fused epilogue
+void dense_int8_codebook_fused(
+    const int8_t *inputs,
+    const uint8_t *indices,
+    const int16_t *centroids,
+    uint32_t centroid_count,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// early-exit top-k: inputs are consumed DENSE_TOPK_CHUNK at a time, with a
+// bound check on every output row between chunks (see dense_topk.c)
+#define DENSE_TOPK_CHUNK 16
+#define DENSE_TOPK_CHUNKS(input_size) (((input_size) + DENSE_TOPK_CHUNK - 1) / DENSE_TOPK_CHUNK)
+#define DENSE_TOPK_BOUNDS_SIZE(input_size, output_size) (DENSE_TOPK_CHUNKS(input_size) * (output_size))
+#define DENSE_TOPK_SCRATCH_SIZE(output_size) (2 * (output_size))
+
+// -----------------------------------------------------------------------------
+// per-row weight sums and L2 norms (rounded up) from each chunk to the end of
+// the row (offline, dense_topk_bounds.c), [output_size][DENSE_TOPK_CHUNKS]
+void dense_topk_weight_bounds(
+    const int8_t *weights,
+    int32_t *weight_sums,
+    int32_t *weight_norms,
+    uint32_t input_size,
+    uint32_t output_size);
+
+// -----------------------------------------------------------------------------
+// dense (int8) over folded biases that drops output rows as soon as they can
+// no longer make the top k; dropped rows output INT8_MIN, the others their
+// exact output, bit-exact with dense_int8_folded; with finish == 0 it stops
+// once only k rows are left and those output INT8_MAX instead (top k known,
+// order not); scratch holds DENSE_TOPK_SCRATCH_SIZE(output_size) values;
+// returns the number of rows left
+uint32_t dense_int8_topk(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    const int32_t *weight_sums,
+    const int32_t *weight_norms,
+    int32_t *scratch,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    uint32_t k,
+    int finish,
+    uint32_t input_size,
+    uint32_t output_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
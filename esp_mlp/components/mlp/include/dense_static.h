@@ -0,0 +1,49 @@
+#ifndef DENSE_STATIC_H_
+#define DENSE_STATIC_H_
+
+#include "dense.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// the built-in model's layers through the compile-time specialized kernels of
+// dense.hpp (shapes from params.h, requantization per CONFIG_MLP_REQUANT_*),
+// same arguments and results as dense_int8_fused/dense_int8_folded without
+// the sizes
+
+// -----------------------------------------------------------------------------
+// INPUT_SIZE -> HIDDEN_SIZE with the hidden activation as an epilogue of the
+// form the plan produces (ReLU, ReLU6, none, or a lookup table without a
+// clamp), each through its own instantiation
+void dense_static_hidden(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts,
+    const dense_epilogue_t *epilogue);
+
+// -----------------------------------------------------------------------------
+// HIDDEN_SIZE -> OUTPUT_SIZE, no activation
+void dense_static_output(
+    const int8_t *inputs,
+    const int8_t *weights,
+    const int8_t *weight_zps,
+    const int32_t *folded_biases,
+    int8_t *outputs,
+    int8_t output_zp,
+    const uint32_t *multipliers,
+    const int32_t *shifts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef MLP_H_
+#define MLP_H_
+
+#include "dense.h"
+#include "plan.h"
+#include "softmax.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// hidden layer kernel selected by forward_pass
+typedef enum
+{
+    MLP_PATH_DENSE,
+    MLP_PATH_SPARSE,
+} mlp_path_t;
+
+// -----------------------------------------------------------------------------
+// model context: the tables of a params blob (params.h layout) or a model
+// container (container.h) resolved once by mlp_model_init/mlp_model_load and
+// read-only afterwards, so any number of tasks can run
+// mlp_model_forward over the same context at once (activations live on the
+// caller's stack); the compressed hidden layers (CONFIG_MLP_HIDDEN_*,
+// CONFIG_MLP_PACKED_WEIGHTS) still read the tables mlp_gen derived from
+// g_params (there is no mlp_model_load with them), and
+// CONFIG_MLP_DUAL_CORE shares a single worker, so neither is
+// reentrant across contexts
+typedef struct
+{
+    const uint8_t *params; // base of the plan offsets: the blob or the container data section
+    const int8_t *hidden_weights;
+    const int8_t *hidden_weight_zps; // NULL for symmetric weights
+    const int32_t *hidden_biases;
+    const int32_t *hidden_folded_biases;
+    const uint32_t *hidden_multipliers;
+    const int32_t *hidden_shifts;
+    const int8_t *output_weights;
+    const int8_t *output_weight_zps; // NULL for symmetric weights
+    const int32_t *output_folded_biases;
+    const uint32_t *output_multipliers;
+    const int32_t *output_shifts;
+    const int32_t *output_weight_sums;  // top-k bounds (dense_topk_weight_bounds), NULL without
+    const int32_t *output_weight_norms; // NULL without
+    const softmax_params_t *softmax;
+    const mlp_plan_t *plan; // CONFIG_MLP_PLAN_EXECUTOR only
+    dense_epilogue_t hidden_epilogue; // ReLU, or the plan's hidden activation with CONFIG_MLP_PLAN_EXECUTOR
+    int8_t input_zp;
+    int8_t hidden_zp;
+    int8_t output_zp;
+} mlp_model_t;
+
+// -----------------------------------------------------------------------------
+// resolve a params_size-byte blob laid out as g_params (see params.h); the
+// top-k bounds mlp_gen derived into params_folded.c are only used for
+// g_params itself; returns 0 on success, -1 if the blob is too small (or, with
+// CONFIG_MLP_PLAN_EXECUTOR, its plan is malformed)
+int mlp_model_init(mlp_model_t *model, const uint8_t *params, uint32_t params_size);
+
+// -----------------------------------------------------------------------------
+// forward pass over a model context, same inputs/outputs as forward_pass
+void mlp_model_forward(const mlp_model_t *model, const int8_t *inputs, int8_t *outputs);
+
+// -----------------------------------------------------------------------------
+// forward pass over a model context without softmax, for callers that only
+// need the best classes:
+//   classes: the k best class indices, best first (ties go to the lower index)
+//   logits: their raw int8 logits, or NULL
+//   early_stop: drop output rows as soon as they can no longer make the top k
+//   (see dense_int8_topk); with k == 1 and logits == NULL the output layer
+//   stops as soon as a single row is left; ignored for models without top-k
+//   bounds
+// returns min(k, OUTPUT_SIZE)
+uint32_t mlp_model_topk(
+    const mlp_model_t *model,
+    const int8_t *inputs,
+    uint32_t k,
+    int early_stop,
+    uint32_t *classes,
+    int8_t *logits);
+
+// -----------------------------------------------------------------------------
+// batched forward pass over a model context, weights streamed once per
+// CONFIG_MLP_BATCH_SIZE inputs:
+//   inputs: [count][INPUT_SIZE]
+//   outputs: [count][OUTPUT_SIZE]
+void mlp_model_forward_batch(const mlp_model_t *model, const int8_t *inputs, int8_t *outputs, uint32_t count);
+
+// -----------------------------------------------------------------------------
+// forward pass over g_params:
+//   inputs: INPUT_SIZE int8 values (16-byte aligned for the ESP32-S3 SIMD path)
+//   outputs: OUTPUT_SIZE int8 softmax scores (scale 1/256, zero-point -128,
+//   as the TFLite model)
+void forward_pass(const int8_t *inputs, int8_t *outputs);
+
+// -----------------------------------------------------------------------------
+// mlp_model_topk over g_params
+uint32_t forward_pass_topk(const int8_t *inputs, uint32_t k, int early_stop, uint32_t *classes, int8_t *logits);
+
+// -----------------------------------------------------------------------------
+// mlp_model_forward_batch over g_params
+void forward_pass_batch(const int8_t *inputs, int8_t *outputs, uint32_t count);
+
+// -----------------------------------------------------------------------------
+// hidden layer path forward_pass takes for these inputs
+mlp_path_t forward_pass_path(const int8_t *inputs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef MLP_CONFIG_H_
+#define MLP_CONFIG_H_
+
+// -----------------------------------------------------------------------------
+// build configuration: Kconfig on device, compile definitions (or the defaults
+// below) on host
+
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+#ifndef CONFIG_IDF_TARGET_ESP32S3
+#define CONFIG_IDF_TARGET_ESP32S3 0
+#endif
+
+#ifndef CONFIG_MLP_PLAN_EXECUTOR
+#define CONFIG_MLP_PLAN_EXECUTOR 0
+#endif
+
+#ifndef CONFIG_MLP_MODEL_PARTITION
+#define CONFIG_MLP_MODEL_PARTITION 0
+#endif
+
+#ifndef CONFIG_MLP_MODEL_PARTITION_LABEL
+#define CONFIG_MLP_MODEL_PARTITION_LABEL "model"
+#endif
+
+#ifndef CONFIG_MLP_HIDDEN_COLUMN_MAJOR
+#define CONFIG_MLP_HIDDEN_COLUMN_MAJOR 0
+#endif
+
+#ifndef CONFIG_MLP_PACKED_WEIGHTS
+#define CONFIG_MLP_PACKED_WEIGHTS 0
+#endif
+
+#ifndef CONFIG_MLP_HIDDEN_INT4
+#define CONFIG_MLP_HIDDEN_INT4 0
+#endif
+
+#ifndef CONFIG_MLP_HIDDEN_BLOCK_SPARSE
+#define CONFIG_MLP_HIDDEN_BLOCK_SPARSE 0
+#endif
+
+#ifndef CONFIG_MLP_HIDDEN_CODEBOOK
+#define CONFIG_MLP_HIDDEN_CODEBOOK 0
+#endif
+
+#if CONFIG_MLP_HIDDEN_COLUMN_MAJOR + CONFIG_MLP_PACKED_WEIGHTS + CONFIG_MLP_HIDDEN_INT4 + CONFIG_MLP_HIDDEN_BLOCK_SPARSE + \
+        CONFIG_MLP_HIDDEN_CODEBOOK > 1
+#error "the weight layouts (column-major, packed, int4, block-sparse, codebook) are mutually exclusive"
+#endif
+
+// every weight layout but row-major runs tables mlp_gen derived from g_params,
+// which no model container (container.h) can replace
+#define MLP_WEIGHTS_DERIVED (CONFIG_MLP_HIDDEN_COLUMN_MAJOR || CONFIG_MLP_PACKED_WEIGHTS || CONFIG_MLP_HIDDEN_INT4 || \
+                             CONFIG_MLP_HIDDEN_BLOCK_SPARSE || CONFIG_MLP_HIDDEN_CODEBOOK)
+
+#if CONFIG_MLP_MODEL_PARTITION && MLP_WEIGHTS_DERIVED
+#error "CONFIG_MLP_MODEL_PARTITION needs the row-major weight layout"
+#endif
+
+#ifndef CONFIG_MLP_STATIC_KERNELS
+#define CONFIG_MLP_STATIC_KERNELS 0
+#endif
+
+#ifndef CONFIG_MLP_DUAL_CORE
+#define CONFIG_MLP_DUAL_CORE 0
+#endif
+
+#ifndef CONFIG_MLP_WORKER_CORE
+#define CONFIG_MLP_WORKER_CORE 1
+#endif
+
+#ifndef CONFIG_MLP_WORKER_PRIORITY
+#define CONFIG_MLP_WORKER_PRIORITY 20
+#endif
+
+#ifndef CONFIG_MLP_WORKER_STACK_SIZE
+#define CONFIG_MLP_WORKER_STACK_SIZE 3072
+#endif
+
+#ifndef CONFIG_MLP_SCHEDULER
+#define CONFIG_MLP_SCHEDULER 0
+#endif
+
+#ifndef CONFIG_MLP_SCHEDULER_WORKERS
+#define CONFIG_MLP_SCHEDULER_WORKERS 2
+#endif
+
+#ifndef CONFIG_MLP_SCHEDULER_PRIORITY
+#define CONFIG_MLP_SCHEDULER_PRIORITY 5
+#endif
+
+#ifndef CONFIG_MLP_SCHEDULER_STACK_SIZE
+#define CONFIG_MLP_SCHEDULER_STACK_SIZE 8192
+#endif
+
+#if !defined(CONFIG_MLP_REQUANT_EXACT64) && !defined(CONFIG_MLP_REQUANT_APPROX32) && \
+    !defined(CONFIG_MLP_REQUANT_POT) && !defined(CONFIG_MLP_REQUANT_FLOAT)
+#define CONFIG_MLP_REQUANT_APPROX32 1
+#endif
+
+#ifndef CONFIG_MLP_REQUANT_EXACT64
+#define CONFIG_MLP_REQUANT_EXACT64 0
+#endif
+
+#ifndef CONFIG_MLP_REQUANT_APPROX32
+#define CONFIG_MLP_REQUANT_APPROX32 0
+#endif
+
+#ifndef CONFIG_MLP_REQUANT_POT
+#define CONFIG_MLP_REQUANT_POT 0
+#endif
+
+#ifndef CONFIG_MLP_REQUANT_FLOAT
+#define CONFIG_MLP_REQUANT_FLOAT 0
+#endif
+
+#ifndef CONFIG_MLP_SPARSE_DENSITY_THRESHOLD
+#define CONFIG_MLP_SPARSE_DENSITY_THRESHOLD 31
+#endif
+
+#ifndef CONFIG_MLP_DELTA_FULL_THRESHOLD
+#define CONFIG_MLP_DELTA_FULL_THRESHOLD 25
+#endif
+
+#ifndef CONFIG_MLP_BATCH_SIZE
+#define CONFIG_MLP_BATCH_SIZE 8
+#endif
+
+#ifndef CONFIG_MLP_PROFILE
+#define CONFIG_MLP_PROFILE 0
+#endif
+
+#ifndef CONFIG_MLP_PROFILE_RECORDS
+#define CONFIG_MLP_PROFILE_RECORDS 256
+#endif
+
+#ifndef CONFIG_MLP_PLACEMENT
+#define CONFIG_MLP_PLACEMENT 0
+#endif
+
+#ifndef CONFIG_MLP_PLACE_HIDDEN_WEIGHTS
+#define CONFIG_MLP_PLACE_HIDDEN_WEIGHTS 0
+#endif
+
+#ifndef CONFIG_MLP_PLACE_HIDDEN_TABLES
+#define CONFIG_MLP_PLACE_HIDDEN_TABLES 1
+#endif
+
+#ifndef CONFIG_MLP_PLACE_OUTPUT_WEIGHTS
+#define CONFIG_MLP_PLACE_OUTPUT_WEIGHTS 1
+#endif
+
+#ifndef CONFIG_MLP_PLACE_OUTPUT_TABLES
+#define CONFIG_MLP_PLACE_OUTPUT_TABLES 1
+#endif
+
+#ifndef CONFIG_MLP_STREAM
+#define CONFIG_MLP_STREAM 0
+#endif
+
+#ifndef CONFIG_MLP_STREAM_TILE_SIZE
+#define CONFIG_MLP_STREAM_TILE_SIZE 8192
+#endif
+
+#ifndef CONFIG_MLP_STREAM_PARTITION_LABEL
+#define CONFIG_MLP_STREAM_PARTITION_LABEL "model"
+#endif
+
+#ifndef CONFIG_MLP_STREAM_LOADER_CORE
+#define CONFIG_MLP_STREAM_LOADER_CORE 1
+#endif
+
+#ifndef CONFIG_MLP_STREAM_LOADER_PRIORITY
+#define CONFIG_MLP_STREAM_LOADER_PRIORITY 20
+#endif
+
+#ifndef CONFIG_MLP_STREAM_LOADER_STACK_SIZE
+#define CONFIG_MLP_STREAM_LOADER_STACK_SIZE 2048
+#endif
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef PARAMS_H_
 #define PARAMS_H_
 
+// generated by gen_params.py from model.tflite; do not edit
+
 #include <inttypes.h>
 
 // -----------------------------------------------------------------------------
@@ -13,6 +15,10 @@
 #define HIDDEN_SIZE                 128
 #define OUTPUT_SIZE                 10
 
+// -----------------------------------------------------------------------------
+// every tensor starts on a PARAMS_ALIGN boundary of g_params
+#define PARAMS_ALIGN                16
+
 // -----------------------------------------------------------------------------
 // hidden layer weights
 #define HIDDEN_WEIGHT_OFFSET        0
@@ -35,47 +41,66 @@
 
 // -----------------------------------------------------------------------------
 // input layer zero-point
-#define INPUT_ZP_OFFSET             102184
+#define INPUT_ZP_OFFSET             102192
 #define INPUT_ZP_SIZE               1
 
 // -----------------------------------------------------------------------------
 // hidden layer zero-point
-#define HIDDEN_ZP_OFFSET            102185
+#define HIDDEN_ZP_OFFSET            102208
 #define HIDDEN_ZP_SIZE              1
 
 // -----------------------------------------------------------------------------
 // hidden layer weights zero-point
-#define HIDDEN_WEIGHT_ZP_OFFSET     102186
+#define HIDDEN_WEIGHT_ZP_OFFSET     102224
 #define HIDDEN_WEIGHT_ZP_SIZE       128
 
 // -----------------------------------------------------------------------------
 // layer1 multipler/shift
-#define LAYER1_MULTIPLIER_OFFSET    102316
+#define LAYER1_MULTIPLIER_OFFSET    102352
 #define LAYER1_MULTIPLIER_SIZE      512
-#define LAYER1_SCALE_OFFSET         102828
+#define LAYER1_SCALE_OFFSET         102864
 #define LAYER1_SCALE_SIZE           512
 
 // -----------------------------------------------------------------------------
 // output layer zero-point
-#define OUTPUT_ZP_OFFSET            103341
+#define OUTPUT_ZP_OFFSET            103376
 #define OUTPUT_ZP_SIZE              1
 
 // -----------------------------------------------------------------------------
 // output layer weights zero-point
-#define OUTPUT_WEIGHT_ZP_OFFSET     103342
+#define OUTPUT_WEIGHT_ZP_OFFSET     103392
 #define OUTPUT_WEIGHT_ZP_SIZE       10
 
 // -----------------------------------------------------------------------------
 // layer2 multipler/shift
-#define LAYER2_MULTIPLIER_OFFSET    103352
+#define LAYER2_MULTIPLIER_OFFSET    103408
 #define LAYER2_MULTIPLIER_SIZE      40
-#define LAYER2_SCALE_OFFSET         103392
+#define LAYER2_SCALE_OFFSET         103456
 #define LAYER2_SCALE_SIZE           40
 
+// -----------------------------------------------------------------------------
+// execution plan (see plan.h): dense+ReLU, dense, softmax
+#define PLAN_OFFSET                 103504
+#define PLAN_SIZE                   128
+#define PLAN_ARENA_SIZE             128
+
+// -----------------------------------------------------------------------------
+// hidden/output layer biases with the zero-points folded in, for the plan
+#define HIDDEN_FOLDED_BIAS_OFFSET   103632
+#define HIDDEN_FOLDED_BIAS_SIZE     512
+#define OUTPUT_FOLDED_BIAS_OFFSET   104144
+#define OUTPUT_FOLDED_BIAS_SIZE     40
+
+// -----------------------------------------------------------------------------
+// output softmax params (see softmax.h), from the logits scale
+// (0.21290959) and beta (1.0) in the model
+#define SOFTMAX_PARAMS_OFFSET       104192
+#define SOFTMAX_PARAMS_SIZE         12
+
 // -----------------------------------------------------------------------------
 // total size
-#define PARAMS_SIZE                 103432
+#define PARAMS_SIZE                 104208
 
 extern const uint8_t g_params[];
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,16 @@
+#ifndef PARAMS_FOLDED_H_
+#define PARAMS_FOLDED_H_
+
+// generated by mlp_gen from g_params; do not edit
+
+#include "params.h"
+
+// -----------------------------------------------------------------------------
+// output layer weight sums/norms for dense_int8_topk
+
+#define OUTPUT_TOPK_BOUNDS_SIZE     80
+
+extern const int32_t g_output_weight_sums[OUTPUT_TOPK_BOUNDS_SIZE];
+extern const int32_t g_output_weight_norms[OUTPUT_TOPK_BOUNDS_SIZE];
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef PLACEMENT_H_
+#define PLACEMENT_H_
+
+#include "container.h"
+#include "mlp.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// tensor placement: a loaded model reads every tensor in place, from flash
+// through the cache, where the small output layer tables miss alongside the
+// hidden weights streaming past them; mlp_model_place copies the tensors a
+// policy picks to internal RAM (or PSRAM) and repoints the model at the
+// copies, trading a few KB of SRAM for a latency that doesn't depend on what
+// the cache holds
+//
+// the regions come from mlp_region_alloc: heap_caps on device
+// (placement_heap_caps.c), capacity-limited mock arenas on the host
+// (placement_mock.c), so the fallbacks can be exercised there
+
+#define MLP_TENSOR_ID_COUNT 16 // mlp_tensor_id_t values are below
+
+typedef enum
+{
+    MLP_PLACE_FLASH = 0,    // read in place (wherever the model was loaded from)
+    MLP_PLACE_DRAM = 1,     // internal RAM
+    MLP_PLACE_PSRAM = 2,    // external RAM (ESP32-S3 with PSRAM)
+    MLP_PLACE_COUNT,
+} mlp_place_t;
+
+// -----------------------------------------------------------------------------
+// per tensor, indexed by mlp_tensor_id_t; ids the model doesn't have (and the
+// plan) are ignored
+typedef struct
+{
+    uint8_t place[MLP_TENSOR_ID_COUNT]; // mlp_place_t
+} mlp_placement_policy_t;
+
+// -----------------------------------------------------------------------------
+// what mlp_model_place did: the copies (to release) and the footprint, by
+// where the tensors ended up
+typedef struct
+{
+    void *copies[MLP_TENSOR_ID_COUNT];
+    uint32_t copy_sizes[MLP_TENSOR_ID_COUNT];
+    uint8_t copy_places[MLP_TENSOR_ID_COUNT];
+    uint32_t copy_count;
+    uint32_t bytes[MLP_PLACE_COUNT];
+    uint32_t tensors[MLP_PLACE_COUNT];
+    uint32_t fallbacks;     // left in flash: the region was out of memory
+} mlp_placement_t;
+
+// -----------------------------------------------------------------------------
+// the policy selected in Kconfig (CONFIG_MLP_PLACE_*): one place for the
+// hidden weights, one for the other hidden layer tables, and the same two for
+// the output layer (softmax parameters included)
+void mlp_placement_policy_default(mlp_placement_policy_t *policy);
+
+// -----------------------------------------------------------------------------
+// copy the tensors of a model (mlp_model_init/mlp_model_load) to the regions
+// the policy picks, MLP_CONTAINER_ALIGN-aligned, and repoint the model; a
+// tensor whose region is out of memory stays where it is and is counted in
+// fallbacks; call before the model is shared (mlp_delta_init, the scheduler)
+// and keep the copies as long as the model is in use; returns the number of
+// fallbacks, or -1 if the policy can't be honored at all: with
+// CONFIG_MLP_PLAN_EXECUTOR, the plan reads its tensors through offsets from
+// the blob, and the weight layouts other than row-major (MLP_WEIGHTS_DERIVED)
+// run tables mlp_gen derived from g_params, so only an all-flash policy is
+// accepted
+int mlp_model_place(mlp_model_t *model, const mlp_placement_policy_t *policy, mlp_placement_t *placement);
+
+// -----------------------------------------------------------------------------
+// free the copies; the model they were made for is invalid afterwards
+void mlp_placement_release(mlp_placement_t *placement);
+
+// -----------------------------------------------------------------------------
+// size bytes in region (not MLP_PLACE_FLASH), MLP_CONTAINER_ALIGN-aligned, or
+// NULL if it's out of memory
+void *mlp_region_alloc(mlp_place_t region, uint32_t size);
+void mlp_region_free(mlp_place_t region, void *data, uint32_t size);
+
+#ifndef ESP_PLATFORM
+// -----------------------------------------------------------------------------
+// host mock: region capacities (bytes, 0 for a target without it) and the
+// bytes allocated so far
+void mlp_region_mock_set(uint32_t dram_capacity, uint32_t psram_capacity);
+uint32_t mlp_region_mock_used(mlp_place_t region);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef PLAN_H_
+#define PLAN_H_
+
+#include "dense.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// execution plan embedded in a params blob: a header followed by
+// layer_count layer records, all little-endian 32-bit aligned; every offset is
+// a byte offset into the same blob
+//
+// activations ping-pong through one arena: the input of a layer sits at one
+// end and its output at the other, so the arena only needs to hold the
+// largest (aligned) input + output pair; the first layer reads the caller's
+// inputs and the last out-of-place layer writes the caller's outputs
+
+#define MLP_PLAN_MAGIC      0x4e414c50 // "PLAN"
+#define MLP_PLAN_VERSION    3
+#define MLP_PLAN_ALIGN      16
+#define MLP_PLAN_NONE       0xffffffffu
+
+#define MLP_PLAN_ALIGN_UP(size) (((size) + MLP_PLAN_ALIGN - 1) & ~(uint32_t)(MLP_PLAN_ALIGN - 1))
+
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    MLP_LAYER_DENSE = 1,
+    MLP_LAYER_SOFTMAX = 2,
+} mlp_layer_type_t;
+
+typedef enum
+{
+    MLP_ACTIVATION_NONE = 0,
+    MLP_ACTIVATION_RELU = 1,
+    MLP_ACTIVATION_RELU6 = 2,
+    MLP_ACTIVATION_LUT = 3,
+} mlp_activation_t;
+
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t layer_count;
+    uint32_t input_size;
+    uint32_t output_size;
+    uint32_t arena_size;
+} mlp_plan_t;
+
+// -----------------------------------------------------------------------------
+// one layer; dense layers read int8 [output_size][input_size] weights,
+// int32 biases with the zero-points folded in (see dense_fold_zero_points)
+// and per-channel multipliers/shifts; weight_zp_offset is MLP_PLAN_NONE for
+// symmetric weights; the activation is fused into the dense layer's output
+// pass (see dense_epilogue_t) and reads its parameters at activation_offset:
+// the quantized 6.0 (int8) for RELU6, a DENSE_LUT_SIZE-entry int8 table for
+// LUT, MLP_PLAN_NONE otherwise; softmax layers run in place and read a
+// softmax_params_t (see softmax.h) at multiplier_offset
+typedef struct
+{
+    uint8_t type;
+    uint8_t activation;
+    int8_t input_zp;
+    int8_t output_zp;
+    uint32_t input_size;
+    uint32_t output_size;
+    uint32_t weight_offset;
+    uint32_t weight_zp_offset;
+    uint32_t folded_bias_offset;
+    uint32_t multiplier_offset;
+    uint32_t shift_offset;
+    uint32_t activation_offset;
+} mlp_plan_layer_t;
+
+// -----------------------------------------------------------------------------
+// the plan at plan_offset in a params_size-byte blob, or NULL if it is
+// malformed (bad magic/version, layers that don't chain, offsets out of range
+// or misaligned, an arena larger than arena_capacity)
+const mlp_plan_t *mlp_plan_get(
+    const uint8_t *params,
+    uint32_t params_size,
+    uint32_t plan_offset,
+    uint32_t arena_capacity);
+
+// -----------------------------------------------------------------------------
+// the activation of dense layer l of a plan returned by mlp_plan_get, as the
+// epilogue of the fused kernels (see dense_epilogue_t)
+void mlp_plan_epilogue(const mlp_plan_t *plan, const uint8_t *params, uint32_t l, dense_epilogue_t *epilogue);
+
+// -----------------------------------------------------------------------------
+// run a plan returned by mlp_plan_get:
+//   arena: plan->arena_size bytes, 16-byte aligned
+//   inputs: plan->input_size int8 values (16-byte aligned for the ESP32-S3
+//   SIMD path)
+//   outputs: plan->output_size int8 values
+void mlp_plan_run(
+    const mlp_plan_t *plan,
+    const uint8_t *params,
+    int8_t *arena,
+    const int8_t *inputs,
+    int8_t *outputs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include "mlp_config.h"
+
+#include <stdint.h>
+
+#if CONFIG_MLP_PROFILE
+#ifdef ESP_PLATFORM
+#include "esp_cpu.h"
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// per-stage profiler (CONFIG_MLP_PROFILE): MLP_PROFILE_BEGIN/END around a
+// stage stamp the clock and append a record to a ring buffer of
+// CONFIG_MLP_PROFILE_RECORDS entries, overwriting the oldest; a slot is
+// claimed with one atomic add, so any core or thread can record without a
+// lock; both macros expand to nothing without CONFIG_MLP_PROFILE
+//
+// the clock is the CPU cycle counter on device (32 bits, wraps), the TSC on
+// x86 hosts and CLOCK_MONOTONIC nanoseconds elsewhere; mlp_profile_dump
+// writes the records with the clock rate, and scripts/profile_decode.py turns
+// them into a per-stage breakdown and a Chrome trace
+//
+// the two cores' cycle counters aren't synchronized, so on device every
+// context is a timebase of its own: durations are exact, starts only compare
+// within one context (the decoder puts each core on its own timeline); the
+// host clocks are shared, which the header says with MLP_PROFILE_SHARED_CLOCK
+
+#define MLP_PROFILE_MAGIC       0x544c504d // "MLPT"
+#define MLP_PROFILE_VERSION     1
+
+// header flags
+#define MLP_PROFILE_SHARED_CLOCK 0x1 // starts of every context on one timeline
+
+// -----------------------------------------------------------------------------
+// stages; fused kernels record the steps they fuse under the enclosing stage
+// (every hidden kernel fuses its ReLU, dense+ReLU is one DENSE1 record), so
+// REQUANT only shows up on delta inference, where requantization+ReLU is a
+// pass of its own; RELU isn't recorded anymore and only keeps its id in the
+// dump format; a plan records its first dense layer as DENSE1, the later ones
+// as DENSE2
+typedef enum
+{
+    MLP_SCOPE_FORWARD = 0,
+    MLP_SCOPE_DENSE1 = 1,
+    MLP_SCOPE_REQUANT = 2,
+    MLP_SCOPE_RELU = 3,
+    MLP_SCOPE_DENSE2 = 4,
+    MLP_SCOPE_SOFTMAX = 5,
+    MLP_SCOPE_COUNT,
+} mlp_scope_t;
+
+// -----------------------------------------------------------------------------
+// dump layout: the header, then count records, oldest first
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;   // sizeof(mlp_profile_record_t)
+    uint64_t clock_hz;
+    uint32_t clock_bits;    // 32: start wraps and must be unwrapped in order
+    uint32_t count;
+    uint32_t dropped;       // overwritten before the dump
+    uint32_t flags;         // MLP_PROFILE_SHARED_CLOCK, 0 in older dumps
+} mlp_profile_header_t;
+
+typedef struct
+{
+    uint64_t start;
+    uint32_t duration;      // end - start, wrap-safe
+    uint8_t scope;          // mlp_scope_t
+    uint8_t context;        // core on device, thread on host
+    uint16_t arg;           // 1 + plan layer index, 0 elsewhere
+} mlp_profile_record_t;
+
+// -----------------------------------------------------------------------------
+// receives the dump, in pieces
+typedef void (*mlp_profile_write_fn)(const void *data, uint32_t size, void *arg);
+
+#if CONFIG_MLP_PROFILE
+// -----------------------------------------------------------------------------
+static inline uint64_t mlp_profile_clock(void)
+{
+#ifdef ESP_PLATFORM
+    return esp_cpu_get_cycle_count();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+#define MLP_PROFILE_BEGIN(scope) uint64_t scope##_start = mlp_profile_clock()
+#define MLP_PROFILE_END(scope) mlp_profile_record((scope), 0, scope##_start, mlp_profile_clock())
+#define MLP_PROFILE_END_ARG(scope, arg) mlp_profile_record((scope), (arg), scope##_start, mlp_profile_clock())
+// closes MLP_PROFILE_BEGIN(name) but records scope, for stages only known
+// at runtime
+#define MLP_PROFILE_END_AS(name, scope, arg) mlp_profile_record((scope), (arg), name##_start, mlp_profile_clock())
+#else
+#define MLP_PROFILE_BEGIN(scope)
+#define MLP_PROFILE_END(scope)
+#define MLP_PROFILE_END_ARG(scope, arg) ((void)(arg))
+#define MLP_PROFILE_END_AS(name, scope, arg) ((void)(arg))
+#endif
+
+// -----------------------------------------------------------------------------
+// append a record (see MLP_PROFILE_BEGIN/END)
+void mlp_profile_record(mlp_scope_t scope, uint32_t arg, uint64_t start, uint64_t end);
+
+// -----------------------------------------------------------------------------
+// drop every record
+void mlp_profile_reset(void);
+
+// -----------------------------------------------------------------------------
+// write the header and the records to write(data, size, arg); records
+// appended while the dump runs may come out torn, so dump between inferences;
+// returns the number of records written
+uint32_t mlp_profile_dump(mlp_profile_write_fn write, void *arg);
+
+// -----------------------------------------------------------------------------
+// clock rate and the context of the caller (profile_cycles.c on device,
+// profile_tsc.c on the host)
+uint64_t mlp_profile_clock_hz(void);
+uint8_t mlp_profile_context(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
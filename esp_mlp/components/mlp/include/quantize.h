@@ -0,0 +1,27 @@
+#ifndef QUANTIZE_H_
+#define QUANTIZE_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// offline helpers for (multiplier, shift) pairs as used by the kernels:
+//   real = multiplier * 2^-31 * 2^-shift, multiplier in [2^30, 2^31)
+
+// -----------------------------------------------------------------------------
+// real value of a (multiplier, shift) pair
+double dequantize_multiplier(uint32_t multiplier, int32_t shift);
+
+// -----------------------------------------------------------------------------
+// (multiplier, shift) pair for 0 < real < 1; returns 0 on success, -1 if the
+// value needs a left shift the kernels don't support
+int quantize_multiplier(double real, uint32_t *multiplier, int32_t *shift);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
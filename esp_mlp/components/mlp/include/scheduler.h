@@ -0,0 +1,80 @@
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include "mlp.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// inference scheduler (CONFIG_MLP_SCHEDULER): a pool of workers, one per core
+// (pinned FreeRTOS tasks on the device, pthreads on the host), each with its
+// own request queue; submissions are spread round-robin and a worker whose
+// queue runs dry steals the oldest request of another one; every worker runs
+// whole inferences with mlp_model_forward over one shared model context
+
+#define MLP_SCHEDULER_MAX_WORKERS 4
+
+// -----------------------------------------------------------------------------
+// one inference; owned by the caller until done runs (on the worker) and
+// linked into the queues in place, so the scheduler never allocates
+typedef struct mlp_request
+{
+    const int8_t *inputs;       // INPUT_SIZE values, 16-byte aligned
+    int8_t *outputs;            // OUTPUT_SIZE softmax scores
+    void (*done)(struct mlp_request *request);
+    void *user;
+
+    // filled in by the scheduler
+    uint64_t submit_us;
+    uint64_t start_us;
+    uint64_t end_us;
+    uint32_t worker;
+    uint32_t stolen;
+    struct mlp_request *next;
+} mlp_request_t;
+
+// -----------------------------------------------------------------------------
+// counters since the last mlp_scheduler_start; throughput is
+// completed * 1e6 / elapsed_us, mean queueing latency queue_us / completed
+typedef struct
+{
+    uint32_t workers;
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t stolen;
+    uint32_t queued;            // waiting right now, over all queues
+    uint32_t max_queued;        // deepest any single queue got
+    uint64_t queue_us;          // sum of submit -> start
+    uint64_t max_queue_us;
+    uint64_t service_us;        // sum of start -> end
+    uint64_t elapsed_us;
+    uint32_t worker_completed[MLP_SCHEDULER_MAX_WORKERS];
+} mlp_scheduler_stats_t;
+
+// -----------------------------------------------------------------------------
+// start workers (1..MLP_SCHEDULER_MAX_WORKERS) over model, which must outlive
+// the scheduler; returns 0 on success, -1 if already running or a worker
+// can't be created
+int mlp_scheduler_start(const mlp_model_t *model, uint32_t workers);
+
+// -----------------------------------------------------------------------------
+// queue a request and return; any task may submit
+void mlp_scheduler_submit(mlp_request_t *request);
+
+// -----------------------------------------------------------------------------
+// run what is still queued, then stop and join the workers
+void mlp_scheduler_stop(void);
+
+// -----------------------------------------------------------------------------
+// snapshot of the counters
+void mlp_scheduler_stats(mlp_scheduler_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef SCHEDULER_OS_H_
+#define SCHEDULER_OS_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// OS backend of scheduler.c: FreeRTOS (scheduler_freertos.c) or pthreads
+// (scheduler_pthread.c); one lock and one wake-up signal per worker, indexed
+// 0..workers-1
+
+// -----------------------------------------------------------------------------
+// create the locks and signals, then one thread per worker running
+// loop(worker) (worker i on core i % cores where the OS can pin); returns 0
+// on success, -1 if a thread can't be created, in which case the ones
+// already running are stopped through their loops and scheduler_os_join as
+// usual
+int scheduler_os_start(uint32_t workers, void (*loop)(uint32_t worker));
+
+// -----------------------------------------------------------------------------
+// wait for every loop to return, then release what scheduler_os_start made
+void scheduler_os_join(void);
+
+// -----------------------------------------------------------------------------
+void scheduler_os_lock(uint32_t worker);
+void scheduler_os_unlock(uint32_t worker);
+
+// -----------------------------------------------------------------------------
+// counting wake-ups: a wake before the sleep is not lost
+void scheduler_os_wake(uint32_t worker);
+void scheduler_os_sleep(uint32_t worker);
+
+// -----------------------------------------------------------------------------
+// monotonic time in microseconds
+uint64_t scheduler_os_now_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
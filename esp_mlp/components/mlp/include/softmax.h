@@ -0,0 +1,36 @@
+#ifndef SOFTMAX_H_
+#define SOFTMAX_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// softmax parameters as prepared by TFLite/TFLM for an int8 softmax: the
+// input scale * beta multiplier (Q5.26 input differences) and the smallest
+// logit - max_logit difference that still contributes
+typedef struct
+{
+    int32_t input_multiplier;
+    int32_t input_left_shift;
+    int32_t diff_min;
+} softmax_params_t;
+
+// -----------------------------------------------------------------------------
+// softmax parameters for logits with the given scale and the model's beta;
+// returns 0 on success, -1 if input_scale * beta is out of range
+int softmax_prepare(double input_scale, double beta, softmax_params_t *params);
+
+// -----------------------------------------------------------------------------
+// int8 softmax over length logits (any length, inputs == outputs is fine);
+// outputs are probabilities with scale 1/256 and zero-point -128, bit-exact
+// with the TFLM kernel
+void softmax_int8(const int8_t *inputs, int8_t *outputs, uint32_t length, const softmax_params_t *params);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef STREAM_H_
+#define STREAM_H_
+
+#include "mlp.h"
+#include "stream_io.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// weight streaming (CONFIG_MLP_STREAM): a model container (container.h) whose
+// kernels read their weights from internal RAM in bounded pieces; the small
+// tensors are read once into RAM, the two weight matrices tile by tile on
+// every pass into two tile_size-byte RAM buffers, the loader (stream_io.h)
+// filling one while the kernel runs on the other, so the RAM cost is
+// 2 * tile_size plus the small tensors whatever the model size; on device the
+// loader copies out of the mapped partition, so its reads still go through
+// the flash cache, but with the cache on the kernel keeps running meanwhile
+//
+// a tile holds whole weight rows (output channels) of one layer; the first
+// tile of the next pass loads as soon as the last one of this pass is in, so
+// it overlaps the softmax and whatever the caller does between passes
+//
+// the hidden layer always runs the dense kernel (no input-sparse path, and
+// none of the compressed variants) with ReLU; the plan executor isn't
+// supported, so containers with another hidden activation are rejected
+
+typedef struct
+{
+    mlp_model_t model;          // resident tensors; the weight pointers are NULL
+    stream_io_t *io;
+    uint8_t *resident;          // the resident tensors' copy
+    uint32_t resident_size;
+    int8_t *tiles[2];
+    uint32_t tile_size;
+    uint32_t hidden_offset;     // of the weight matrices in the source
+    uint32_t output_offset;
+    uint32_t hidden_rows;       // per tile
+    uint32_t output_rows;
+    uint32_t hidden_tiles;
+    uint32_t output_tiles;
+    uint32_t next;              // tile buffer the first tile of the next pass loads into
+} mlp_stream_t;
+
+// -----------------------------------------------------------------------------
+// open name (a data partition label on device, a file path on the host),
+// check the container as mlp_model_load does (the data CRC streamed through
+// a tile), read the resident tensors and start loading the first tile;
+// tile_size must hold a row of each weight matrix (INPUT_SIZE bytes); returns
+// 0 on success, -1 if the source can't be read, the container is rejected or
+// the buffers can't be allocated
+int mlp_stream_open(mlp_stream_t *stream, const char *name, uint32_t tile_size);
+
+// -----------------------------------------------------------------------------
+// forward pass as mlp_model_forward with the weights streamed; one pass at a
+// time per stream; returns 0, or -1 if a read failed (outputs undefined)
+int mlp_stream_forward(mlp_stream_t *stream, const int8_t *inputs, int8_t *outputs);
+
+// -----------------------------------------------------------------------------
+// stop the loader and free the buffers
+void mlp_stream_close(mlp_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef STREAM_IO_H_
+#define STREAM_IO_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// I/O backend of stream.c: copies out of a mapped data partition on a loader
+// task on device (stream_io_partition.c, esp_partition_mmap), reads a file on
+// a loader thread on the host (stream_io_file.c, pread); one read in flight
+// per source
+typedef struct stream_io stream_io_t;
+
+// -----------------------------------------------------------------------------
+// open name (partition label / file path) and start its loader; returns NULL
+// if it can't be opened, else the source with its size in *size
+stream_io_t *stream_io_open(const char *name, uint32_t *size);
+
+// -----------------------------------------------------------------------------
+// stop the loader and close the source; no read may be in flight
+void stream_io_close(stream_io_t *io);
+
+// -----------------------------------------------------------------------------
+// read size (> 0) bytes at offset into data on the loader and return at once;
+// stream_io_wait collects the result
+void stream_io_start(stream_io_t *io, uint32_t offset, void *data, uint32_t size);
+
+// -----------------------------------------------------------------------------
+// block until the read started last is done; returns 0, or -1 if it failed
+int stream_io_wait(stream_io_t *io);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
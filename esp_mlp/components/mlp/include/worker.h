@@ -0,0 +1,26 @@
+#ifndef WORKER_H_
+#define WORKER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// second-core worker for CONFIG_MLP_DUAL_CORE: a FreeRTOS task pinned to
+// CONFIG_MLP_WORKER_CORE on the device (worker_freertos.c), a pthread on the
+// host (worker_pthread.c); created on first use, one job in flight at a time
+typedef void (*mlp_worker_fn)(void *arg);
+
+// -----------------------------------------------------------------------------
+// start fn(arg) on the worker; aborts if the worker can't be created
+void mlp_worker_run(mlp_worker_fn fn, void *arg);
+
+// -----------------------------------------------------------------------------
+// block until the job started by the last mlp_worker_run returns
+void mlp_worker_join(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,659 @@
+#include "mlp.h"
+#include "dense.h"
+#if CONFIG_MLP_STATIC_KERNELS
+#include "dense_static.h"
+#endif
+#include "mlp_config.h"
+#include "params.h"
+#include "params_folded.h"
+#include "plan.h"
+#include "profile.h"
+#if CONFIG_MLP_HIDDEN_COLUMN_MAJOR
+#include "params_colmajor.h"
+#endif
+#if CONFIG_MLP_PACKED_WEIGHTS
+#include "params_packed.h"
+#endif
+#if CONFIG_MLP_HIDDEN_INT4
+#include "params_int4.h"
+#endif
+#if CONFIG_MLP_HIDDEN_BLOCK_SPARSE
+#include "params_block_sparse.h"
+#endif
+#if CONFIG_MLP_HIDDEN_CODEBOOK
+#include "params_codebook.h"
+#endif
+#include "softmax.h"
+#if CONFIG_MLP_DUAL_CORE
+#include "worker.h"
+#endif
+
+#include <stddef.h>
+
+// without a plan the hidden activation is ReLU; the plan carries the others
+// (see gen_params.py), which mlp_model_init then takes into the model context
+#if defined(HIDDEN_ACTIVATION_OFFSET) && !CONFIG_MLP_PLAN_EXECUTOR
+#error "the hidden activation of this model needs CONFIG_MLP_PLAN_EXECUTOR"
+#endif
+
+// -----------------------------------------------------------------------------
+// the row-major hidden layer runs sparse when fewer than
+// CONFIG_MLP_SPARSE_DENSITY_THRESHOLD percent of the inputs differ from the
+// input zero-point; the column-major one always runs sparse, the int4,
+// block-sparse and codebook ones never do
+static inline mlp_path_t select_path(uint32_t count)
+{
+#if CONFIG_MLP_HIDDEN_INT4 || CONFIG_MLP_HIDDEN_BLOCK_SPARSE || CONFIG_MLP_HIDDEN_CODEBOOK
+    (void)count;
+    return MLP_PATH_DENSE;
+#elif CONFIG_MLP_HIDDEN_COLUMN_MAJOR
+    (void)count;
+    return MLP_PATH_SPARSE;
+#else
+    return (count * 100 < CONFIG_MLP_SPARSE_DENSITY_THRESHOLD * INPUT_SIZE) ? MLP_PATH_SPARSE : MLP_PATH_DENSE;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+mlp_path_t forward_pass_path(const int8_t *inputs)
+{
+    int8_t input_zp = (int8_t)g_params[INPUT_ZP_OFFSET];
+    uint32_t count = 0;
+    for (uint32_t ic = 0; ic < INPUT_SIZE; ++ic)
+    {
+        count += (inputs[ic] != input_zp) ? 1 : 0;
+    }
+    return select_path(count);
+}
+
+// -----------------------------------------------------------------------------
+// weight zero-points, or NULL when they are all zero (the kernels skip the
+// correction then)
+static const int8_t *weight_zps_or_null(const uint8_t *params, uint32_t offset, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        if (params[offset + i] != 0)
+        {
+            return (const int8_t *)&params[offset];
+        }
+    }
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+// the tables of a params blob, unchecked
+static void resolve_model(mlp_model_t *model, const uint8_t *params)
+{
+    model->params = params;
+    model->hidden_weights = (const int8_t *)&params[HIDDEN_WEIGHT_OFFSET];
+    model->hidden_weight_zps = weight_zps_or_null(params, HIDDEN_WEIGHT_ZP_OFFSET, HIDDEN_SIZE);
+    model->hidden_biases = (const int32_t *)&params[HIDDEN_BIAS_OFFSET];
+    model->hidden_folded_biases = (const int32_t *)&params[HIDDEN_FOLDED_BIAS_OFFSET];
+    model->hidden_multipliers = (const uint32_t *)&params[LAYER1_MULTIPLIER_OFFSET];
+    model->hidden_shifts = (const int32_t *)&params[LAYER1_SCALE_OFFSET];
+    model->output_weights = (const int8_t *)&params[OUTPUT_WEIGHT_OFFSET];
+    model->output_weight_zps = weight_zps_or_null(params, OUTPUT_WEIGHT_ZP_OFFSET, OUTPUT_SIZE);
+    model->output_folded_biases = (const int32_t *)&params[OUTPUT_FOLDED_BIAS_OFFSET];
+    model->output_multipliers = (const uint32_t *)&params[LAYER2_MULTIPLIER_OFFSET];
+    model->output_shifts = (const int32_t *)&params[LAYER2_SCALE_OFFSET];
+    model->output_weight_sums = (params == g_params) ? g_output_weight_sums : NULL;
+    model->output_weight_norms = (params == g_params) ? g_output_weight_norms : NULL;
+    model->softmax = (const softmax_params_t *)&params[SOFTMAX_PARAMS_OFFSET];
+    model->plan = CONFIG_MLP_PLAN_EXECUTOR ? (const mlp_plan_t *)&params[PLAN_OFFSET] : NULL;
+    model->input_zp = (int8_t)params[INPUT_ZP_OFFSET];
+    model->hidden_zp = (int8_t)params[HIDDEN_ZP_OFFSET];
+    model->output_zp = (int8_t)params[OUTPUT_ZP_OFFSET];
+    model->hidden_epilogue.min = model->hidden_zp;
+    model->hidden_epilogue.max = INT8_MAX;
+    model->hidden_epilogue.lut = NULL;
+}
+
+// -----------------------------------------------------------------------------
+int mlp_model_init(mlp_model_t *model, const uint8_t *params, uint32_t params_size)
+{
+    if (params_size < PARAMS_SIZE)
+    {
+        return -1;
+    }
+
+    resolve_model(model, params);
+
+#if CONFIG_MLP_PLAN_EXECUTOR
+    // the top-k, batched and delta passes run the built-in sequence over
+    // INPUT_SIZE/OUTPUT_SIZE buffers, whatever the plan says
+    model->plan = mlp_plan_get(params, params_size, PLAN_OFFSET, PLAN_ARENA_SIZE);
+    if (model->plan == NULL || model->plan->input_size != INPUT_SIZE || model->plan->output_size != OUTPUT_SIZE)
+    {
+        return -1;
+    }
+    mlp_plan_epilogue(model->plan, params, 0, &model->hidden_epilogue);
+#endif
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// the built-in model, resolved per call (a few dozen loads next to the
+// forward pass) so forward_pass keeps no state; g_params is compiled in and
+// its plan checked by mlp_model_init in "mlp_bench --check", so nothing is
+// validated here
+static void default_model(mlp_model_t *model)
+{
+    resolve_model(model, g_params);
+#if CONFIG_MLP_PLAN_EXECUTOR
+    mlp_plan_epilogue(model->plan, g_params, 0, &model->hidden_epilogue);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// the int8 row-major and column-major hidden layers gather the non-zero inputs
+// once per forward pass, the other variants read the inputs directly
+#define HIDDEN_GATHERS (!CONFIG_MLP_HIDDEN_INT4 && !CONFIG_MLP_HIDDEN_BLOCK_SPARSE && !CONFIG_MLP_HIDDEN_CODEBOOK)
+
+// -----------------------------------------------------------------------------
+// hidden layer work shared by every range of output channels
+typedef struct
+{
+    const mlp_model_t *model;
+    const int8_t *inputs;
+    int8_t *hiddens;
+#if HIDDEN_GATHERS
+    uint16_t indices[INPUT_SIZE];
+    int16_t values[INPUT_SIZE];
+    uint32_t count;
+#endif
+} hidden_job_t;
+
+// -----------------------------------------------------------------------------
+static void hidden_prepare(hidden_job_t *job, const mlp_model_t *model, const int8_t *inputs, int8_t *hiddens)
+{
+    job->model = model;
+    job->inputs = inputs;
+    job->hiddens = hiddens;
+#if HIDDEN_GATHERS
+    job->count = dense_gather_nonzero(inputs, model->input_zp, job->indices, job->values, INPUT_SIZE);
+#endif
+}
+
+#if CONFIG_MLP_HIDDEN_INT4
+// -----------------------------------------------------------------------------
+// hidden output channels [first, first + size) (dense+activation) over the int4
+// weights in params_int4.h
+static void hidden_channels(const hidden_job_t *job, uint32_t first, uint32_t size)
+{
+    int8_t hidden_zp = job->model->hidden_zp;
+    const dense_epilogue_t *epilogue = &job->model->hidden_epilogue;
+
+    dense_int8_int4w_fused(
+        job->inputs,
+        &g_hidden_weights_int4[first * DENSE_INT4_ROW_SIZE(INPUT_SIZE)],
+        &g_hidden_int4_folded_biases[first],
+        &job->hiddens[first],
+        hidden_zp,
+        &g_hidden_int4_multipliers[first],
+        &g_hidden_int4_shifts[first],
+        epilogue,
+        INPUT_SIZE,
+        size);
+}
+#elif CONFIG_MLP_HIDDEN_BLOCK_SPARSE
+// -----------------------------------------------------------------------------
+// hidden output channels [first, first + size) (dense+activation) over the pruned
+// weights in params_block_sparse.h; row_ptr holds absolute block indices, so
+// only it moves
+static void hidden_channels(const hidden_job_t *job, uint32_t first, uint32_t size)
+{
+    const mlp_model_t *model = job->model;
+    const dense_epilogue_t *epilogue = &model->hidden_epilogue;
+
+    dense_int8_block_sparse_fused(
+        job->inputs,
+        &g_hidden_block_sparse_row_ptr[first],
+        g_hidden_block_sparse_cols,
+        g_hidden_block_sparse_values,
+        &g_hidden_block_sparse_folded_biases[first],
+        &job->hiddens[first],
+        model->hidden_zp,
+        &model->hidden_multipliers[first],
+        &model->hidden_shifts[first],
+        epilogue,
+        INPUT_SIZE,
+        size);
+}
+#elif CONFIG_MLP_HIDDEN_CODEBOOK
+// -----------------------------------------------------------------------------
+// hidden output channels [first, first + size) (dense+activation) over the clustered
+// weights in params_codebook.h
+static void hidden_channels(const hidden_job_t *job, uint32_t first, uint32_t size)
+{
+    const mlp_model_t *model = job->model;
+    const dense_epilogue_t *epilogue = &model->hidden_epilogue;
+
+    dense_int8_codebook_fused(
+        job->inputs,
+        &g_hidden_codebook_indices[first * DENSE_CODEBOOK_ROW_SIZE(INPUT_SIZE, HIDDEN_CODEBOOK_CENTROIDS)],
+        &g_hidden_codebook_centroids[first * HIDDEN_CODEBOOK_CENTROIDS],
+        HIDDEN_CODEBOOK_CENTROIDS,
+        &g_hidden_codebook_folded_biases[first],
+        &job->hiddens[first],
+        model->hidden_zp,
+        &model->hidden_multipliers[first],
+        &model->hidden_shifts[first],
+        epilogue,
+        INPUT_SIZE,
+        size);
+}
+#elif CONFIG_MLP_HIDDEN_COLUMN_MAJOR
+// -----------------------------------------------------------------------------
+// hidden layer (dense+activation), column-major and input-sparse; the column walk
+// covers every output channel, so there's no channel range
+static void hidden_channels(const hidden_job_t *job, uint32_t first, uint32_t size)
+{
+    int32_t accumulators[HIDDEN_SIZE];
+    const mlp_model_t *model = job->model;
+    const dense_epilogue_t *epilogue = &model->hidden_epilogue;
+
+    (void)first;
+    (void)size;
+    dense_int8_sparse_colmajor_fused(
+        job->indices,
+        job->values,
+        job->count,
+        g_hidden_weights_colmajor,
+        model->hidden_weight_zps,
+        model->hidden_biases,
+        accumulators,
+        job->hiddens,
+        model->hidden_zp,
+        model->hidden_multipliers,
+        model->hidden_shifts,
+        epilogue,
+        HIDDEN_SIZE);
+}
+#else
+// -----------------------------------------------------------------------------
+// hidden output channels [first, first + size) (dense+activation), dense or
+// input-sparse depending on the input density; with CONFIG_MLP_PACKED_WEIGHTS
+// first must be a multiple of DENSE_PACK_BLOCK
+static void hidden_channels(const hidden_job_t *job, uint32_t first, uint32_t size)
+{
+    const mlp_model_t *model = job->model;
+    const int8_t *hidden_weights = &model->hidden_weights[first * INPUT_SIZE];
+    const int8_t *hidden_weight_zps = (model->hidden_weight_zps != NULL) ? &model->hidden_weight_zps[first] : NULL;
+    const int32_t *hidden_folded_biases = &model->hidden_folded_biases[first];
+    const uint32_t *hidden_multipliers = &model->hidden_multipliers[first];
+    const int32_t *hidden_shifts = &model->hidden_shifts[first];
+    int8_t hidden_zp = model->hidden_zp;
+    int8_t *hiddens = &job->hiddens[first];
+    const dense_epilogue_t *epilogue = &model->hidden_epilogue;
+
+    if (select_path(job->count) == MLP_PATH_SPARSE)
+    {
+        dense_int8_sparse_fused(
+            job->indices,
+            job->values,
+            job->count,
+            hidden_weights,
+            hidden_weight_zps,
+            &model->hidden_biases[first],
+            hiddens,
+            hidden_zp,
+            hidden_multipliers,
+            hidden_shifts,
+            epilogue,
+            INPUT_SIZE,
+            size);
+    }
+    else
+    {
+#if CONFIG_MLP_PACKED_WEIGHTS
+        (void)hidden_weights;
+        dense_int8_packed_fused(
+            job->inputs,
+            &g_hidden_weights_packed[first * INPUT_SIZE],
+            hidden_weight_zps,
+            hidden_folded_biases,
+            hiddens,
+            hidden_zp,
+            hidden_multipliers,
+            hidden_shifts,
+            epilogue,
+            INPUT_SIZE,
+            size);
+#elif CONFIG_MLP_STATIC_KERNELS
+        (void)size;
+        dense_static_hidden(
+            job->inputs,
+            hidden_weights,
+            hidden_weight_zps,
+            hidden_folded_biases,
+            hiddens,
+            hidden_zp,
+            hidden_multipliers,
+            hidden_shifts,
+            epilogue);
+#elif DENSE_SIMD_PIE
+        dense_int8_simd_fused(
+            job->inputs,
+            hidden_weights,
+            hidden_weight_zps,
+            hidden_folded_biases,
+            hiddens,
+            hidden_zp,
+            hidden_multipliers,
+            hidden_shifts,
+            epilogue,
+            INPUT_SIZE,
+            size);
+#else
+        dense_int8_fused(
+            job->inputs,
+            hidden_weights,
+            hidden_weight_zps,
+            hidden_folded_biases,
+            hiddens,
+            hidden_zp,
+            hidden_multipliers,
+            hidden_shifts,
+            epilogue,
+            INPUT_SIZE,
+            size);
+#endif
+    }
+}
+#endif
+
+#if CONFIG_MLP_DUAL_CORE
+// -----------------------------------------------------------------------------
+// the worker core takes the upper half of the hidden output channels, split on
+// a DENSE_PACK_BLOCK boundary so the packed weights stay whole blocks
+#define HIDDEN_SPLIT ((HIDDEN_SIZE / 2) / DENSE_PACK_BLOCK * DENSE_PACK_BLOCK)
+
+#if CONFIG_MLP_HIDDEN_COLUMN_MAJOR
+#error "CONFIG_MLP_DUAL_CORE needs a row-major hidden layer"
+#endif
+
+#if CONFIG_MLP_STATIC_KERNELS
+#error "CONFIG_MLP_DUAL_CORE splits the hidden layer at runtime, CONFIG_MLP_STATIC_KERNELS needs it whole"
+#endif
+
+// -----------------------------------------------------------------------------
+static void hidden_worker(void *arg)
+{
+    hidden_channels((const hidden_job_t *)arg, HIDDEN_SPLIT, HIDDEN_SIZE - HIDDEN_SPLIT);
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// hidden layer (dense+activation): input -> hidden; with CONFIG_MLP_DUAL_CORE the
+// worker (see worker.h) runs the upper half of the output channels while the
+// caller runs the lower half, both reading the same gathered inputs
+static void hidden_layer(const mlp_model_t *model, const int8_t *inputs, int8_t *hiddens)
+{
+    hidden_job_t job;
+    hidden_prepare(&job, model, inputs, hiddens);
+
+#if CONFIG_MLP_DUAL_CORE
+    mlp_worker_run(hidden_worker, &job);
+    hidden_channels(&job, 0, HIDDEN_SPLIT);
+    mlp_worker_join();
+#else
+    hidden_channels(&job, 0, HIDDEN_SIZE);
+#endif
+}
+
+#if CONFIG_MLP_PLAN_EXECUTOR
+// -----------------------------------------------------------------------------
+// forward pass over the execution plan in the model's params blob (validated
+// by mlp_model_init)
+void mlp_model_forward(const mlp_model_t *model, const int8_t *inputs, int8_t *outputs)
+{
+    int8_t arena[PLAN_ARENA_SIZE] __attribute__((aligned(16)));
+
+    MLP_PROFILE_BEGIN(MLP_SCOPE_FORWARD);
+    mlp_plan_run(model->plan, model->params, arena, inputs, outputs);
+    MLP_PROFILE_END(MLP_SCOPE_FORWARD);
+}
+#else
+// -----------------------------------------------------------------------------
+// output layer (dense, no activation): hidden -> logits
+static void output_layer(const mlp_model_t *model, const int8_t *hiddens, int8_t *logits)
+{
+#if CONFIG_MLP_PACKED_WEIGHTS
+    dense_int8_packed(
+        hiddens,
+        g_output_weights_packed,
+        model->output_weight_zps,
+        model->output_folded_biases,
+        logits,
+        model->output_zp,
+        model->output_multipliers,
+        model->output_shifts,
+        HIDDEN_SIZE,
+        OUTPUT_SIZE);
+#elif CONFIG_MLP_STATIC_KERNELS
+    dense_static_output(
+        hiddens,
+        model->output_weights,
+        model->output_weight_zps,
+        model->output_folded_biases,
+        logits,
+        model->output_zp,
+        model->output_multipliers,
+        model->output_shifts);
+#elif DENSE_SIMD_PIE
+    dense_int8_simd(
+        hiddens,
+        model->output_weights,
+        model->output_weight_zps,
+        model->output_folded_biases,
+        logits,
+        model->output_zp,
+        model->output_multipliers,
+        model->output_shifts,
+        HIDDEN_SIZE,
+        OUTPUT_SIZE);
+#else
+    dense_int8_folded(
+        hiddens,
+        model->output_weights,
+        model->output_weight_zps,
+        model->output_folded_biases,
+        logits,
+        model->output_zp,
+        model->output_multipliers,
+        model->output_shifts,
+        HIDDEN_SIZE,
+        OUTPUT_SIZE);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// forward pass:
+//   1) dense+ReLU
+//   2) dense
+//   3) softmax
+// zero-points are folded into the biases offline (see dense_fold_zero_points);
+// with CONFIG_MLP_PACKED_WEIGHTS the dense kernels read the repacked weights
+// in params_packed.h, otherwise the ESP32-S3 uses its PIE SIMD backend
+void mlp_model_forward(const mlp_model_t *model, const int8_t *inputs, int8_t *outputs)
+{
+    int8_t hiddens[HIDDEN_SIZE] __attribute__((aligned(16)));
+
+    MLP_PROFILE_BEGIN(MLP_SCOPE_FORWARD);
+
+    // 1) dense+ReLU: input -> hidden
+    MLP_PROFILE_BEGIN(MLP_SCOPE_DENSE1);
+    hidden_layer(model, inputs, hiddens);
+    MLP_PROFILE_END(MLP_SCOPE_DENSE1);
+
+    // 2) dense (no activation) for final logits
+    MLP_PROFILE_BEGIN(MLP_SCOPE_DENSE2);
+    output_layer(model, hiddens, outputs);
+    MLP_PROFILE_END(MLP_SCOPE_DENSE2);
+
+    // 3) in-place quantized softmax
+    MLP_PROFILE_BEGIN(MLP_SCOPE_SOFTMAX);
+    softmax_int8(outputs, outputs, OUTPUT_SIZE, model->softmax);
+    MLP_PROFILE_END(MLP_SCOPE_SOFTMAX);
+
+    MLP_PROFILE_END(MLP_SCOPE_FORWARD);
+}
+#endif
+
+// -----------------------------------------------------------------------------
+void forward_pass(const int8_t *inputs, int8_t *outputs)
+{
+    mlp_model_t model;
+    default_model(&model);
+    mlp_model_forward(&model, inputs, outputs);
+}
+
+// -----------------------------------------------------------------------------
+// top-k forward pass: the hidden layer as in mlp_model_forward, then the
+// output layer through dense_int8_topk and no softmax; always the built-in
+// sequence, also with CONFIG_MLP_PLAN_EXECUTOR
+uint32_t mlp_model_topk(
+    const mlp_model_t *model,
+    const int8_t *inputs,
+    uint32_t k,
+    int early_stop,
+    uint32_t *classes,
+    int8_t *logits)
+{
+    int8_t hiddens[HIDDEN_SIZE] __attribute__((aligned(16)));
+    int8_t outputs[OUTPUT_SIZE];
+    int32_t scratch[DENSE_TOPK_SCRATCH_SIZE(OUTPUT_SIZE)];
+
+    k = (k > OUTPUT_SIZE) ? OUTPUT_SIZE : k;
+    if (k == 0)
+    {
+        return 0;
+    }
+
+    // without bounds every row runs to the end (dense_int8_topk reads none)
+    if (model->output_weight_sums == NULL || model->output_weight_norms == NULL)
+    {
+        early_stop = 0;
+    }
+
+    // 1) dense+activation: input -> hidden
+    hidden_layer(model, inputs, hiddens);
+
+    // 2) dense (no activation) for the logits that can still make the top k;
+    // without early stop every row runs to the end
+    dense_int8_topk(
+        hiddens,
+        model->output_weights,
+        model->output_weight_zps,
+        model->output_folded_biases,
+        model->output_weight_sums,
+        model->output_weight_norms,
+        scratch,
+        outputs,
+        model->output_zp,
+        model->output_multipliers,
+        model->output_shifts,
+        early_stop ? k : OUTPUT_SIZE,
+        (!early_stop || k > 1 || logits != NULL),
+        HIDDEN_SIZE,
+        OUTPUT_SIZE);
+
+    // 3) selection, ties to the lower class index
+    for (uint32_t i = 0; i < k; ++i)
+    {
+        uint32_t best = OUTPUT_SIZE;
+        for (uint32_t oc = 0; oc < OUTPUT_SIZE; ++oc)
+        {
+            int taken = 0;
+            for (uint32_t j = 0; j < i; ++j)
+            {
+                taken |= (classes[j] == oc);
+            }
+            if (!taken && (best == OUTPUT_SIZE || outputs[oc] > outputs[best]))
+            {
+                best = oc;
+            }
+        }
+        classes[i] = best;
+        if (logits != NULL)
+        {
+            logits[i] = outputs[best];
+        }
+    }
+
+    return k;
+}
+
+// -----------------------------------------------------------------------------
+uint32_t forward_pass_topk(const int8_t *inputs, uint32_t k, int early_stop, uint32_t *classes, int8_t *logits)
+{
+    mlp_model_t model;
+    default_model(&model);
+    return mlp_model_topk(&model, inputs, k, early_stop, classes, logits);
+}
+
+// -----------------------------------------------------------------------------
+// batched forward pass: same layers as mlp_model_forward, but each layer runs
+// over CONFIG_MLP_BATCH_SIZE inputs per sweep of its weights
+void mlp_model_forward_batch(const mlp_model_t *model, const int8_t *inputs, int8_t *outputs, uint32_t count)
+{
+    int8_t hiddens[CONFIG_MLP_BATCH_SIZE * HIDDEN_SIZE];
+    const dense_epilogue_t *epilogue = &model->hidden_epilogue;
+
+    for (uint32_t first = 0; first < count; first += CONFIG_MLP_BATCH_SIZE)
+    {
+        uint32_t batch = count - first;
+        if (batch > CONFIG_MLP_BATCH_SIZE)
+        {
+            batch = CONFIG_MLP_BATCH_SIZE;
+        }
+
+        int8_t *batch_outputs = &outputs[first * OUTPUT_SIZE];
+
+        // 1) dense+activation: input -> hidden
+        dense_int8_batch_fused(
+            &inputs[first * INPUT_SIZE],
+            batch,
+            model->hidden_weights,
+            model->hidden_weight_zps,
+            model->hidden_folded_biases,
+            hiddens,
+            model->hidden_zp,
+            model->hidden_multipliers,
+            model->hidden_shifts,
+            epilogue,
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+
+        // 2) dense (no activation) for final logits
+        dense_int8_batch(
+            hiddens,
+            batch,
+            model->output_weights,
+            model->output_weight_zps,
+            model->output_folded_biases,
+            batch_outputs,
+            model->output_zp,
+            model->output_multipliers,
+            model->output_shifts,
+            HIDDEN_SIZE,
+            OUTPUT_SIZE);
+
+        // 3) in-place quantized softmax, per input
+        for (uint32_t b = 0; b < batch; ++b)
+        {
+            int8_t *logits = &batch_outputs[b * OUTPUT_SIZE];
+            softmax_int8(logits, logits, OUTPUT_SIZE, model->softmax);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void forward_pass_batch(const int8_t *inputs, int8_t *outputs, uint32_t count)
+{
+    mlp_model_t model;
+    default_model(&model);
+    mlp_model_forward_batch(&model, inputs, outputs, count);
+}
@@ -1,6 +1,29 @@
+// generated by gen_params.py from model.tflite; do not edit
+
 #include "params.h"
 
-const uint8_t g_params[] = {
+// -----------------------------------------------------------------------------
+// the int32_t/uint32_t tables are read in place, so they must be word-aligned
+_Static_assert(PARAMS_ALIGN % 4 == 0, "PARAMS_ALIGN must be a multiple of 4");
+_Static_assert(HIDDEN_WEIGHT_OFFSET % PARAMS_ALIGN == 0, "HIDDEN_WEIGHT_OFFSET is misaligned");
+_Static_assert(HIDDEN_BIAS_OFFSET % PARAMS_ALIGN == 0, "HIDDEN_BIAS_OFFSET is misaligned");
+_Static_assert(OUTPUT_WEIGHT_OFFSET % PARAMS_ALIGN == 0, "OUTPUT_WEIGHT_OFFSET is misaligned");
+_Static_assert(OUTPUT_BIAS_OFFSET % PARAMS_ALIGN == 0, "OUTPUT_BIAS_OFFSET is misaligned");
+_Static_assert(INPUT_ZP_OFFSET % PARAMS_ALIGN == 0, "INPUT_ZP_OFFSET is misaligned");
+_Static_assert(HIDDEN_ZP_OFFSET % PARAMS_ALIGN == 0, "HIDDEN_ZP_OFFSET is misaligned");
+_Static_assert(HIDDEN_WEIGHT_ZP_OFFSET % PARAMS_ALIGN == 0, "HIDDEN_WEIGHT_ZP_OFFSET is misaligned");
+_Static_assert(LAYER1_MULTIPLIER_OFFSET % PARAMS_ALIGN == 0, "LAYER1_MULTIPLIER_OFFSET is misaligned");
+_Static_assert(LAYER1_SCALE_OFFSET % PARAMS_ALIGN == 0, "LAYER1_SCALE_OFFSET is misaligned");
+_Static_assert(OUTPUT_ZP_OFFSET % PARAMS_ALIGN == 0, "OUTPUT_ZP_OFFSET is misaligned");
+_Static_assert(OUTPUT_WEIGHT_ZP_OFFSET % PARAMS_ALIGN == 0, "OUTPUT_WEIGHT_ZP_OFFSET is misaligned");
+_Static_assert(LAYER2_MULTIPLIER_OFFSET % PARAMS_ALIGN == 0, "LAYER2_MULTIPLIER_OFFSET is misaligned");
+_Static_assert(LAYER2_SCALE_OFFSET % PARAMS_ALIGN == 0, "LAYER2_SCALE_OFFSET is misaligned");
+_Static_assert(PLAN_OFFSET % PARAMS_ALIGN == 0, "PLAN_OFFSET is misaligned");
+_Static_assert(HIDDEN_FOLDED_BIAS_OFFSET % PARAMS_ALIGN == 0, "HIDDEN_FOLDED_BIAS_OFFSET is misaligned");
+_Static_assert(OUTPUT_FOLDED_BIAS_OFFSET % PARAMS_ALIGN == 0, "OUTPUT_FOLDED_BIAS_OFFSET is misaligned");
+_Static_assert(SOFTMAX_PARAMS_OFFSET % PARAMS_ALIGN == 0, "SOFTMAX_PARAMS_OFFSET is misaligned");
+
+const uint8_t g_params[PARAMS_SIZE] __attribute__((aligned(PARAMS_ALIGN))) = {
     0x10, 0x03, 0x0a, 0xed, 0xe7, 0xfe, 0xfb, 0x0f, 0x16, 0x15, 0x0b, 0xe9,
     0x0d, 0x22, 0x15, 0x04, 0x06, 0x19, 0x10, 0x13, 0x17, 0x18, 0x10, 0x09,
     0xfd, 0xfa, 0x09, 0xf1, 0x05, 0x0a, 0xea, 0xe7, 0xee, 0x08, 0x0a, 0x06,
@@ -8516,7 +8539,10 @@ const uint8_t g_params[] = {
     0x74, 0xfe, 0xff, 0xff, 0x17, 0x00, 0x00, 0x00, 0xe8, 0xff, 0xff, 0xff,
     0x9a, 0xfe, 0xff, 0xff, 0x5e, 0x00, 0x00, 0x00, 0x49, 0x01, 0x00, 0x00,
     0x16, 0x00, 0x00, 0x00, 0xd8, 0xff, 0xff, 0xff, 0xe4, 0x00, 0x00, 0x00,
-    0xf0, 0xff, 0xff, 0xff, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xf0, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
@@ -8612,12 +8638,73 @@ const uint8_t g_params[] = {
     0x0b, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00,
     0x0b, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00,
     0x0b, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00,
-    0x0b, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x80, 0x13, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x74, 0x7b, 0x86, 0x50,
-    0xa9, 0x9a, 0x80, 0x5c, 0xc6, 0x10, 0x36, 0x58, 0x6d, 0x88, 0x2e, 0x5b,
-    0xcf, 0x01, 0x59, 0x58, 0xfb, 0xd2, 0x5f, 0x58, 0x36, 0x2b, 0x45, 0x48,
-    0xc0, 0x39, 0x92, 0x55, 0x22, 0x3e, 0x19, 0x47, 0x29, 0xbc, 0x2b, 0x4f,
-    0x09, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00,
+    0x0b, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x74, 0x7b, 0x86, 0x50, 0xa9, 0x9a, 0x80, 0x5c,
+    0xc6, 0x10, 0x36, 0x58, 0x6d, 0x88, 0x2e, 0x5b, 0xcf, 0x01, 0x59, 0x58,
+    0xfb, 0xd2, 0x5f, 0x58, 0x36, 0x2b, 0x45, 0x48, 0xc0, 0x39, 0x92, 0x55,
+    0x22, 0x3e, 0x19, 0x47, 0x29, 0xbc, 0x2b, 0x4f, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00,
     0x09, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00,
     0x09, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00,
-    0x09, 0x00, 0x00, 0x00};
+    0x09, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x50, 0x4c, 0x41, 0x4e, 0x03, 0x00, 0x03, 0x00,
+    0x10, 0x03, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00,
+    0x01, 0x01, 0x80, 0x80, 0x10, 0x03, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xd0, 0x94, 0x01, 0x00,
+    0xd0, 0x8f, 0x01, 0x00, 0xd0, 0x91, 0x01, 0x00, 0xff, 0xff, 0xff, 0xff,
+    0x01, 0x00, 0x80, 0x13, 0x80, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00,
+    0x00, 0x8a, 0x01, 0x00, 0xff, 0xff, 0xff, 0xff, 0xd0, 0x96, 0x01, 0x00,
+    0xf0, 0x93, 0x01, 0x00, 0x20, 0x94, 0x01, 0x00, 0xff, 0xff, 0xff, 0xff,
+    0x02, 0x00, 0x13, 0x13, 0x0a, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x97, 0x01, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xa1, 0xf2, 0x03, 0x00, 0x3b, 0xbb, 0x04, 0x00, 0x43, 0x28, 0x08, 0x00,
+    0xa8, 0xf4, 0x03, 0x00, 0xec, 0xcf, 0x08, 0x00, 0x77, 0xc1, 0xf5, 0xff,
+    0xf6, 0x6b, 0xf1, 0xff, 0x58, 0x4e, 0xfb, 0xff, 0x4b, 0x65, 0x02, 0x00,
+    0x7d, 0xeb, 0x01, 0x00, 0xb2, 0xed, 0x02, 0x00, 0x4e, 0xc7, 0xfe, 0xff,
+    0xe8, 0x13, 0xf4, 0xff, 0x86, 0x81, 0x08, 0x00, 0x01, 0xef, 0xfc, 0xff,
+    0xa2, 0x26, 0xfc, 0xff, 0xf0, 0x9e, 0x00, 0x00, 0x50, 0xe0, 0xfe, 0xff,
+    0xe4, 0x85, 0x08, 0x00, 0x66, 0xf5, 0xfa, 0xff, 0xd6, 0xd3, 0xf8, 0xff,
+    0x54, 0x37, 0xfa, 0xff, 0xa5, 0x86, 0xff, 0xff, 0xb5, 0xc9, 0x01, 0x00,
+    0x7a, 0xc1, 0x04, 0x00, 0xed, 0x3d, 0x04, 0x00, 0x7e, 0x6c, 0x03, 0x00,
+    0x63, 0x03, 0x01, 0x00, 0xc3, 0xb9, 0xf7, 0xff, 0xf6, 0x25, 0x06, 0x00,
+    0xd3, 0x53, 0x00, 0x00, 0x1d, 0xb6, 0x04, 0x00, 0x0d, 0x32, 0xfd, 0xff,
+    0x89, 0x78, 0x00, 0x00, 0xcd, 0x55, 0xff, 0xff, 0x7e, 0xec, 0x01, 0x00,
+    0x1c, 0x3e, 0xfc, 0xff, 0x48, 0x60, 0x0a, 0x00, 0x13, 0xb9, 0xfe, 0xff,
+    0x7d, 0xb8, 0x05, 0x00, 0x6a, 0x95, 0x03, 0x00, 0xa4, 0x0e, 0x04, 0x00,
+    0x47, 0x9f, 0xff, 0xff, 0x85, 0x80, 0xf9, 0xff, 0x60, 0xe4, 0xf6, 0xff,
+    0x17, 0x3e, 0x03, 0x00, 0xed, 0x14, 0x0c, 0x00, 0xca, 0x04, 0xf4, 0xff,
+    0x50, 0x23, 0x03, 0x00, 0x05, 0xbc, 0xfd, 0xff, 0x6c, 0x7b, 0x04, 0x00,
+    0x4b, 0xb5, 0x07, 0x00, 0xcc, 0x17, 0x00, 0x00, 0x71, 0x45, 0xfc, 0xff,
+    0x14, 0x9d, 0xfa, 0xff, 0xd6, 0xe9, 0x00, 0x00, 0x2e, 0x32, 0xfb, 0xff,
+    0x25, 0x60, 0xfa, 0xff, 0xa2, 0xae, 0xf5, 0xff, 0x44, 0x42, 0xfc, 0xff,
+    0x04, 0x15, 0xfa, 0xff, 0x19, 0x61, 0xfc, 0xff, 0xe1, 0xb8, 0xff, 0xff,
+    0x97, 0xbd, 0xf9, 0xff, 0x72, 0x94, 0x03, 0x00, 0x5b, 0xb9, 0x0a, 0x00,
+    0xeb, 0x3b, 0x03, 0x00, 0xdd, 0x40, 0x00, 0x00, 0xf0, 0xc0, 0xfe, 0xff,
+    0x73, 0x64, 0xf7, 0xff, 0x5e, 0xda, 0xfc, 0xff, 0xa4, 0xcc, 0xfd, 0xff,
+    0x81, 0xff, 0xfc, 0xff, 0xee, 0x09, 0x07, 0x00, 0x16, 0xc1, 0x01, 0x00,
+    0xbe, 0xe3, 0x09, 0x00, 0x63, 0x61, 0x03, 0x00, 0x37, 0x7e, 0x07, 0x00,
+    0x32, 0x29, 0xfc, 0xff, 0x64, 0x6c, 0x02, 0x00, 0x8e, 0xcd, 0xff, 0xff,
+    0xc5, 0x77, 0x01, 0x00, 0x9e, 0xf5, 0xf9, 0xff, 0xa6, 0x44, 0x08, 0x00,
+    0xfe, 0x4f, 0xff, 0xff, 0xfd, 0x8b, 0xfd, 0xff, 0xf0, 0x36, 0x04, 0x00,
+    0xa0, 0x42, 0x07, 0x00, 0x3a, 0x8d, 0x0a, 0x00, 0x5c, 0x64, 0xf8, 0xff,
+    0x62, 0xd5, 0x02, 0x00, 0x98, 0xc4, 0xf6, 0xff, 0xd4, 0x8f, 0xfb, 0xff,
+    0x5d, 0x5a, 0xfe, 0xff, 0x0a, 0xe2, 0xf4, 0xff, 0xea, 0x5e, 0x00, 0x00,
+    0x5e, 0x5e, 0x03, 0x00, 0x92, 0x96, 0xfd, 0xff, 0xa3, 0xd4, 0xfb, 0xff,
+    0x66, 0xc6, 0x00, 0x00, 0x6a, 0x86, 0xfe, 0xff, 0x38, 0x7e, 0xfd, 0xff,
+    0x6f, 0x8d, 0xff, 0xff, 0x31, 0x0f, 0xfb, 0xff, 0xf5, 0xc2, 0xf7, 0xff,
+    0x16, 0xda, 0x0f, 0x00, 0xb2, 0xac, 0x0e, 0x00, 0x9e, 0xcb, 0xf8, 0xff,
+    0x89, 0xc5, 0xfc, 0xff, 0xcb, 0xfc, 0xfb, 0xff, 0xbe, 0xb8, 0xff, 0xff,
+    0x7d, 0x4b, 0xfb, 0xff, 0x2f, 0xdd, 0x03, 0x00, 0x42, 0x5a, 0x0a, 0x00,
+    0x40, 0xe3, 0xf9, 0xff, 0x3c, 0x8b, 0x03, 0x00, 0x55, 0xb1, 0x05, 0x00,
+    0xc4, 0xe7, 0xf1, 0xff, 0x1c, 0xc7, 0xfb, 0xff, 0xa0, 0x37, 0xfe, 0xff,
+    0x1d, 0x20, 0x03, 0x00, 0x96, 0xe0, 0x00, 0x00, 0x41, 0x7b, 0x00, 0x00,
+    0x36, 0x25, 0x04, 0x00, 0x50, 0xdb, 0xfc, 0xff, 0x09, 0xe4, 0x05, 0x00,
+    0x5e, 0x3c, 0xf7, 0xff, 0xef, 0x66, 0xfd, 0xff, 0xf4, 0x12, 0xfe, 0xff,
+    0x97, 0x9d, 0xff, 0xff, 0x68, 0x7e, 0xff, 0xff, 0x9a, 0x7e, 0xff, 0xff,
+    0x5e, 0xa9, 0xfe, 0xff, 0x49, 0xc0, 0xff, 0xff, 0x16, 0xd9, 0xfd, 0xff,
+    0xd8, 0x6d, 0x00, 0x00, 0xe4, 0xc6, 0xfd, 0xff, 0xf0, 0x1a, 0xfe, 0xff,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x7c, 0x02, 0x6d,
+    0x18, 0x00, 0x00, 0x00, 0x84, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00};
@@ -0,0 +1,29 @@
+// generated by mlp_gen from g_params; do not edit
+
+#include "params_folded.h"
+
+const int32_t g_output_weight_sums[80] = {
+    -983, -703, -650, -611, -442, -317, -165, 39,
+    -197, 46, 288, 338, 201, 213, 173, 121,
+    -259, -295, -486, -620, -434, -420, -54, -41,
+    -256, -151, 13, -113, -94, -158, -74, -60,
+    -686, -488, -573, -511, -534, -285, -88, -73,
+    -130, -95, 172, 405, 326, 118, -212, 7,
+    -1102, -1295, -1191, -940, -467, 46, -105, -29,
+    220, 171, 194, -61, 64, -122, -20, -214,
+    -1140, -1096, -1131, -1006, -491, -317, -217, -92,
+    -970, -743, -540, -373, -480, -489, -291, -57,
+};
+
+const int32_t g_output_weight_norms[80] = {
+    458, 426, 410, 375, 345, 280, 236, 153,
+    422, 381, 329, 313, 266, 235, 190, 128,
+    466, 434, 418, 376, 322, 257, 194, 148,
+    424, 378, 348, 333, 274, 239, 168, 116,
+    494, 436, 402, 367, 336, 280, 198, 157,
+    452, 430, 401, 340, 304, 259, 225, 180,
+    530, 516, 502, 449, 384, 301, 257, 155,
+    436, 413, 393, 359, 287, 243, 196, 141,
+    538, 519, 483, 452, 370, 337, 298, 194,
+    516, 478, 447, 408, 370, 331, 295, 184,
+};
@@ -0,0 +1,106 @@
+#include "placement.h"
+#include "mlp_config.h"
+#include "params.h"
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// copy size bytes of tensor id to the region the policy picks; returns the
+// copy, or tensor if it stays in place (or the model doesn't have it: NULL)
+static const void *place_tensor(
+    const void *tensor,
+    uint32_t id,
+    uint32_t size,
+    const mlp_placement_policy_t *policy,
+    mlp_placement_t *placement)
+{
+    if (tensor == NULL)
+    {
+        return NULL;
+    }
+
+    mlp_place_t place = (mlp_place_t)policy->place[id];
+    if (place != MLP_PLACE_FLASH)
+    {
+        void *copy = mlp_region_alloc(place, size);
+        if (copy != NULL)
+        {
+            memcpy(copy, tensor, size);
+            tensor = copy;
+            placement->copies[placement->copy_count] = copy;
+            placement->copy_sizes[placement->copy_count] = size;
+            placement->copy_places[placement->copy_count] = (uint8_t)place;
+            ++placement->copy_count;
+        }
+        else
+        {
+            ++placement->fallbacks;
+            place = MLP_PLACE_FLASH;
+        }
+    }
+
+    placement->bytes[place] += size;
+    ++placement->tensors[place];
+    return tensor;
+}
+
+// -----------------------------------------------------------------------------
+void mlp_placement_policy_default(mlp_placement_policy_t *policy)
+{
+    memset(policy, MLP_PLACE_FLASH, sizeof(*policy));
+
+    policy->place[MLP_TENSOR_HIDDEN_WEIGHTS] = CONFIG_MLP_PLACE_HIDDEN_WEIGHTS;
+    policy->place[MLP_TENSOR_HIDDEN_WEIGHT_ZPS] = CONFIG_MLP_PLACE_HIDDEN_TABLES;
+    policy->place[MLP_TENSOR_HIDDEN_BIASES] = CONFIG_MLP_PLACE_HIDDEN_TABLES;
+    policy->place[MLP_TENSOR_HIDDEN_FOLDED_BIASES] = CONFIG_MLP_PLACE_HIDDEN_TABLES;
+    policy->place[MLP_TENSOR_HIDDEN_MULTIPLIERS] = CONFIG_MLP_PLACE_HIDDEN_TABLES;
+    policy->place[MLP_TENSOR_HIDDEN_SHIFTS] = CONFIG_MLP_PLACE_HIDDEN_TABLES;
+    policy->place[MLP_TENSOR_OUTPUT_WEIGHTS] = CONFIG_MLP_PLACE_OUTPUT_WEIGHTS;
+    policy->place[MLP_TENSOR_OUTPUT_WEIGHT_ZPS] = CONFIG_MLP_PLACE_OUTPUT_TABLES;
+    policy->place[MLP_TENSOR_OUTPUT_FOLDED_BIASES] = CONFIG_MLP_PLACE_OUTPUT_TABLES;
+    policy->place[MLP_TENSOR_OUTPUT_MULTIPLIERS] = CONFIG_MLP_PLACE_OUTPUT_TABLES;
+    policy->place[MLP_TENSOR_OUTPUT_SHIFTS] = CONFIG_MLP_PLACE_OUTPUT_TABLES;
+    policy->place[MLP_TENSOR_SOFTMAX_PARAMS] = CONFIG_MLP_PLACE_OUTPUT_TABLES;
+}
+
+// -----------------------------------------------------------------------------
+int mlp_model_place(mlp_model_t *model, const mlp_placement_policy_t *policy, mlp_placement_t *placement)
+{
+    memset(placement, 0, sizeof(*placement));
+
+    // the plan and the derived weight layouts don't read these tensors through
+    // the model, copies of them would go unused
+    for (uint32_t id = 0; id < MLP_TENSOR_ID_COUNT; ++id)
+    {
+        if (policy->place[id] >= MLP_PLACE_COUNT ||
+            ((CONFIG_MLP_PLAN_EXECUTOR || MLP_WEIGHTS_DERIVED) && policy->place[id] != MLP_PLACE_FLASH))
+        {
+            return -1;
+        }
+    }
+
+    model->hidden_weights = place_tensor(model->hidden_weights, MLP_TENSOR_HIDDEN_WEIGHTS, HIDDEN_SIZE * INPUT_SIZE, policy, placement);
+    model->hidden_weight_zps = place_tensor(model->hidden_weight_zps, MLP_TENSOR_HIDDEN_WEIGHT_ZPS, HIDDEN_SIZE, policy, placement);
+    model->hidden_biases = place_tensor(model->hidden_biases, MLP_TENSOR_HIDDEN_BIASES, HIDDEN_SIZE * sizeof(int32_t), policy, placement);
+    model->hidden_folded_biases = place_tensor(model->hidden_folded_biases, MLP_TENSOR_HIDDEN_FOLDED_BIASES, HIDDEN_SIZE * sizeof(int32_t), policy, placement);
+    model->hidden_multipliers = place_tensor(model->hidden_multipliers, MLP_TENSOR_HIDDEN_MULTIPLIERS, HIDDEN_SIZE * sizeof(uint32_t), policy, placement);
+    model->hidden_shifts = place_tensor(model->hidden_shifts, MLP_TENSOR_HIDDEN_SHIFTS, HIDDEN_SIZE * sizeof(int32_t), policy, placement);
+    model->output_weights = place_tensor(model->output_weights, MLP_TENSOR_OUTPUT_WEIGHTS, OUTPUT_SIZE * HIDDEN_SIZE, policy, placement);
+    model->output_weight_zps = place_tensor(model->output_weight_zps, MLP_TENSOR_OUTPUT_WEIGHT_ZPS, OUTPUT_SIZE, policy, placement);
+    model->output_folded_biases = place_tensor(model->output_folded_biases, MLP_TENSOR_OUTPUT_FOLDED_BIASES, OUTPUT_SIZE * sizeof(int32_t), policy, placement);
+    model->output_multipliers = place_tensor(model->output_multipliers, MLP_TENSOR_OUTPUT_MULTIPLIERS, OUTPUT_SIZE * sizeof(uint32_t), policy, placement);
+    model->output_shifts = place_tensor(model->output_shifts, MLP_TENSOR_OUTPUT_SHIFTS, OUTPUT_SIZE * sizeof(int32_t), policy, placement);
+    model->softmax = place_tensor(model->softmax, MLP_TENSOR_SOFTMAX_PARAMS, sizeof(softmax_params_t), policy, placement);
+
+    return (int)placement->fallbacks;
+}
+
+// -----------------------------------------------------------------------------
+void mlp_placement_release(mlp_placement_t *placement)
+{
+    for (uint32_t i = 0; i < placement->copy_count; ++i)
+    {
+        mlp_region_free((mlp_place_t)placement->copy_places[i], placement->copies[i], placement->copy_sizes[i]);
+    }
+    memset(placement, 0, sizeof(*placement));
+}
@@ -0,0 +1,18 @@
+#include "placement.h"
+
+#include "esp_heap_caps.h"
+
+// -----------------------------------------------------------------------------
+void *mlp_region_alloc(mlp_place_t region, uint32_t size)
+{
+    uint32_t caps = (region == MLP_PLACE_PSRAM) ? MALLOC_CAP_SPIRAM : (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    return heap_caps_aligned_alloc(MLP_CONTAINER_ALIGN, size, caps);
+}
+
+// -----------------------------------------------------------------------------
+void mlp_region_free(mlp_place_t region, void *data, uint32_t size)
+{
+    (void)region;
+    (void)size;
+    heap_caps_free(data);
+}
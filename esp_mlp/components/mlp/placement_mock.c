@@ -0,0 +1,47 @@
+#include "placement.h"
+
+#include <stdlib.h>
+
+// -----------------------------------------------------------------------------
+// host stand-ins for the device regions: the heap, with a capacity per region
+// (an ESP32-S3 with 512 KB of SRAM and 8 MB of PSRAM by default) so running
+// out of one can be tested
+static uint32_t g_capacity[MLP_PLACE_COUNT] = {0, 512u << 10, 8u << 20};
+static uint32_t g_used[MLP_PLACE_COUNT];
+
+// -----------------------------------------------------------------------------
+void *mlp_region_alloc(mlp_place_t region, uint32_t size)
+{
+    if (region == MLP_PLACE_FLASH || region >= MLP_PLACE_COUNT ||
+        g_used[region] + size > g_capacity[region])
+    {
+        return NULL;
+    }
+
+    void *data = aligned_alloc(MLP_CONTAINER_ALIGN, MLP_CONTAINER_ALIGN_UP(size));
+    if (data != NULL)
+    {
+        g_used[region] += size;
+    }
+    return data;
+}
+
+// -----------------------------------------------------------------------------
+void mlp_region_free(mlp_place_t region, void *data, uint32_t size)
+{
+    g_used[region] -= size;
+    free(data);
+}
+
+// -----------------------------------------------------------------------------
+void mlp_region_mock_set(uint32_t dram_capacity, uint32_t psram_capacity)
+{
+    g_capacity[MLP_PLACE_DRAM] = dram_capacity;
+    g_capacity[MLP_PLACE_PSRAM] = psram_capacity;
+}
+
+// -----------------------------------------------------------------------------
+uint32_t mlp_region_mock_used(mlp_place_t region)
+{
+    return g_used[region];
+}
@@ -0,0 +1,237 @@
+#include "plan.h"
+#include "dense.h"
+#include "profile.h"
+#include "softmax.h"
+
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+static inline const mlp_plan_layer_t *plan_layers(const mlp_plan_t *plan)
+{
+    return (const mlp_plan_layer_t *)(plan + 1);
+}
+
+// -----------------------------------------------------------------------------
+// a layer writes the caller's outputs if every layer after it runs in place
+static uint32_t last_out_of_place(const mlp_plan_t *plan)
+{
+    const mlp_plan_layer_t *layers = plan_layers(plan);
+    uint32_t last = 0;
+    for (uint32_t l = 0; l < plan->layer_count; ++l)
+    {
+        if (layers[l].type != MLP_LAYER_SOFTMAX)
+        {
+            last = l;
+        }
+    }
+    return last;
+}
+
+// -----------------------------------------------------------------------------
+// size is 64-bit so that products of untrusted plan fields can't wrap
+static int tensor_in_range(uint32_t offset, uint64_t size, uint32_t align, uint32_t params_size)
+{
+    return (offset % align) == 0 && offset <= params_size && size <= params_size - offset;
+}
+
+// -----------------------------------------------------------------------------
+// a known activation with its parameters in range
+static int activation_valid(const mlp_plan_layer_t *layer, uint32_t params_size)
+{
+    switch (layer->activation)
+    {
+    case MLP_ACTIVATION_NONE:
+    case MLP_ACTIVATION_RELU:
+        return 1;
+    case MLP_ACTIVATION_RELU6:
+        return tensor_in_range(layer->activation_offset, 1, 1, params_size);
+    case MLP_ACTIVATION_LUT:
+        return tensor_in_range(layer->activation_offset, DENSE_LUT_SIZE, 1, params_size);
+    default:
+        return 0;
+    }
+}
+
+// -----------------------------------------------------------------------------
+const mlp_plan_t *mlp_plan_get(
+    const uint8_t *params,
+    uint32_t params_size,
+    uint32_t plan_offset,
+    uint32_t arena_capacity)
+{
+    if (!tensor_in_range(plan_offset, sizeof(mlp_plan_t), 4, params_size))
+    {
+        return NULL;
+    }
+
+    const mlp_plan_t *plan = (const mlp_plan_t *)&params[plan_offset];
+    if (plan->magic != MLP_PLAN_MAGIC ||
+        plan->version != MLP_PLAN_VERSION ||
+        plan->layer_count == 0 ||
+        plan->arena_size > arena_capacity ||
+        !tensor_in_range(plan_offset + sizeof(mlp_plan_t), (uint64_t)plan->layer_count * sizeof(mlp_plan_layer_t), 4, params_size))
+    {
+        return NULL;
+    }
+
+    const mlp_plan_layer_t *layers = plan_layers(plan);
+    uint32_t last = last_out_of_place(plan);
+    uint32_t size = plan->input_size;
+
+    for (uint32_t l = 0; l < plan->layer_count; ++l)
+    {
+        const mlp_plan_layer_t *layer = &layers[l];
+        if (layer->input_size != size || layer->input_size == 0 || layer->output_size == 0)
+        {
+            return NULL;
+        }
+
+        if (layer->type == MLP_LAYER_DENSE)
+        {
+            uint64_t n = layer->output_size;
+            if (!activation_valid(layer, params_size) ||
+                !tensor_in_range(layer->weight_offset, n * layer->input_size, 1, params_size) ||
+                !tensor_in_range(layer->folded_bias_offset, n * sizeof(int32_t), 4, params_size) ||
+                !tensor_in_range(layer->multiplier_offset, n * sizeof(uint32_t), 4, params_size) ||
+                !tensor_in_range(layer->shift_offset, n * sizeof(int32_t), 4, params_size) ||
+                (layer->weight_zp_offset != MLP_PLAN_NONE && !tensor_in_range(layer->weight_zp_offset, n, 1, params_size)))
+            {
+                return NULL;
+            }
+
+            // intermediate activations must fit the arena side by side
+            uint32_t in = (l == 0) ? 0 : MLP_PLAN_ALIGN_UP(layer->input_size);
+            uint32_t out = (l == last) ? 0 : MLP_PLAN_ALIGN_UP(layer->output_size);
+            if (in + out > plan->arena_size)
+            {
+                return NULL;
+            }
+        }
+        else if (layer->type != MLP_LAYER_SOFTMAX ||
+                 layer->output_size != layer->input_size ||
+                 l < last ||
+                 !tensor_in_range(layer->multiplier_offset, sizeof(softmax_params_t), 4, params_size))
+        {
+            return NULL;
+        }
+
+        size = layer->output_size;
+    }
+
+    return (size == plan->output_size && layers[last].type == MLP_LAYER_DENSE) ? plan : NULL;
+}
+
+// -----------------------------------------------------------------------------
+// the activation as a clamp (+ lookup), fused into the output pass
+static void layer_epilogue(const mlp_plan_layer_t *layer, const uint8_t *params, dense_epilogue_t *epilogue)
+{
+    epilogue->min = INT8_MIN;
+    epilogue->max = INT8_MAX;
+    epilogue->lut = NULL;
+    switch (layer->activation)
+    {
+    case MLP_ACTIVATION_RELU:
+        epilogue->min = layer->output_zp;
+        break;
+    case MLP_ACTIVATION_RELU6:
+        epilogue->min = layer->output_zp;
+        epilogue->max = (int8_t)params[layer->activation_offset];
+        break;
+    case MLP_ACTIVATION_LUT:
+        epilogue->lut = (const int8_t *)&params[layer->activation_offset];
+        break;
+    default:
+        break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+void mlp_plan_epilogue(const mlp_plan_t *plan, const uint8_t *params, uint32_t l, dense_epilogue_t *epilogue)
+{
+    layer_epilogue(&plan_layers(plan)[l], params, epilogue);
+}
+
+// -----------------------------------------------------------------------------
+static void run_dense(const mlp_plan_layer_t *layer, const uint8_t *params, const int8_t *inputs, int8_t *outputs)
+{
+    const int8_t *weights = (const int8_t *)&params[layer->weight_offset];
+    const int8_t *weight_zps = (layer->weight_zp_offset == MLP_PLAN_NONE) ? NULL : (const int8_t *)&params[layer->weight_zp_offset];
+    const int32_t *folded_biases = (const int32_t *)&params[layer->folded_bias_offset];
+    const uint32_t *multipliers = (const uint32_t *)&params[layer->multiplier_offset];
+    const int32_t *shifts = (const int32_t *)&params[layer->shift_offset];
+    dense_epilogue_t epilogue;
+    layer_epilogue(layer, params, &epilogue);
+
+#if DENSE_SIMD_PIE
+    dense_int8_simd_fused(
+        inputs,
+        weights,
+        weight_zps,
+        folded_biases,
+        outputs,
+        layer->output_zp,
+        multipliers,
+        shifts,
+        &epilogue,
+        layer->input_size,
+        layer->output_size);
+#else
+    dense_int8_fused(
+        inputs,
+        weights,
+        weight_zps,
+        folded_biases,
+        outputs,
+        layer->output_zp,
+        multipliers,
+        shifts,
+        &epilogue,
+        layer->input_size,
+        layer->output_size);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// executor: layer l reads the previous activation and writes the other end of
+// the arena (or the caller's outputs for the last out-of-place layer)
+void mlp_plan_run(
+    const mlp_plan_t *plan,
+    const uint8_t *params,
+    int8_t *arena,
+    const int8_t *inputs,
+    int8_t *outputs)
+{
+    const mlp_plan_layer_t *layers = plan_layers(plan);
+    uint32_t last = last_out_of_place(plan);
+    const int8_t *current = inputs;
+    int high = 0;
+
+    for (uint32_t l = 0; l < plan->layer_count; ++l)
+    {
+        const mlp_plan_layer_t *layer = &layers[l];
+
+        if (layer->type == MLP_LAYER_SOFTMAX)
+        {
+            MLP_PROFILE_BEGIN(MLP_SCOPE_SOFTMAX);
+            softmax_int8(outputs, outputs, layer->output_size, (const softmax_params_t *)&params[layer->multiplier_offset]);
+            MLP_PROFILE_END_ARG(MLP_SCOPE_SOFTMAX, l + 1);
+            continue;
+        }
+
+        int8_t *next;
+        if (l == last)
+        {
+            next = outputs;
+        }
+        else
+        {
+            high = !high;
+            next = high ? &arena[plan->arena_size - MLP_PLAN_ALIGN_UP(layer->output_size)] : arena;
+        }
+
+        MLP_PROFILE_BEGIN(dense);
+        run_dense(layer, params, current, next);
+        MLP_PROFILE_END_AS(dense, (current == inputs) ? MLP_SCOPE_DENSE1 : MLP_SCOPE_DENSE2, l + 1);
+        current = next;
+    }
+}
@@ -0,0 +1,78 @@
+#include "profile.h"
+
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+// ring buffer of CONFIG_MLP_PROFILE_RECORDS records; g_head counts the records
+// appended since the last reset, the slot of record n is n & RECORD_MASK
+#define RECORD_MASK (CONFIG_MLP_PROFILE_RECORDS - 1)
+
+_Static_assert((CONFIG_MLP_PROFILE_RECORDS & RECORD_MASK) == 0, "CONFIG_MLP_PROFILE_RECORDS must be a power of two");
+_Static_assert(sizeof(mlp_profile_header_t) == 32, "profile header layout");
+_Static_assert(sizeof(mlp_profile_record_t) == 16, "profile record layout");
+
+// the cycle counters of the two cores run apart
+#ifdef ESP_PLATFORM
+#define CLOCK_BITS 32
+#define CLOCK_FLAGS 0
+#else
+#define CLOCK_BITS 64
+#define CLOCK_FLAGS MLP_PROFILE_SHARED_CLOCK
+#endif
+
+static mlp_profile_record_t g_records[CONFIG_MLP_PROFILE_RECORDS];
+static uint32_t g_head = 0;
+
+// -----------------------------------------------------------------------------
+void mlp_profile_record(mlp_scope_t scope, uint32_t arg, uint64_t start, uint64_t end)
+{
+    // claiming the slot is the only shared write
+    uint32_t n = __atomic_fetch_add(&g_head, 1, __ATOMIC_RELAXED);
+    mlp_profile_record_t *record = &g_records[n & RECORD_MASK];
+
+    record->start = start;
+    record->duration = (uint32_t)(end - start);
+    record->scope = (uint8_t)scope;
+    record->context = mlp_profile_context();
+    record->arg = (uint16_t)arg;
+}
+
+// -----------------------------------------------------------------------------
+void mlp_profile_reset(void)
+{
+    __atomic_store_n(&g_head, 0, __ATOMIC_RELEASE);
+}
+
+// -----------------------------------------------------------------------------
+uint32_t mlp_profile_dump(mlp_profile_write_fn write, void *arg)
+{
+    uint32_t head = __atomic_load_n(&g_head, __ATOMIC_ACQUIRE);
+    uint32_t count = (head < CONFIG_MLP_PROFILE_RECORDS) ? head : CONFIG_MLP_PROFILE_RECORDS;
+    uint32_t first = (head - count) & RECORD_MASK;
+
+    mlp_profile_header_t header = {
+        .magic = MLP_PROFILE_MAGIC,
+        .version = MLP_PROFILE_VERSION,
+        .record_size = sizeof(mlp_profile_record_t),
+        .clock_hz = mlp_profile_clock_hz(),
+        .clock_bits = CLOCK_BITS,
+        .count = count,
+        .dropped = head - count,
+        .flags = CLOCK_FLAGS,
+    };
+    write(&header, sizeof(header), arg);
+
+    // oldest first: up to the end of the buffer, then from its start
+    uint32_t tail = CONFIG_MLP_PROFILE_RECORDS - first;
+    if (tail > count)
+    {
+        tail = count;
+    }
+    write(&g_records[first], tail * sizeof(mlp_profile_record_t), arg);
+    if (count > tail)
+    {
+        write(&g_records[0], (count - tail) * sizeof(mlp_profile_record_t), arg);
+    }
+
+    return count;
+}
@@ -0,0 +1,18 @@
+#include "profile.h"
+
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+
+// -----------------------------------------------------------------------------
+// device clock: the CPU cycle counter of the recording core, which isn't
+// synchronized with the other core's (see profile.h)
+uint64_t mlp_profile_clock_hz(void)
+{
+    return (uint64_t)esp_rom_get_cpu_ticks_per_us() * 1000000ull;
+}
+
+// -----------------------------------------------------------------------------
+uint8_t mlp_profile_context(void)
+{
+    return (uint8_t)esp_cpu_get_core_id();
+}
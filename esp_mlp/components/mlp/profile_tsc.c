@@ -0,0 +1,54 @@
+#include "profile.h"
+
+#include <pthread.h>
+#include <time.h>
+
+// -----------------------------------------------------------------------------
+// host stand-in for profile_cycles.c: the TSC (calibrated once against
+// CLOCK_MONOTONIC) on x86, CLOCK_MONOTONIC nanoseconds elsewhere; threads are
+// numbered in the order they first record
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static uint64_t g_clock_hz = 1000000000ull;
+static uint32_t g_next_context = 0;
+static __thread int t_context = -1;
+
+#if defined(__x86_64__) || defined(__i386__)
+// -----------------------------------------------------------------------------
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+static void calibrate(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    struct timespec wait = {0, 20000000};
+    uint64_t ns = monotonic_ns();
+    uint64_t ticks = mlp_profile_clock();
+    nanosleep(&wait, NULL);
+    ticks = mlp_profile_clock() - ticks;
+    ns = monotonic_ns() - ns;
+    g_clock_hz = (uint64_t)((double)ticks * 1e9 / (double)ns);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+uint64_t mlp_profile_clock_hz(void)
+{
+    pthread_once(&g_once, calibrate);
+    return g_clock_hz;
+}
+
+// -----------------------------------------------------------------------------
+uint8_t mlp_profile_context(void)
+{
+    if (t_context < 0)
+    {
+        t_context = (int)(__atomic_fetch_add(&g_next_context, 1, __ATOMIC_RELAXED) & 0xff);
+    }
+    return (uint8_t)t_context;
+}
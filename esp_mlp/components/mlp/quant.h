@@ -0,0 +1,174 @@
+#ifndef QUANT_H_
+#define QUANT_H_
+
+#include "mlp_config.h"
+
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// saturate a 32-bit integer to int8 range [INT8_MIN..INT8_MAX]
+static inline int8_t saturate_to_int8(int32_t x)
+{
+    if (x > INT8_MAX)
+    {
+        return INT8_MAX;
+    }
+    else if (x < INT8_MIN)
+    {
+        return INT8_MIN;
+    }
+    else
+    {
+        return (int8_t)x;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// saturating rounding doubling high mul: (a * b + 2^30) >> 31
+static inline int32_t saturating_rounding_doubling_high_mul(int32_t a, int32_t b)
+{
+    // special case: INT32_MIN * INT32_MIN => saturates
+    if (a == INT32_MIN && b == INT32_MIN)
+    {
+        return INT32_MAX;
+    }
+
+    // 32-bit only version of: (int64_t)a * (int64_t)b
+    int32_t a_high = a >> 16;
+    int32_t a_low = a & 0xffff;
+    int32_t b_high = b >> 16;
+    int32_t b_low = b & 0xffff;
+
+    int32_t high_high = a_high * b_high;
+    int32_t high_low = a_high * b_low;
+    int32_t low_high = a_low * b_high;
+    int32_t low_low = a_low * b_low;
+
+    // 32x32 = 64 approximation: extract top 32 bits of result
+    // combine partial products and simulate rounding
+    int32_t mid = (low_high + high_low);
+    int32_t mid_high = mid >> 15;
+    int32_t result = high_high << 1;
+    result += mid_high;
+    result += (low_low >> 31); // rounding
+
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+// saturating rounding doubling high mul, exact 64-bit product (gemmlowp)
+static inline int32_t saturating_rounding_doubling_high_mul_exact(int32_t a, int32_t b)
+{
+    if (a == INT32_MIN && b == INT32_MIN)
+    {
+        return INT32_MAX;
+    }
+
+    int64_t ab = (int64_t)a * (int64_t)b;
+    int32_t nudge = (ab >= 0) ? (1 << 30) : (1 - (1 << 30));
+    return (int32_t)((ab + nudge) / (1ll << 31));
+}
+
+// -----------------------------------------------------------------------------
+// rounding right shift by power-of-two
+static inline int32_t rounding_divide_by_pot(int32_t x, int32_t exponent)
+{
+    int32_t mask = (1 << exponent) - 1;
+    int32_t remainder = x & mask;
+    int32_t threshold = (mask >> 1) + ((x < 0) ? 1 : 0);
+    return (x >> exponent) + (remainder > threshold ? 1 : 0);
+}
+
+// -----------------------------------------------------------------------------
+// requantization backends: val * multiplier * 2^-31 * 2^-shift, rounded
+//   exact64: bit-exact with TFLite/TFLM (gemmlowp) MultiplyByQuantizedMultiplier
+//   approx32: 32-bit only high mul, drops the low x low partial product
+//   pot: multiplier rounded to the nearest power of two, a single rounding shift
+//   float: single-precision multiply, round half away from zero
+
+// -----------------------------------------------------------------------------
+static inline int32_t requant_exact64(int32_t val, uint32_t multiplier, int32_t shift)
+{
+    int32_t result = saturating_rounding_doubling_high_mul_exact(val, (int32_t)multiplier);
+    return rounding_divide_by_pot(result, shift);
+}
+
+// -----------------------------------------------------------------------------
+static inline int32_t requant_approx32(int32_t val, uint32_t multiplier, int32_t shift)
+{
+    int32_t result = saturating_rounding_doubling_high_mul(val, (int32_t)multiplier);
+    return rounding_divide_by_pot(result, shift);
+}
+
+// -----------------------------------------------------------------------------
+// multiplier in [2^30, 2^31): rounds to 2^-shift above 2^30 * sqrt(2), else to
+// 2^-(shift + 1)
+static inline int32_t requant_pot(int32_t val, uint32_t multiplier, int32_t shift)
+{
+    return rounding_divide_by_pot(val, shift + ((multiplier >= 1518500250u) ? 0 : 1));
+}
+
+// -----------------------------------------------------------------------------
+static inline int32_t requant_float(int32_t val, uint32_t multiplier, int32_t shift)
+{
+    // 2^-(31 + shift) built from its exponent bits
+    union
+    {
+        uint32_t u;
+        float f;
+    } pot = {.u = (uint32_t)(127 - 31 - shift) << 23};
+
+    float result = (float)val * ((float)multiplier * pot.f);
+    return (int32_t)(result + ((result >= 0.0f) ? 0.5f : -0.5f));
+}
+
+// -----------------------------------------------------------------------------
+// multiply by quantized multiplier, backend picked by CONFIG_MLP_REQUANT_*
+static inline int32_t multiply_by_quantized_multiplier(int32_t val, uint32_t multiplier, int32_t shift)
+{
+#if CONFIG_MLP_REQUANT_EXACT64
+    return requant_exact64(val, multiplier, shift);
+#elif CONFIG_MLP_REQUANT_POT
+    return requant_pot(val, multiplier, shift);
+#elif CONFIG_MLP_REQUANT_FLOAT
+    return requant_float(val, multiplier, shift);
+#else
+    return requant_approx32(val, multiplier, shift);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// ReLU on int8
+static inline int8_t relu_int8(int8_t x, int8_t zero_point)
+{
+    if (x < zero_point)
+    {
+        return zero_point;
+    }
+    else
+    {
+        return x;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// ceil(sqrt(x))
+static inline uint32_t ceil_sqrt(uint32_t x)
+{
+    uint32_t root = 0;
+    for (uint32_t bit = 1u << 30; bit != 0; bit >>= 2)
+    {
+        if (x >= root + bit)
+        {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+    }
+    return root + (x != 0 ? 1 : 0);
+}
+
+#endif
@@ -0,0 +1,40 @@
+#include "quantize.h"
+
+#include <math.h>
+
+// -----------------------------------------------------------------------------
+double dequantize_multiplier(uint32_t multiplier, int32_t shift)
+{
+    return ldexp((double)multiplier, -31 - shift);
+}
+
+// -----------------------------------------------------------------------------
+int quantize_multiplier(double real, uint32_t *multiplier, int32_t *shift)
+{
+    if (real <= 0.0)
+    {
+        *multiplier = 0;
+        *shift = 0;
+        return 0;
+    }
+
+    int exponent;
+    double fraction = frexp(real, &exponent);
+
+    // fraction in [0.5, 1) -> q in [2^30, 2^31]
+    int64_t q = llround(ldexp(fraction, 31));
+    if (q == (1ll << 31))
+    {
+        q /= 2;
+        ++exponent;
+    }
+
+    if (exponent > 0)
+    {
+        return -1;
+    }
+
+    *multiplier = (uint32_t)q;
+    *shift = -exponent;
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include "scheduler.h"
+#include "scheduler_os.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// per-worker FIFO and counters, guarded by scheduler_os_lock(worker); idle is
+// atomic: a worker raises it before its last look at the queues, a submitter
+// reads it after queueing, so one of them always sees the other
+typedef struct
+{
+    mlp_request_t *head;
+    mlp_request_t *tail;
+    uint32_t length;
+    uint32_t max_length;
+    int idle;
+
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t stolen;
+    uint64_t queue_us;
+    uint64_t max_queue_us;
+    uint64_t service_us;
+} worker_queue_t;
+
+static worker_queue_t g_queues[MLP_SCHEDULER_MAX_WORKERS];
+static const mlp_model_t *g_model = NULL;
+static uint32_t g_workers = 0;
+static int g_running = 0;
+static uint32_t g_next = 0;
+static int g_stopping = 0;
+static uint64_t g_start_us = 0;
+
+// -----------------------------------------------------------------------------
+static mlp_request_t *pop(uint32_t worker)
+{
+    worker_queue_t *queue = &g_queues[worker];
+
+    scheduler_os_lock(worker);
+    mlp_request_t *request = queue->head;
+    if (request != NULL)
+    {
+        queue->head = request->next;
+        queue->tail = (queue->head == NULL) ? NULL : queue->tail;
+        --queue->length;
+    }
+    scheduler_os_unlock(worker);
+
+    return request;
+}
+
+// -----------------------------------------------------------------------------
+// the oldest request of the first other queue that has one: the victims'
+// queues are FIFO too, so the request that waited longest goes first
+static mlp_request_t *steal(uint32_t worker)
+{
+    for (uint32_t i = 1; i < g_workers; ++i)
+    {
+        mlp_request_t *request = pop((worker + i) % g_workers);
+        if (request != NULL)
+        {
+            request->stolen = 1;
+            return request;
+        }
+    }
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+static void run(uint32_t worker, mlp_request_t *request)
+{
+    worker_queue_t *queue = &g_queues[worker];
+
+    request->worker = worker;
+    request->start_us = scheduler_os_now_us();
+    mlp_model_forward(g_model, request->inputs, request->outputs);
+    request->end_us = scheduler_os_now_us();
+
+    uint64_t queue_us = request->start_us - request->submit_us;
+    scheduler_os_lock(worker);
+    ++queue->completed;
+    queue->stolen += request->stolen;
+    queue->queue_us += queue_us;
+    queue->max_queue_us = (queue_us > queue->max_queue_us) ? queue_us : queue->max_queue_us;
+    queue->service_us += request->end_us - request->start_us;
+    scheduler_os_unlock(worker);
+
+    if (request->done != NULL)
+    {
+        request->done(request);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// own queue first, then steal; sleeps only after a last look with idle
+// raised, and returns once stopping with every queue empty
+static void worker_loop(uint32_t worker)
+{
+    worker_queue_t *queue = &g_queues[worker];
+
+    for (;;)
+    {
+        mlp_request_t *request = pop(worker);
+        if (request == NULL)
+        {
+            request = steal(worker);
+        }
+        if (request == NULL)
+        {
+            __atomic_store_n(&queue->idle, 1, __ATOMIC_SEQ_CST);
+            request = pop(worker);
+            if (request == NULL)
+            {
+                request = steal(worker);
+            }
+            if (request == NULL)
+            {
+                if (__atomic_load_n(&g_stopping, __ATOMIC_SEQ_CST))
+                {
+                    return;
+                }
+                scheduler_os_sleep(worker);
+            }
+            __atomic_store_n(&queue->idle, 0, __ATOMIC_SEQ_CST);
+        }
+        if (request != NULL)
+        {
+            run(worker, request);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+int mlp_scheduler_start(const mlp_model_t *model, uint32_t workers)
+{
+    if (g_running || workers == 0 || workers > MLP_SCHEDULER_MAX_WORKERS)
+    {
+        return -1;
+    }
+
+    memset(g_queues, 0, sizeof(g_queues));
+    g_model = model;
+    g_workers = workers;
+    g_next = 0;
+    g_stopping = 0;
+    g_start_us = scheduler_os_now_us();
+    g_running = 1;
+
+    if (scheduler_os_start(workers, worker_loop) != 0)
+    {
+        mlp_scheduler_stop();
+        return -1;
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// round-robin over the queues, then wake the owner and every idle worker
+// (whichever gets there first runs it)
+void mlp_scheduler_submit(mlp_request_t *request)
+{
+    uint32_t worker = __atomic_fetch_add(&g_next, 1, __ATOMIC_RELAXED) % g_workers;
+    worker_queue_t *queue = &g_queues[worker];
+
+    request->submit_us = scheduler_os_now_us();
+    request->stolen = 0;
+    request->next = NULL;
+
+    scheduler_os_lock(worker);
+    if (queue->tail != NULL)
+    {
+        queue->tail->next = request;
+    }
+    else
+    {
+        queue->head = request;
+    }
+    queue->tail = request;
+    ++queue->length;
+    queue->max_length = (queue->length > queue->max_length) ? queue->length : queue->max_length;
+    ++queue->submitted;
+    scheduler_os_unlock(worker);
+
+    scheduler_os_wake(worker);
+    for (uint32_t i = 1; i < g_workers; ++i)
+    {
+        uint32_t other = (worker + i) % g_workers;
+        if (__atomic_load_n(&g_queues[other].idle, __ATOMIC_SEQ_CST))
+        {
+            scheduler_os_wake(other);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void mlp_scheduler_stop(void)
+{
+    if (!g_running)
+    {
+        return;
+    }
+
+    __atomic_store_n(&g_stopping, 1, __ATOMIC_SEQ_CST);
+    for (uint32_t worker = 0; worker < g_workers; ++worker)
+    {
+        scheduler_os_wake(worker);
+    }
+    scheduler_os_join();
+    g_running = 0;
+}
+
+// -----------------------------------------------------------------------------
+// also valid after mlp_scheduler_stop, until the next start
+void mlp_scheduler_stats(mlp_scheduler_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->workers = g_workers;
+    stats->elapsed_us = scheduler_os_now_us() - g_start_us;
+
+    for (uint32_t worker = 0; worker < g_workers; ++worker)
+    {
+        const worker_queue_t *queue = &g_queues[worker];
+
+        scheduler_os_lock(worker);
+        stats->submitted += queue->submitted;
+        stats->completed += queue->completed;
+        stats->stolen += queue->stolen;
+        stats->queued += queue->length;
+        stats->max_queued = (queue->max_length > stats->max_queued) ? queue->max_length : stats->max_queued;
+        stats->queue_us += queue->queue_us;
+        stats->max_queue_us = (queue->max_queue_us > stats->max_queue_us) ? queue->max_queue_us : stats->max_queue_us;
+        stats->service_us += queue->service_us;
+        stats->worker_completed[worker] = queue->completed;
+        scheduler_os_unlock(worker);
+    }
+}
@@ -0,0 +1,133 @@
+#include "scheduler_os.h"
+#include "scheduler.h"
+#include "mlp_config.h"
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// device backend: one task per worker pinned to core worker % cores, a mutex
+// and a counting semaphore each; finished tasks report through g_exited and
+// delete themselves
+static SemaphoreHandle_t g_locks[MLP_SCHEDULER_MAX_WORKERS];
+static SemaphoreHandle_t g_signals[MLP_SCHEDULER_MAX_WORKERS];
+static SemaphoreHandle_t g_exited = NULL;
+static void (*g_loop)(uint32_t worker) = NULL;
+static uint32_t g_workers = 0;
+static uint32_t g_started = 0;
+
+// -----------------------------------------------------------------------------
+static void worker_task(void *arg)
+{
+    g_loop((uint32_t)(uintptr_t)arg);
+    xSemaphoreGive(g_exited);
+    vTaskDelete(NULL);
+}
+
+// -----------------------------------------------------------------------------
+int scheduler_os_start(uint32_t workers, void (*loop)(uint32_t worker))
+{
+    g_loop = loop;
+    g_workers = workers;
+    g_started = 0;
+
+    g_exited = xSemaphoreCreateCounting(workers, 0);
+    if (g_exited == NULL)
+    {
+        g_workers = 0;
+        return -1;
+    }
+    for (uint32_t worker = 0; worker < workers; ++worker)
+    {
+        g_locks[worker] = xSemaphoreCreateMutex();
+        g_signals[worker] = xSemaphoreCreateCounting(UINT16_MAX, 0);
+        if (g_locks[worker] == NULL || g_signals[worker] == NULL)
+        {
+            return -1;
+        }
+    }
+
+    for (; g_started < workers; ++g_started)
+    {
+        if (xTaskCreatePinnedToCore(
+                worker_task,
+                "mlp_sched",
+                CONFIG_MLP_SCHEDULER_STACK_SIZE,
+                (void *)(uintptr_t)g_started,
+                CONFIG_MLP_SCHEDULER_PRIORITY,
+                NULL,
+                (BaseType_t)(g_started % portNUM_PROCESSORS)) != pdPASS)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+void scheduler_os_join(void)
+{
+    for (uint32_t worker = 0; worker < g_started; ++worker)
+    {
+        xSemaphoreTake(g_exited, portMAX_DELAY);
+    }
+    for (uint32_t worker = 0; worker < g_workers; ++worker)
+    {
+        if (g_locks[worker] != NULL)
+        {
+            vSemaphoreDelete(g_locks[worker]);
+            g_locks[worker] = NULL;
+        }
+        if (g_signals[worker] != NULL)
+        {
+            vSemaphoreDelete(g_signals[worker]);
+            g_signals[worker] = NULL;
+        }
+    }
+    if (g_exited != NULL)
+    {
+        vSemaphoreDelete(g_exited);
+        g_exited = NULL;
+    }
+    g_started = 0;
+    g_workers = 0;
+}
+
+// -----------------------------------------------------------------------------
+void scheduler_os_lock(uint32_t worker)
+{
+    xSemaphoreTake(g_locks[worker], portMAX_DELAY);
+}
+
+// -----------------------------------------------------------------------------
+void scheduler_os_unlock(uint32_t worker)
+{
+    xSemaphoreGive(g_locks[worker]);
+}
+
+// -----------------------------------------------------------------------------
+void scheduler_os_wake(uint32_t worker)
+{
+    // NULL after a failed start
+    if (g_signals[worker] != NULL)
+    {
+        xSemaphoreGive(g_signals[worker]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+void scheduler_os_sleep(uint32_t worker)
+{
+    xSemaphoreTake(g_signals[worker], portMAX_DELAY);
+}
+
+// -----------------------------------------------------------------------------
+uint64_t scheduler_os_now_us(void)
+{
+    return (uint64_t)esp_timer_get_time();
+}
@@ -0,0 +1,96 @@
+#include "scheduler_os.h"
+#include "scheduler.h"
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdint.h>
+#include <time.h>
+
+// -----------------------------------------------------------------------------
+// host backend: one pthread per worker, left to the kernel scheduler (not
+// pinned), a mutex and a semaphore each
+static pthread_t g_threads[MLP_SCHEDULER_MAX_WORKERS];
+static pthread_mutex_t g_locks[MLP_SCHEDULER_MAX_WORKERS];
+static sem_t g_signals[MLP_SCHEDULER_MAX_WORKERS];
+static void (*g_loop)(uint32_t worker) = NULL;
+static uint32_t g_workers = 0;
+static uint32_t g_started = 0;
+
+// -----------------------------------------------------------------------------
+static void *worker_thread(void *arg)
+{
+    g_loop((uint32_t)(uintptr_t)arg);
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+int scheduler_os_start(uint32_t workers, void (*loop)(uint32_t worker))
+{
+    g_loop = loop;
+    g_workers = workers;
+    g_started = 0;
+
+    for (uint32_t worker = 0; worker < workers; ++worker)
+    {
+        pthread_mutex_init(&g_locks[worker], NULL);
+        sem_init(&g_signals[worker], 0, 0);
+    }
+
+    for (; g_started < workers; ++g_started)
+    {
+        if (pthread_create(&g_threads[g_started], NULL, worker_thread, (void *)(uintptr_t)g_started) != 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+void scheduler_os_join(void)
+{
+    for (uint32_t worker = 0; worker < g_started; ++worker)
+    {
+        pthread_join(g_threads[worker], NULL);
+    }
+    for (uint32_t worker = 0; worker < g_workers; ++worker)
+    {
+        pthread_mutex_destroy(&g_locks[worker]);
+        sem_destroy(&g_signals[worker]);
+    }
+    g_started = 0;
+    g_workers = 0;
+}
+
+// -----------------------------------------------------------------------------
+void scheduler_os_lock(uint32_t worker)
+{
+    pthread_mutex_lock(&g_locks[worker]);
+}
+
+// -----------------------------------------------------------------------------
+void scheduler_os_unlock(uint32_t worker)
+{
+    pthread_mutex_unlock(&g_locks[worker]);
+}
+
+// -----------------------------------------------------------------------------
+void scheduler_os_wake(uint32_t worker)
+{
+    sem_post(&g_signals[worker]);
+}
+
+// -----------------------------------------------------------------------------
+void scheduler_os_sleep(uint32_t worker)
+{
+    // sem_wait returns early when a signal interrupts it; the loop looks again
+    sem_wait(&g_signals[worker]);
+}
+
+// -----------------------------------------------------------------------------
+uint64_t scheduler_os_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
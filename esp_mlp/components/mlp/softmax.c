@@ -0,0 +1,228 @@
+#include "softmax.h"
+#include "quant.h"
+
+#include <math.h>
+
+// -----------------------------------------------------------------------------
+// fixed-point formats (TFLite/TFLM reference_ops::Softmax):
+//   input differences: Q5.26
+//   exponentials: Q0.31
+//   sum of exponentials: Q12.19
+#define SOFTMAX_DIFF_INTEGER_BITS   5
+#define SOFTMAX_ACCUM_INTEGER_BITS  12
+
+// -----------------------------------------------------------------------------
+// x * 2^exponent, saturated (gemmlowp SaturatingRoundingMultiplyByPOT)
+static inline int32_t saturating_shift_left(int32_t x, int32_t exponent)
+{
+    int32_t threshold = (1 << (31 - exponent)) - 1;
+    if (x > threshold)
+    {
+        return INT32_MAX;
+    }
+    if (x < -threshold)
+    {
+        return INT32_MIN;
+    }
+    return (int32_t)((uint32_t)x << exponent);
+}
+
+// -----------------------------------------------------------------------------
+// Q0.31 product
+static inline int32_t fixed_mul(int32_t a, int32_t b)
+{
+    return saturating_rounding_doubling_high_mul_exact(a, b);
+}
+
+// -----------------------------------------------------------------------------
+// e^a for a in [-1/4, 0), Q0.31: 4th order Taylor expansion around -1/8
+static int32_t exp_on_interval_between_negative_one_quarter_and_0_excl(int32_t a)
+{
+    const int32_t constant_term = 1895147668; // e^(-1/8)
+    const int32_t constant_1_over_3 = 715827883;
+
+    int32_t x = a + (1 << 28);
+    int32_t x2 = fixed_mul(x, x);
+    int32_t x3 = fixed_mul(x2, x);
+    int32_t x4 = fixed_mul(x2, x2);
+    int32_t x4_over_4 = rounding_divide_by_pot(x4, 2);
+    int32_t x4_over_24_plus_x3_over_6_plus_x2_over_2 =
+        rounding_divide_by_pot(fixed_mul(x4_over_4 + x3, constant_1_over_3) + x2, 1);
+    return constant_term + fixed_mul(constant_term, x + x4_over_24_plus_x3_over_6_plus_x2_over_2);
+}
+
+// -----------------------------------------------------------------------------
+// e^a for a <= 0, Q5.26 in, Q0.31 out: e^(a mod 1/4) times e^(-2^k) for
+// every bit k of the remainder (gemmlowp exp_on_negative_values)
+static int32_t exp_on_negative_values(int32_t a)
+{
+    static const int32_t barrel_shifter[7] = {
+        1672461947, // e^(-1/4)
+        1302514674, // e^(-1/2)
+        790015084,  // e^(-1)
+        290630308,  // e^(-2)
+        39332535,   // e^(-4)
+        720401,     // e^(-8)
+        242,        // e^(-16)
+    };
+    const int32_t fractional_bits = 31 - SOFTMAX_DIFF_INTEGER_BITS;
+    const int32_t one_quarter = 1 << (fractional_bits - 2);
+
+    int32_t a_mod_quarter_minus_one_quarter = (a & (one_quarter - 1)) - one_quarter;
+    int32_t result = exp_on_interval_between_negative_one_quarter_and_0_excl(
+        saturating_shift_left(a_mod_quarter_minus_one_quarter, SOFTMAX_DIFF_INTEGER_BITS));
+    int32_t remainder = a_mod_quarter_minus_one_quarter - a;
+
+    for (int32_t k = 0; k < 7; ++k)
+    {
+        if (remainder & (1 << (fractional_bits - 2 + k)))
+        {
+            result = fixed_mul(result, barrel_shifter[k]);
+        }
+    }
+
+    return (a == 0) ? INT32_MAX : result;
+}
+
+// -----------------------------------------------------------------------------
+// 1 / (1 + x) for x in [0, 1), Q0.31 in and out: Newton-Raphson on the half
+// denominator in Q2.29 (gemmlowp one_over_one_plus_x_for_x_in_0_1)
+static int32_t one_over_one_plus_x_for_x_in_0_1(int32_t a)
+{
+    const int32_t constant_48_over_17 = 1515870810;
+    const int32_t constant_neg_32_over_17 = -1010580540;
+    const int32_t one_q2 = 1 << 29;
+
+    int64_t sum = (int64_t)a + INT32_MAX;
+    int32_t half_denominator = (int32_t)((sum + (sum >= 0 ? 1 : -1)) / 2);
+
+    int32_t x = constant_48_over_17 + fixed_mul(half_denominator, constant_neg_32_over_17);
+    for (int32_t i = 0; i < 3; ++i)
+    {
+        int32_t half_denominator_times_x = fixed_mul(half_denominator, x);
+        int32_t one_minus_half_denominator_times_x = one_q2 - half_denominator_times_x;
+        x = x + saturating_shift_left(fixed_mul(x, one_minus_half_denominator_times_x), 2);
+    }
+
+    return saturating_shift_left(x, 1);
+}
+
+// -----------------------------------------------------------------------------
+// 1 / sum as a Q0.31 scale and a power-of-two exponent (TFLite GetReciprocal)
+static int32_t get_reciprocal(int32_t sum, int32_t *num_bits_over_unit)
+{
+    int32_t headroom_plus_one = __builtin_clz((uint32_t)sum);
+    *num_bits_over_unit = SOFTMAX_ACCUM_INTEGER_BITS - headroom_plus_one;
+    int32_t shifted_sum_minus_one = (int32_t)(((uint32_t)sum << headroom_plus_one) - (1u << 31));
+    return one_over_one_plus_x_for_x_in_0_1(shifted_sum_minus_one);
+}
+
+// -----------------------------------------------------------------------------
+// rounding right shift that also covers exponents >= 31, reached once the sum
+// of exponentials passes 2^8 (where TFLM's RoundingDivideByPOT is undefined;
+// every output rounds to the zero-point there anyway)
+static inline int32_t rounding_divide_by_pot_wide(int32_t x, int32_t exponent)
+{
+    int64_t mask = (1ll << exponent) - 1;
+    int64_t remainder = x & mask;
+    int64_t threshold = (mask >> 1) + ((x < 0) ? 1 : 0);
+    return (int32_t)(((int64_t)x >> exponent) + (remainder > threshold ? 1 : 0));
+}
+
+// -----------------------------------------------------------------------------
+// (logit - max_logit) * beta * input_scale in Q5.26
+static inline int32_t scaled_diff(int32_t diff, const softmax_params_t *params)
+{
+    return saturating_rounding_doubling_high_mul_exact(diff * (1 << params->input_left_shift), params->input_multiplier);
+}
+
+// -----------------------------------------------------------------------------
+int softmax_prepare(double input_scale, double beta, softmax_params_t *params)
+{
+    double real = beta * input_scale * (double)(1ll << (31 - SOFTMAX_DIFF_INTEGER_BITS));
+    if (!(real > 0.0))
+    {
+        return -1;
+    }
+    if (real > (double)INT32_MAX)
+    {
+        real = (double)INT32_MAX;
+    }
+
+    int exponent;
+    double fraction = frexp(real, &exponent);
+    int64_t q = llround(ldexp(fraction, 31));
+    if (q == (1ll << 31))
+    {
+        q /= 2;
+        ++exponent;
+    }
+
+    // the kernel only shifts left: TFLite's QuantizeMultiplierGreaterThanOne
+    if (exponent < 0 || exponent > 30)
+    {
+        return -1;
+    }
+
+    params->input_multiplier = (int32_t)q;
+    params->input_left_shift = exponent;
+
+    // largest |diff| whose rescaled value still fits Q5.26 (CalculateInputRadius)
+    double radius = ldexp((double)((1 << SOFTMAX_DIFF_INTEGER_BITS) - 1), 31 - SOFTMAX_DIFF_INTEGER_BITS - exponent);
+    params->diff_min = -(int32_t)floor(radius);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// int8 softmax, bit-exact with TFLite/TFLM reference_ops::Softmax:
+//   1) find max logit
+//   2) sum e^((logit - max) * beta * scale) in Q12.19, skipping logits below
+//      diff_min (they round to 0 anyway)
+//   3) out = e^(...) / sum, rescaled to 1/256 units, shifted by -128
+// two passes over the inputs and no scratch, so any length works; the sum
+// saturates instead of wrapping past 4096 maximal logits (TFLM overflows
+// there); the second pass reads inputs[i] before writing outputs[i], so it
+// can run in place
+void softmax_int8(const int8_t *inputs, int8_t *outputs, uint32_t length, const softmax_params_t *params)
+{
+    // 1) find max
+    int8_t max_val = inputs[0];
+    for (uint32_t i = 1; i < length; ++i)
+    {
+        if (inputs[i] > max_val)
+        {
+            max_val = inputs[i];
+        }
+    }
+
+    // 2) sum of exponentials
+    int64_t sum_of_exps = 0;
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        int32_t diff = (int32_t)inputs[i] - (int32_t)max_val;
+        if (diff >= params->diff_min)
+        {
+            int32_t exp_val = exp_on_negative_values(scaled_diff(diff, params));
+            sum_of_exps += rounding_divide_by_pot(exp_val, SOFTMAX_ACCUM_INTEGER_BITS);
+        }
+    }
+
+    int32_t num_bits_over_unit;
+    int32_t shifted_scale = get_reciprocal((sum_of_exps > INT32_MAX) ? INT32_MAX : (int32_t)sum_of_exps, &num_bits_over_unit);
+
+    // 3) normalize
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        int32_t diff = (int32_t)inputs[i] - (int32_t)max_val;
+        if (diff >= params->diff_min)
+        {
+            int32_t exp_val = exp_on_negative_values(scaled_diff(diff, params));
+            int32_t unsat = rounding_divide_by_pot_wide(fixed_mul(shifted_scale, exp_val), num_bits_over_unit + 31 - 8);
+            outputs[i] = saturate_to_int8(unsat - 128);
+        }
+        else
+        {
+            outputs[i] = INT8_MIN;
+        }
+    }
+}
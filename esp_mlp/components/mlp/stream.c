@@ -0,0 +1,367 @@
+#include "stream.h"
+#include "container.h"
+#include "dense.h"
+#include "mlp_config.h"
+#include "params.h"
+#include "placement.h"
+#include "profile.h"
+#include "softmax.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// tensors read once into RAM; the hidden biases only serve the input-sparse
+// path, which streaming doesn't run
+static const uint16_t k_resident[] = {
+    MLP_TENSOR_HIDDEN_WEIGHT_ZPS,
+    MLP_TENSOR_HIDDEN_FOLDED_BIASES,
+    MLP_TENSOR_HIDDEN_MULTIPLIERS,
+    MLP_TENSOR_HIDDEN_SHIFTS,
+    MLP_TENSOR_OUTPUT_WEIGHT_ZPS,
+    MLP_TENSOR_OUTPUT_FOLDED_BIASES,
+    MLP_TENSOR_OUTPUT_MULTIPLIERS,
+    MLP_TENSOR_OUTPUT_SHIFTS,
+    MLP_TENSOR_SOFTMAX_PARAMS,
+};
+
+#define NUM_RESIDENT (sizeof(k_resident) / sizeof(k_resident[0]))
+
+// -----------------------------------------------------------------------------
+// tile t of a pass: the hidden weight tiles, then the output ones
+typedef struct
+{
+    int output;
+    uint32_t first;     // row (output channel)
+    uint32_t rows;
+    uint32_t offset;    // in the source
+    uint32_t size;
+} tile_t;
+
+// -----------------------------------------------------------------------------
+static void get_tile(const mlp_stream_t *stream, uint32_t t, tile_t *tile)
+{
+    uint32_t row_size = INPUT_SIZE;
+    uint32_t tile_rows = stream->hidden_rows;
+    uint32_t total_rows = HIDDEN_SIZE;
+    uint32_t base = stream->hidden_offset;
+
+    tile->output = (t >= stream->hidden_tiles);
+    if (tile->output)
+    {
+        t -= stream->hidden_tiles;
+        row_size = HIDDEN_SIZE;
+        tile_rows = stream->output_rows;
+        total_rows = OUTPUT_SIZE;
+        base = stream->output_offset;
+    }
+
+    tile->first = t * tile_rows;
+    tile->rows = (total_rows - tile->first < tile_rows) ? total_rows - tile->first : tile_rows;
+    tile->offset = base + tile->first * row_size;
+    tile->size = tile->rows * row_size;
+}
+
+// -----------------------------------------------------------------------------
+static int read_now(stream_io_t *io, uint32_t offset, void *data, uint32_t size)
+{
+    stream_io_start(io, offset, data, size);
+    return stream_io_wait(io);
+}
+
+// -----------------------------------------------------------------------------
+// weight zero-points, or NULL when they are all zero (as mlp_model_load)
+static const int8_t *weight_zps_or_null(const uint8_t *zps, uint32_t size)
+{
+    for (uint32_t i = 0; zps != NULL && i < size; ++i)
+    {
+        if (zps[i] != 0)
+        {
+            return (const int8_t *)zps;
+        }
+    }
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+// check the container in the source (size bytes) and read its resident
+// tensors; the first tile buffer serves as scratch for the CRC
+static int load_container(mlp_stream_t *stream, uint32_t size)
+{
+    mlp_container_header_t header;
+    if (size < sizeof(header) || read_now(stream->io, 0, &header, sizeof(header)) != 0 ||
+        header.header_size != sizeof(header) + header.tensor_count * sizeof(mlp_tensor_desc_t) ||
+        header.header_size > size)
+    {
+        return -1;
+    }
+
+    // header and tensor table back to back, as mlp_container_tensor wants them
+    uint8_t *table = malloc(header.header_size);
+    if (table == NULL)
+    {
+        return -1;
+    }
+    memcpy(table, &header, sizeof(header));
+    if (read_now(stream->io, sizeof(header), &table[sizeof(header)], header.header_size - sizeof(header)) != 0 ||
+        mlp_container_check(&header, (const mlp_tensor_desc_t *)&table[sizeof(header)], size) != 0 ||
+        mlp_container_tensor(table, MLP_TENSOR_HIDDEN_ACTIVATION) != NULL)
+    {
+        free(table);
+        return -1;
+    }
+
+    // 1) data CRC, a tile at a time
+    uint32_t crc = 0;
+    for (uint32_t offset = 0; offset < header.data_size; offset += stream->tile_size)
+    {
+        uint32_t chunk = (header.data_size - offset < stream->tile_size) ? header.data_size - offset : stream->tile_size;
+        if (read_now(stream->io, header.data_offset + offset, stream->tiles[0], chunk) != 0)
+        {
+            free(table);
+            return -1;
+        }
+        crc = mlp_container_crc32(crc, (const uint8_t *)stream->tiles[0], chunk);
+    }
+    if (crc != header.data_crc32)
+    {
+        free(table);
+        return -1;
+    }
+
+    // 2) resident tensors, packed MLP_CONTAINER_ALIGN-aligned
+    const uint8_t *resident[MLP_TENSOR_ID_COUNT] = {NULL};
+    stream->resident_size = 0;
+    for (uint32_t r = 0; r < NUM_RESIDENT; ++r)
+    {
+        const mlp_tensor_desc_t *tensor = mlp_container_tensor(table, k_resident[r]);
+        stream->resident_size += (tensor != NULL) ? MLP_CONTAINER_ALIGN_UP(tensor->size) : 0;
+    }
+    stream->resident = mlp_region_alloc(MLP_PLACE_DRAM, stream->resident_size);
+    if (stream->resident == NULL)
+    {
+        free(table);
+        return -1;
+    }
+    uint32_t used = 0;
+    for (uint32_t r = 0; r < NUM_RESIDENT; ++r)
+    {
+        const mlp_tensor_desc_t *tensor = mlp_container_tensor(table, k_resident[r]);
+        if (tensor == NULL)
+        {
+            continue;
+        }
+        if (read_now(stream->io, header.data_offset + tensor->offset, &stream->resident[used], tensor->size) != 0)
+        {
+            free(table);
+            return -1;
+        }
+        resident[k_resident[r]] = &stream->resident[used];
+        used += MLP_CONTAINER_ALIGN_UP(tensor->size);
+    }
+
+    // 3) the weights stay in the source
+    stream->hidden_offset = header.data_offset + mlp_container_tensor(table, MLP_TENSOR_HIDDEN_WEIGHTS)->offset;
+    stream->output_offset = header.data_offset + mlp_container_tensor(table, MLP_TENSOR_OUTPUT_WEIGHTS)->offset;
+    free(table);
+
+    mlp_model_t *model = &stream->model;
+    memset(model, 0, sizeof(*model));
+    model->hidden_weight_zps = weight_zps_or_null(resident[MLP_TENSOR_HIDDEN_WEIGHT_ZPS], HIDDEN_SIZE);
+    model->hidden_folded_biases = (const int32_t *)resident[MLP_TENSOR_HIDDEN_FOLDED_BIASES];
+    model->hidden_multipliers = (const uint32_t *)resident[MLP_TENSOR_HIDDEN_MULTIPLIERS];
+    model->hidden_shifts = (const int32_t *)resident[MLP_TENSOR_HIDDEN_SHIFTS];
+    model->output_weight_zps = weight_zps_or_null(resident[MLP_TENSOR_OUTPUT_WEIGHT_ZPS], OUTPUT_SIZE);
+    model->output_folded_biases = (const int32_t *)resident[MLP_TENSOR_OUTPUT_FOLDED_BIASES];
+    model->output_multipliers = (const uint32_t *)resident[MLP_TENSOR_OUTPUT_MULTIPLIERS];
+    model->output_shifts = (const int32_t *)resident[MLP_TENSOR_OUTPUT_SHIFTS];
+    model->softmax = (const softmax_params_t *)resident[MLP_TENSOR_SOFTMAX_PARAMS];
+    model->input_zp = header.input_zp;
+    model->hidden_zp = header.hidden_zp;
+    model->output_zp = header.output_zp;
+    model->hidden_epilogue.min = header.hidden_zp;
+    model->hidden_epilogue.max = INT8_MAX;
+    model->hidden_epilogue.lut = NULL;
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+int mlp_stream_open(mlp_stream_t *stream, const char *name, uint32_t tile_size)
+{
+    memset(stream, 0, sizeof(*stream));
+    if (CONFIG_MLP_PLAN_EXECUTOR || tile_size < INPUT_SIZE || tile_size < HIDDEN_SIZE)
+    {
+        return -1;
+    }
+
+    uint32_t size;
+    stream->io = stream_io_open(name, &size);
+    if (stream->io == NULL)
+    {
+        return -1;
+    }
+
+    stream->tile_size = tile_size;
+    stream->tiles[0] = mlp_region_alloc(MLP_PLACE_DRAM, tile_size);
+    stream->tiles[1] = mlp_region_alloc(MLP_PLACE_DRAM, tile_size);
+    if (stream->tiles[0] == NULL || stream->tiles[1] == NULL || load_container(stream, size) != 0)
+    {
+        mlp_stream_close(stream);
+        return -1;
+    }
+
+    stream->hidden_rows = (tile_size / INPUT_SIZE < HIDDEN_SIZE) ? tile_size / INPUT_SIZE : HIDDEN_SIZE;
+    stream->output_rows = (tile_size / HIDDEN_SIZE < OUTPUT_SIZE) ? tile_size / HIDDEN_SIZE : OUTPUT_SIZE;
+    stream->hidden_tiles = (HIDDEN_SIZE + stream->hidden_rows - 1) / stream->hidden_rows;
+    stream->output_tiles = (OUTPUT_SIZE + stream->output_rows - 1) / stream->output_rows;
+
+    // the first tile of the first pass
+    tile_t tile;
+    get_tile(stream, 0, &tile);
+    stream->next = 0;
+    stream_io_start(stream->io, tile.offset, stream->tiles[0], tile.size);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// hidden output channels [tile->first, tile->first + tile->rows) (dense+ReLU)
+// over the tile's weights
+static void hidden_tile(const mlp_model_t *model, const tile_t *tile, const int8_t *weights, const int8_t *inputs, int8_t *hiddens)
+{
+    uint32_t first = tile->first;
+    const int8_t *hidden_weight_zps = (model->hidden_weight_zps != NULL) ? &model->hidden_weight_zps[first] : NULL;
+
+#if DENSE_SIMD_PIE
+    dense_int8_simd_fused(
+        inputs,
+        weights,
+        hidden_weight_zps,
+        &model->hidden_folded_biases[first],
+        &hiddens[first],
+        model->hidden_zp,
+        &model->hidden_multipliers[first],
+        &model->hidden_shifts[first],
+        &model->hidden_epilogue,
+        INPUT_SIZE,
+        tile->rows);
+#else
+    dense_int8_fused(
+        inputs,
+        weights,
+        hidden_weight_zps,
+        &model->hidden_folded_biases[first],
+        &hiddens[first],
+        model->hidden_zp,
+        &model->hidden_multipliers[first],
+        &model->hidden_shifts[first],
+        &model->hidden_epilogue,
+        INPUT_SIZE,
+        tile->rows);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// logits [tile->first, tile->first + tile->rows) over the tile's weights
+static void output_tile(const mlp_model_t *model, const tile_t *tile, const int8_t *weights, const int8_t *hiddens, int8_t *logits)
+{
+    uint32_t first = tile->first;
+    const int8_t *output_weight_zps = (model->output_weight_zps != NULL) ? &model->output_weight_zps[first] : NULL;
+
+#if DENSE_SIMD_PIE
+    dense_int8_simd(
+        hiddens,
+        weights,
+        output_weight_zps,
+        &model->output_folded_biases[first],
+        &logits[first],
+        model->output_zp,
+        &model->output_multipliers[first],
+        &model->output_shifts[first],
+        HIDDEN_SIZE,
+        tile->rows);
+#else
+    dense_int8_folded(
+        hiddens,
+        weights,
+        output_weight_zps,
+        &model->output_folded_biases[first],
+        &logits[first],
+        model->output_zp,
+        &model->output_multipliers[first],
+        &model->output_shifts[first],
+        HIDDEN_SIZE,
+        tile->rows);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// every tile is waited for, then the loader moves on to the following one
+// (after the last: the first of the next pass) in the other buffer while the
+// kernel runs on this one
+int mlp_stream_forward(mlp_stream_t *stream, const int8_t *inputs, int8_t *outputs)
+{
+    int8_t hiddens[HIDDEN_SIZE] __attribute__((aligned(16)));
+    const mlp_model_t *model = &stream->model;
+    uint32_t count = stream->hidden_tiles + stream->output_tiles;
+    uint32_t current = stream->next;
+    int result = 0;
+    tile_t tile, next;
+
+    MLP_PROFILE_BEGIN(MLP_SCOPE_FORWARD);
+
+    get_tile(stream, 0, &tile);
+    for (uint32_t t = 0; t < count; ++t)
+    {
+        result |= stream_io_wait(stream->io);
+        get_tile(stream, (t + 1) % count, &next);
+        stream_io_start(stream->io, next.offset, stream->tiles[current ^ 1], next.size);
+
+        MLP_PROFILE_BEGIN(kernel);
+        if (!tile.output)
+        {
+            hidden_tile(model, &tile, stream->tiles[current], inputs, hiddens);
+        }
+        else
+        {
+            output_tile(model, &tile, stream->tiles[current], hiddens, outputs);
+        }
+        MLP_PROFILE_END_AS(kernel, tile.output ? MLP_SCOPE_DENSE2 : MLP_SCOPE_DENSE1, 0);
+
+        tile = next;
+        current ^= 1;
+    }
+    stream->next = current;
+
+    MLP_PROFILE_BEGIN(MLP_SCOPE_SOFTMAX);
+    softmax_int8(outputs, outputs, OUTPUT_SIZE, model->softmax);
+    MLP_PROFILE_END(MLP_SCOPE_SOFTMAX);
+
+    MLP_PROFILE_END(MLP_SCOPE_FORWARD);
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+void mlp_stream_close(mlp_stream_t *stream)
+{
+    if (stream->io != NULL)
+    {
+        // the first tile of the pass that never came
+        if (stream->hidden_tiles > 0)
+        {
+            stream_io_wait(stream->io);
+        }
+        stream_io_close(stream->io);
+    }
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        if (stream->tiles[i] != NULL)
+        {
+            mlp_region_free(MLP_PLACE_DRAM, stream->tiles[i], stream->tile_size);
+        }
+    }
+    if (stream->resident != NULL)
+    {
+        mlp_region_free(MLP_PLACE_DRAM, stream->resident, stream->resident_size);
+    }
+    memset(stream, 0, sizeof(*stream));
+}
@@ -0,0 +1,115 @@
+#include "stream_io.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// -----------------------------------------------------------------------------
+// host stand-in for stream_io_partition.c: a file read with pread on a
+// loader thread, the task notifications become two semaphores
+struct stream_io
+{
+    int fd;
+    pthread_t thread;
+    sem_t start;
+    sem_t done;
+    uint32_t offset;
+    void *data;
+    uint32_t size;      // 0 stops the loader
+    int result;
+};
+
+// -----------------------------------------------------------------------------
+static void sem_wait_all(sem_t *sem)
+{
+    // sem_wait returns early when a signal interrupts it
+    while (sem_wait(sem) != 0)
+    {
+    }
+}
+
+// -----------------------------------------------------------------------------
+static void *loader_thread(void *arg)
+{
+    stream_io_t *io = (stream_io_t *)arg;
+    for (;;)
+    {
+        sem_wait_all(&io->start);
+        if (io->size == 0)
+        {
+            return NULL;
+        }
+
+        io->result = 0;
+        uint8_t *data = (uint8_t *)io->data;
+        for (uint32_t done = 0; done < io->size;)
+        {
+            ssize_t n = pread(io->fd, &data[done], io->size - done, (off_t)io->offset + done);
+            if (n <= 0)
+            {
+                io->result = -1;
+                break;
+            }
+            done += (uint32_t)n;
+        }
+        sem_post(&io->done);
+    }
+}
+
+// -----------------------------------------------------------------------------
+stream_io_t *stream_io_open(const char *name, uint32_t *size)
+{
+    stream_io_t *io = calloc(1, sizeof(stream_io_t));
+    if (io == NULL)
+    {
+        return NULL;
+    }
+
+    struct stat st;
+    io->fd = open(name, O_RDONLY);
+    if (io->fd < 0 || fstat(io->fd, &st) != 0 || st.st_size > UINT32_MAX ||
+        sem_init(&io->start, 0, 0) != 0 || sem_init(&io->done, 0, 0) != 0 ||
+        pthread_create(&io->thread, NULL, loader_thread, io) != 0)
+    {
+        if (io->fd >= 0)
+        {
+            close(io->fd);
+        }
+        free(io);
+        return NULL;
+    }
+
+    *size = (uint32_t)st.st_size;
+    return io;
+}
+
+// -----------------------------------------------------------------------------
+void stream_io_close(stream_io_t *io)
+{
+    io->size = 0;
+    sem_post(&io->start);
+    pthread_join(io->thread, NULL);
+    sem_destroy(&io->start);
+    sem_destroy(&io->done);
+    close(io->fd);
+    free(io);
+}
+
+// -----------------------------------------------------------------------------
+void stream_io_start(stream_io_t *io, uint32_t offset, void *data, uint32_t size)
+{
+    io->offset = offset;
+    io->data = data;
+    io->size = size;
+    sem_post(&io->start);
+}
+
+// -----------------------------------------------------------------------------
+int stream_io_wait(stream_io_t *io)
+{
+    sem_wait_all(&io->done);
+    return io->result;
+}
@@ -0,0 +1,128 @@
+#include "stream_io.h"
+#include "mlp_config.h"
+
+#include "esp_partition.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// a loader task per source, pinned to CONFIG_MLP_STREAM_LOADER_CORE: started
+// with a direct task notification, done through a semaphore (the caller's
+// own notification may belong to the dual-core worker); the partition is
+// mapped once and the loader copies out of the mapping, so the flash cache
+// stays on and the other core keeps running from flash while it copies
+// (esp_partition_read would turn the cache off for every read and stall it)
+struct stream_io
+{
+    const esp_partition_t *partition;
+    const uint8_t *mapping;
+    esp_partition_mmap_handle_t handle;
+    TaskHandle_t task;
+    SemaphoreHandle_t done;
+    uint32_t offset;
+    void *data;
+    uint32_t size;      // 0 stops the loader
+    int result;
+};
+
+// -----------------------------------------------------------------------------
+static void loader_task(void *arg)
+{
+    stream_io_t *io = (stream_io_t *)arg;
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (io->size == 0)
+        {
+            break;
+        }
+
+        // through the flash cache, which the copy competes for with the
+        // kernel's own misses
+        io->result = -1;
+        if ((uint64_t)io->offset + io->size <= io->partition->size)
+        {
+            memcpy(io->data, &io->mapping[io->offset], io->size);
+            io->result = 0;
+        }
+        xSemaphoreGive(io->done);
+    }
+
+    xSemaphoreGive(io->done);
+    vTaskDelete(NULL);
+}
+
+// -----------------------------------------------------------------------------
+stream_io_t *stream_io_open(const char *name, uint32_t *size)
+{
+    stream_io_t *io = calloc(1, sizeof(stream_io_t));
+    if (io == NULL)
+    {
+        return NULL;
+    }
+
+    const void *mapping = NULL;
+    io->partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, name);
+    if (io->partition == NULL ||
+        esp_partition_mmap(io->partition, 0, io->partition->size, ESP_PARTITION_MMAP_DATA, &mapping, &io->handle) != ESP_OK)
+    {
+        free(io);
+        return NULL;
+    }
+    io->mapping = (const uint8_t *)mapping;
+
+    io->done = xSemaphoreCreateBinary();
+    if (io->done == NULL ||
+        xTaskCreatePinnedToCore(
+            loader_task,
+            "mlp_loader",
+            CONFIG_MLP_STREAM_LOADER_STACK_SIZE,
+            io,
+            CONFIG_MLP_STREAM_LOADER_PRIORITY,
+            &io->task,
+            CONFIG_MLP_STREAM_LOADER_CORE) != pdPASS)
+    {
+        if (io->done != NULL)
+        {
+            vSemaphoreDelete(io->done);
+        }
+        esp_partition_munmap(io->handle);
+        free(io);
+        return NULL;
+    }
+
+    *size = (uint32_t)io->partition->size;
+    return io;
+}
+
+// -----------------------------------------------------------------------------
+void stream_io_close(stream_io_t *io)
+{
+    io->size = 0;
+    xTaskNotifyGive(io->task);
+    xSemaphoreTake(io->done, portMAX_DELAY);
+    vSemaphoreDelete(io->done);
+    esp_partition_munmap(io->handle);
+    free(io);
+}
+
+// -----------------------------------------------------------------------------
+void stream_io_start(stream_io_t *io, uint32_t offset, void *data, uint32_t size)
+{
+    io->offset = offset;
+    io->data = data;
+    io->size = size;
+    xTaskNotifyGive(io->task);
+}
+
+// -----------------------------------------------------------------------------
+int stream_io_wait(stream_io_t *io)
+{
+    xSemaphoreTake(io->done, portMAX_DELAY);
+    return io->result;
+}
@@ -0,0 +1,57 @@
+#include "worker.h"
+#include "mlp_config.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <stdlib.h>
+
+// -----------------------------------------------------------------------------
+// the caller and the worker hand the job back and forth with direct task
+// notifications: no queue, no semaphore
+static TaskHandle_t g_worker = NULL;
+static TaskHandle_t g_caller = NULL;
+static mlp_worker_fn g_fn = NULL;
+static void *g_arg = NULL;
+
+// -----------------------------------------------------------------------------
+static void worker_task(void *unused)
+{
+    (void)unused;
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        g_fn(g_arg);
+        xTaskNotifyGive(g_caller);
+    }
+}
+
+// -----------------------------------------------------------------------------
+void mlp_worker_run(mlp_worker_fn fn, void *arg)
+{
+    if (g_worker == NULL)
+    {
+        if (xTaskCreatePinnedToCore(
+                worker_task,
+                "mlp_worker",
+                CONFIG_MLP_WORKER_STACK_SIZE,
+                NULL,
+                CONFIG_MLP_WORKER_PRIORITY,
+                &g_worker,
+                CONFIG_MLP_WORKER_CORE) != pdPASS)
+        {
+            abort();
+        }
+    }
+
+    g_caller = xTaskGetCurrentTaskHandle();
+    g_fn = fn;
+    g_arg = arg;
+    xTaskNotifyGive(g_worker);
+}
+
+// -----------------------------------------------------------------------------
+void mlp_worker_join(void)
+{
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
@@ -0,0 +1,59 @@
+#include "worker.h"
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdlib.h>
+
+// -----------------------------------------------------------------------------
+// host stand-in for worker_freertos.c: one persistent thread, the two task
+// notifications become two semaphores
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static sem_t g_start;
+static sem_t g_done;
+static mlp_worker_fn g_fn = NULL;
+static void *g_arg = NULL;
+
+// -----------------------------------------------------------------------------
+static void *worker_thread(void *unused)
+{
+    (void)unused;
+    for (;;)
+    {
+        while (sem_wait(&g_start) != 0)
+        {
+        }
+        g_fn(g_arg);
+        sem_post(&g_done);
+    }
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+static void worker_create(void)
+{
+    pthread_t thread;
+    if (sem_init(&g_start, 0, 0) != 0 || sem_init(&g_done, 0, 0) != 0 ||
+        pthread_create(&thread, NULL, worker_thread, NULL) != 0)
+    {
+        abort();
+    }
+    pthread_detach(thread);
+}
+
+// -----------------------------------------------------------------------------
+void mlp_worker_run(mlp_worker_fn fn, void *arg)
+{
+    pthread_once(&g_once, worker_create);
+    g_fn = fn;
+    g_arg = arg;
+    sem_post(&g_start);
+}
+
+// -----------------------------------------------------------------------------
+void mlp_worker_join(void)
+{
+    // sem_wait returns early when a signal interrupts it
+    while (sem_wait(&g_done) != 0)
+    {
+    }
+}
@@ -0,0 +1,3561 @@
+#include "container.h"
+#include "container_build.h"
+#include "delta.h"
+#include "dense.h"
+#include "dense_static.h"
+#include "input.h"
+#include "mlp.h"
+#include "params.h"
+#include "placement.h"
+#include "plan.h"
+#include "profile.h"
+#if CONFIG_MLP_HIDDEN_BLOCK_SPARSE
+#include "params_block_sparse.h"
+#endif
+#if CONFIG_MLP_HIDDEN_CODEBOOK
+#include "params_codebook.h"
+#endif
+#if CONFIG_MLP_SCHEDULER
+#include "scheduler.h"
+#endif
+#include "softmax.h"
+#include "stream.h"
+
+#include <inttypes.h>
+#include <math.h>
+#if CONFIG_MLP_SCHEDULER
+#include <semaphore.h>
+#endif
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_ROUNDS  1000
+#define WARMUP_ROUNDS   10
+#define NUM_SAMPLES     10
+#define SWEEP_ITERATIONS 200
+#define RANDOM_SHAPES   200
+#define MAX_RANDOM_INPUT_SIZE   1024
+#define MAX_RANDOM_OUTPUT_SIZE  64
+#define CHECK_BLOCK_SPARSITY    50
+#define PLAN_TEST_LAYERS        4
+#define PLAN_TEST_BLOB_SIZE     (64 * 1024)
+#define PLAN_TEST_ARENA_SIZE    256
+#define MAX_SOFTMAX_LENGTH      1000
+#define DUAL_CORE_CHECK_ROUNDS  1000
+#define SCHEDULER_BURST         100
+#define DELTA_CHECK_FRAMES      300
+#define COLD_ITERATIONS         100
+#define EVICT_SIZE              (64u << 20)
+#define LOGITS_SCALE            0.21290959417819977 // model.tflite, float32
+
+static const unsigned char *g_samples[NUM_SAMPLES] = {
+    g_zero_input,
+    g_one_input,
+    g_two_input,
+    g_three_input,
+    g_four_input,
+    g_five_input,
+    g_six_input,
+    g_seven_input,
+    g_eight_input,
+    g_nine_input,
+};
+
+static int8_t g_inputs[NUM_SAMPLES][INPUT_SIZE] __attribute__((aligned(16)));
+static int8_t g_hidden_weights_colmajor[HIDDEN_WEIGHT_SIZE];
+static int8_t g_hidden_weights_packed[DENSE_PACKED_SIZE(INPUT_SIZE, HIDDEN_SIZE)];
+static int8_t g_output_weights_packed[DENSE_PACKED_SIZE(HIDDEN_SIZE, OUTPUT_SIZE)];
+static uint8_t g_hidden_weights_int4[DENSE_INT4_SIZE(INPUT_SIZE, HIDDEN_SIZE)];
+static int8_t g_hidden_weights_int4_unpacked[HIDDEN_WEIGHT_SIZE];
+static int32_t g_hidden_int4_folded_biases[HIDDEN_SIZE];
+static uint32_t g_hidden_int4_multipliers[HIDDEN_SIZE];
+static int32_t g_hidden_int4_shifts[HIDDEN_SIZE];
+static uint8_t g_hidden_block_mask[DENSE_SPARSE_MAX_BLOCKS(INPUT_SIZE, HIDDEN_SIZE)];
+static int8_t g_hidden_weights_pruned[HIDDEN_WEIGHT_SIZE];
+static uint32_t g_hidden_block_row_ptr[HIDDEN_SIZE + 1];
+static uint16_t g_hidden_block_cols[DENSE_SPARSE_MAX_BLOCKS(INPUT_SIZE, HIDDEN_SIZE)];
+static int8_t g_hidden_block_values[DENSE_SPARSE_MAX_BLOCKS(INPUT_SIZE, HIDDEN_SIZE) * DENSE_SPARSE_BLOCK];
+static int32_t g_hidden_block_folded_biases[HIDDEN_SIZE];
+
+typedef struct
+{
+    uint32_t centroid_count;
+    uint8_t indices[DENSE_CODEBOOK_SIZE(INPUT_SIZE, HIDDEN_SIZE, DENSE_CODEBOOK_MAX_CENTROIDS)];
+    int16_t centroids[HIDDEN_SIZE * DENSE_CODEBOOK_MAX_CENTROIDS];
+    int32_t folded_biases[HIDDEN_SIZE];
+    int8_t decoded[HIDDEN_WEIGHT_SIZE];
+} codebook_t;
+
+static codebook_t g_codebook16 = {.centroid_count = 16};
+static codebook_t g_codebook32 = {.centroid_count = 32};
+
+typedef void (*forward_fn)(const int8_t *inputs, int8_t *outputs);
+
+typedef struct
+{
+    const char *name;
+    forward_fn forward;
+} variant_t;
+
+typedef struct
+{
+    uint64_t min;
+    uint64_t median;
+    uint64_t p99;
+} stats_t;
+
+// -----------------------------------------------------------------------------
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// -----------------------------------------------------------------------------
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// -----------------------------------------------------------------------------
+// nearest-rank percentile over sorted samples
+static uint64_t percentile(const uint64_t *sorted, uint32_t count, uint32_t pct)
+{
+    uint32_t rank = (uint32_t)(((uint64_t)pct * count + 99) / 100);
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+    return sorted[rank - 1];
+}
+
+// -----------------------------------------------------------------------------
+static stats_t compute_stats(uint64_t *samples, uint32_t count)
+{
+    qsort(samples, count, sizeof(uint64_t), compare_u64);
+
+    stats_t stats = {
+        .min = samples[0],
+        .median = percentile(samples, count, 50),
+        .p99 = percentile(samples, count, 99),
+    };
+    return stats;
+}
+
+// -----------------------------------------------------------------------------
+// reference hidden layer: the original dense_relu_int8 over raw g_params
+static void reference_hidden(const int8_t *inputs, int8_t *hiddens)
+{
+    dense_relu_int8(
+        inputs,
+        (int8_t)g_params[INPUT_ZP_OFFSET],
+        (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+        (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+        (const int32_t *)&g_params[HIDDEN_BIAS_OFFSET],
+        hiddens,
+        (int8_t)g_params[HIDDEN_ZP_OFFSET],
+        (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+        (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+}
+
+// -----------------------------------------------------------------------------
+// reference output layer: the original dense_int8 over raw g_params
+static void reference_logits(const int8_t *hiddens, int8_t *logits)
+{
+    dense_int8(
+        hiddens,
+        (int8_t)g_params[HIDDEN_ZP_OFFSET],
+        (const int8_t *)&g_params[OUTPUT_WEIGHT_OFFSET],
+        (const int8_t *)&g_params[OUTPUT_WEIGHT_ZP_OFFSET],
+        (const int32_t *)&g_params[OUTPUT_BIAS_OFFSET],
+        logits,
+        (int8_t)g_params[OUTPUT_ZP_OFFSET],
+        (const uint32_t *)&g_params[LAYER2_MULTIPLIER_OFFSET],
+        (const int32_t *)&g_params[LAYER2_SCALE_OFFSET],
+        HIDDEN_SIZE,
+        OUTPUT_SIZE);
+}
+
+// -----------------------------------------------------------------------------
+static void reference_softmax(int8_t *logits)
+{
+    softmax_int8(logits, logits, OUTPUT_SIZE, (const softmax_params_t *)&g_params[SOFTMAX_PARAMS_OFFSET]);
+}
+
+// -----------------------------------------------------------------------------
+static void reference_forward(const int8_t *inputs, int8_t *outputs)
+{
+    int8_t hiddens[HIDDEN_SIZE];
+    reference_hidden(inputs, hiddens);
+    reference_logits(hiddens, outputs);
+    reference_softmax(outputs);
+}
+
+// -----------------------------------------------------------------------------
+// dense copy of weights with the blocks pruned by mask zeroed
+static void apply_block_mask(const int8_t *weights, const uint8_t *mask, int8_t *pruned, uint32_t input_size, uint32_t output_size)
+{
+    uint32_t row_blocks = DENSE_SPARSE_ROW_BLOCKS(input_size);
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            int keep = mask[oc * row_blocks + ic / DENSE_SPARSE_BLOCK] != 0;
+            pruned[oc * input_size + ic] = keep ? weights[oc * input_size + ic] : 0;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// block-sparse weights expanded back to dense row-major
+static void decode_block_sparse(const uint32_t *row_ptr, const uint16_t *block_cols, const int8_t *values, int8_t *weights, uint32_t input_size, uint32_t output_size)
+{
+    memset(weights, 0, input_size * output_size);
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        for (uint32_t b = row_ptr[oc]; b < row_ptr[oc + 1]; ++b)
+        {
+            uint32_t ic0 = (uint32_t)block_cols[b] * DENSE_SPARSE_BLOCK;
+            for (uint32_t j = 0; j < DENSE_SPARSE_BLOCK && ic0 + j < input_size; ++j)
+            {
+                weights[oc * input_size + ic0 + j] = values[b * DENSE_SPARSE_BLOCK + j];
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// prune the hidden layer to sparsity_pct and encode it into g_hidden_block_*
+static uint32_t prepare_block_sparse(uint32_t sparsity_pct)
+{
+    const int8_t *weights = (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET];
+
+    dense_prune_blocks(weights, g_hidden_block_mask, sparsity_pct, INPUT_SIZE, HIDDEN_SIZE);
+    apply_block_mask(weights, g_hidden_block_mask, g_hidden_weights_pruned, INPUT_SIZE, HIDDEN_SIZE);
+    return dense_encode_block_sparse(
+        weights,
+        (const int32_t *)&g_params[HIDDEN_BIAS_OFFSET],
+        (int8_t)g_params[INPUT_ZP_OFFSET],
+        g_hidden_block_mask,
+        g_hidden_block_row_ptr,
+        g_hidden_block_cols,
+        g_hidden_block_values,
+        g_hidden_block_folded_biases,
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+}
+
+// -----------------------------------------------------------------------------
+// block-sparse hidden layer over g_hidden_block_*
+static void block_sparse_hidden(const int8_t *inputs, int8_t *hiddens)
+{
+    dense_epilogue_t relu = {(int8_t)g_params[HIDDEN_ZP_OFFSET], INT8_MAX, NULL};
+
+    dense_int8_block_sparse_fused(
+        inputs,
+        g_hidden_block_row_ptr,
+        g_hidden_block_cols,
+        g_hidden_block_values,
+        g_hidden_block_folded_biases,
+        hiddens,
+        (int8_t)g_params[HIDDEN_ZP_OFFSET],
+        (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+        (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+        &relu,
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+}
+
+// -----------------------------------------------------------------------------
+// codebook weights expanded back to dense row-major int8 (centroid plus weight
+// zero-point)
+static void decode_codebook(const uint8_t *indices, const int16_t *centroids, uint32_t centroid_count, const int8_t *weight_zps, int8_t *weights, uint32_t input_size, uint32_t output_size)
+{
+    uint32_t bits = DENSE_CODEBOOK_BITS(centroid_count);
+    uint32_t row_bytes = DENSE_CODEBOOK_ROW_SIZE(input_size, centroid_count);
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        const uint8_t *row = &indices[oc * row_bytes];
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            uint32_t bit = ic * bits;
+            uint32_t v = row[bit / 8];
+            if ((bit % 8) + bits > 8)
+            {
+                v |= (uint32_t)row[bit / 8 + 1] << 8;
+            }
+            uint32_t k = (v >> (bit % 8)) & ((1u << bits) - 1);
+            weights[oc * input_size + ic] = (int8_t)(centroids[oc * centroid_count + k] + weight_zps[oc]);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+static int prepare_codebook(codebook_t *codebook)
+{
+    if (dense_cluster_weights(
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[HIDDEN_BIAS_OFFSET],
+            (int8_t)g_params[INPUT_ZP_OFFSET],
+            codebook->centroid_count,
+            codebook->indices,
+            codebook->centroids,
+            codebook->folded_biases,
+            INPUT_SIZE,
+            HIDDEN_SIZE) != 0)
+    {
+        return 1;
+    }
+    decode_codebook(
+        codebook->indices,
+        codebook->centroids,
+        codebook->centroid_count,
+        (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+        codebook->decoded,
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+static void codebook_hidden(const codebook_t *codebook, const int8_t *inputs, int8_t *hiddens)
+{
+    dense_epilogue_t relu = {(int8_t)g_params[HIDDEN_ZP_OFFSET], INT8_MAX, NULL};
+
+    dense_int8_codebook_fused(
+        inputs,
+        codebook->indices,
+        codebook->centroids,
+        codebook->centroid_count,
+        codebook->folded_biases,
+        hiddens,
+        (int8_t)g_params[HIDDEN_ZP_OFFSET],
+        (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+        (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+        &relu,
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+}
+
+// -----------------------------------------------------------------------------
+static void codebook16_hidden(const int8_t *inputs, int8_t *hiddens)
+{
+    codebook_hidden(&g_codebook16, inputs, hiddens);
+}
+
+// -----------------------------------------------------------------------------
+static void codebook32_hidden(const int8_t *inputs, int8_t *hiddens)
+{
+    codebook_hidden(&g_codebook32, inputs, hiddens);
+}
+
+// -----------------------------------------------------------------------------
+// int4 hidden layer: dense_int8_int4w over the weights converted at startup
+static void int4_hidden(const int8_t *inputs, int8_t *hiddens)
+{
+    dense_epilogue_t relu = {(int8_t)g_params[HIDDEN_ZP_OFFSET], INT8_MAX, NULL};
+
+    dense_int8_int4w_fused(
+        inputs,
+        g_hidden_weights_int4,
+        g_hidden_int4_folded_biases,
+        hiddens,
+        (int8_t)g_params[HIDDEN_ZP_OFFSET],
+        g_hidden_int4_multipliers,
+        g_hidden_int4_shifts,
+        &relu,
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+}
+
+// -----------------------------------------------------------------------------
+static void int4_forward(const int8_t *inputs, int8_t *outputs)
+{
+    int8_t hiddens[HIDDEN_SIZE];
+    int4_hidden(inputs, hiddens);
+    reference_logits(hiddens, outputs);
+    reference_softmax(outputs);
+}
+
+#if CONFIG_MLP_HIDDEN_BLOCK_SPARSE
+// -----------------------------------------------------------------------------
+// generated block-sparse hidden layer decoded back to dense weights and run
+// through dense_int8_folded
+static void block_sparse_forward(const int8_t *inputs, int8_t *outputs)
+{
+    static int8_t weights[HIDDEN_WEIGHT_SIZE];
+    int8_t hiddens[HIDDEN_SIZE];
+
+    decode_block_sparse(
+        g_hidden_block_sparse_row_ptr,
+        g_hidden_block_sparse_cols,
+        g_hidden_block_sparse_values,
+        weights,
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+    dense_relu_int8_folded(
+        inputs,
+        weights,
+        NULL,
+        g_hidden_block_sparse_folded_biases,
+        hiddens,
+        (int8_t)g_params[HIDDEN_ZP_OFFSET],
+        (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+        (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+    reference_logits(hiddens, outputs);
+    reference_softmax(outputs);
+}
+#endif
+
+#if CONFIG_MLP_HIDDEN_CODEBOOK
+// -----------------------------------------------------------------------------
+// generated codebook hidden layer decoded back to dense weights and run
+// through dense_int8_folded
+static void codebook_forward(const int8_t *inputs, int8_t *outputs)
+{
+    static int8_t weights[HIDDEN_WEIGHT_SIZE];
+    int8_t hiddens[HIDDEN_SIZE];
+
+    decode_codebook(
+        g_hidden_codebook_indices,
+        g_hidden_codebook_centroids,
+        HIDDEN_CODEBOOK_CENTROIDS,
+        (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+        weights,
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+    dense_relu_int8_folded(
+        inputs,
+        weights,
+        (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+        g_hidden_codebook_folded_biases,
+        hiddens,
+        (int8_t)g_params[HIDDEN_ZP_OFFSET],
+        (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+        (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+    reference_logits(hiddens, outputs);
+    reference_softmax(outputs);
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// generic executor over the plan embedded in g_params
+static void plan_forward(const int8_t *inputs, int8_t *outputs)
+{
+    static const mlp_plan_t *plan = NULL;
+    int8_t arena[PLAN_ARENA_SIZE] __attribute__((aligned(16)));
+
+    if (plan == NULL)
+    {
+        plan = mlp_plan_get(g_params, PARAMS_SIZE, PLAN_OFFSET, PLAN_ARENA_SIZE);
+    }
+    mlp_plan_run(plan, g_params, arena, inputs, outputs);
+}
+
+// forward_pass must match the reference of whichever hidden layer it runs
+#if CONFIG_MLP_HIDDEN_INT4
+#define expected_forward int4_forward
+#elif CONFIG_MLP_HIDDEN_BLOCK_SPARSE
+#define expected_forward block_sparse_forward
+#elif CONFIG_MLP_HIDDEN_CODEBOOK
+#define expected_forward codebook_forward
+#else
+#define expected_forward reference_forward
+#endif
+
+// -----------------------------------------------------------------------------
+// top-1 class only (outputs[0]), with and without the early stop
+static void top1_forward(const int8_t *inputs, int8_t *outputs)
+{
+    uint32_t best;
+    forward_pass_topk(inputs, 1, 0, &best, NULL);
+    outputs[0] = (int8_t)best;
+}
+
+static void top1_early_forward(const int8_t *inputs, int8_t *outputs)
+{
+    uint32_t best;
+    forward_pass_topk(inputs, 1, 1, &best, NULL);
+    outputs[0] = (int8_t)best;
+}
+
+static const variant_t g_variants[] = {
+    {"reference", reference_forward},
+    {"int4", int4_forward},
+    {"plan", plan_forward},
+    {"forward_pass", forward_pass},
+    {"top1", top1_forward},
+    {"top1 early stop", top1_early_forward},
+};
+
+#define NUM_VARIANTS (sizeof(g_variants) / sizeof(g_variants[0]))
+
+// -----------------------------------------------------------------------------
+// int4 weights widened back to int8, so the int4 kernel can be checked
+// against dense_int8_folded
+static void unpack_int4(const uint8_t *int4_weights, int8_t *weights, uint32_t input_size, uint32_t output_size)
+{
+    uint32_t row_bytes = DENSE_INT4_ROW_SIZE(input_size);
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            uint8_t b = int4_weights[oc * row_bytes + ic / 2];
+            uint8_t nibble = (ic % 2) ? (uint8_t)(b >> 4) : (uint8_t)(b & 0xf);
+            weights[oc * input_size + ic] = (int8_t)((int8_t)(uint8_t)(nibble << 4) >> 4);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+static int check_equal(const char *what, uint32_t sample, const int8_t *expected, const int8_t *actual, uint32_t size)
+{
+    if (memcmp(expected, actual, size) != 0)
+    {
+        fprintf(stderr, "MISMATCH: %s on sample %" PRIu32 "\n", what, sample);
+        return 1;
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// layer-level checks: every kernel variant must be bit-exact with the
+// reference dense_int8 before it's timed
+static int check_kernels(void)
+{
+    dense_epilogue_t relu = {(int8_t)g_params[HIDDEN_ZP_OFFSET], INT8_MAX, NULL};
+    int failures = 0;
+
+    for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+    {
+        int8_t expected_hiddens[HIDDEN_SIZE];
+        int8_t hiddens[HIDDEN_SIZE];
+        int8_t expected_logits[OUTPUT_SIZE];
+        int8_t logits[OUTPUT_SIZE];
+
+        reference_hidden(g_inputs[s], expected_hiddens);
+        reference_logits(expected_hiddens, expected_logits);
+
+        dense_relu_int8_folded(
+            g_inputs[s],
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[HIDDEN_FOLDED_BIAS_OFFSET],
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        failures += check_equal("dense_relu_int8_folded", s, expected_hiddens, hiddens, HIDDEN_SIZE);
+
+        uint16_t indices[INPUT_SIZE];
+        int16_t values[INPUT_SIZE];
+        int32_t accumulators[HIDDEN_SIZE];
+        uint32_t count = dense_gather_nonzero(
+            g_inputs[s],
+            (int8_t)g_params[INPUT_ZP_OFFSET],
+            indices,
+            values,
+            INPUT_SIZE);
+
+        dense_int8_sparse_fused(
+            indices,
+            values,
+            count,
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[HIDDEN_BIAS_OFFSET],
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            &relu,
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        failures += check_equal("dense_int8_sparse_fused", s, expected_hiddens, hiddens, HIDDEN_SIZE);
+
+        dense_int8_sparse_colmajor_fused(
+            indices,
+            values,
+            count,
+            g_hidden_weights_colmajor,
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[HIDDEN_BIAS_OFFSET],
+            accumulators,
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            &relu,
+            HIDDEN_SIZE);
+        failures += check_equal("dense_int8_sparse_colmajor_fused", s, expected_hiddens, hiddens, HIDDEN_SIZE);
+
+        dense_int8_folded(
+            expected_hiddens,
+            (const int8_t *)&g_params[OUTPUT_WEIGHT_OFFSET],
+            (const int8_t *)&g_params[OUTPUT_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[OUTPUT_FOLDED_BIAS_OFFSET],
+            logits,
+            (int8_t)g_params[OUTPUT_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER2_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER2_SCALE_OFFSET],
+            HIDDEN_SIZE,
+            OUTPUT_SIZE);
+        failures += check_equal("dense_int8_folded", s, expected_logits, logits, OUTPUT_SIZE);
+
+        dense_int8_packed_fused(
+            g_inputs[s],
+            g_hidden_weights_packed,
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[HIDDEN_FOLDED_BIAS_OFFSET],
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            &relu,
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        failures += check_equal("dense_int8_packed_fused (hidden)", s, expected_hiddens, hiddens, HIDDEN_SIZE);
+
+        dense_int8_packed(
+            expected_hiddens,
+            g_output_weights_packed,
+            (const int8_t *)&g_params[OUTPUT_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[OUTPUT_FOLDED_BIAS_OFFSET],
+            logits,
+            (int8_t)g_params[OUTPUT_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER2_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER2_SCALE_OFFSET],
+            HIDDEN_SIZE,
+            OUTPUT_SIZE);
+        failures += check_equal("dense_int8_packed (output)", s, expected_logits, logits, OUTPUT_SIZE);
+
+        dense_int8_simd(
+            g_inputs[s],
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[HIDDEN_FOLDED_BIAS_OFFSET],
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        relu_int8_inplace(hiddens, (int8_t)g_params[HIDDEN_ZP_OFFSET], HIDDEN_SIZE);
+        failures += check_equal("dense_int8_simd (hidden)", s, expected_hiddens, hiddens, HIDDEN_SIZE);
+
+        dense_int8_simd(
+            expected_hiddens,
+            (const int8_t *)&g_params[OUTPUT_WEIGHT_OFFSET],
+            (const int8_t *)&g_params[OUTPUT_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[OUTPUT_FOLDED_BIAS_OFFSET],
+            logits,
+            (int8_t)g_params[OUTPUT_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER2_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER2_SCALE_OFFSET],
+            HIDDEN_SIZE,
+            OUTPUT_SIZE);
+        failures += check_equal("dense_int8_simd (output)", s, expected_logits, logits, OUTPUT_SIZE);
+
+        dense_static_hidden(
+            g_inputs[s],
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[HIDDEN_FOLDED_BIAS_OFFSET],
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            &relu);
+        failures += check_equal("dense_static_hidden", s, expected_hiddens, hiddens, HIDDEN_SIZE);
+
+        // the other hidden activations a plan can hand it: none, ReLU6, tanh
+        int8_t hidden_zp = (int8_t)g_params[HIDDEN_ZP_OFFSET];
+        int8_t lut[DENSE_LUT_SIZE];
+        dense_activation_lut(DENSE_LUT_TANH, 0.1f, hidden_zp, 1.0f / 128.0f, 0, lut);
+        const dense_epilogue_t activations[] = {
+            {INT8_MIN, INT8_MAX, NULL},
+            {hidden_zp, dense_relu6_max(0.1f, hidden_zp), NULL},
+            {INT8_MIN, INT8_MAX, lut},
+        };
+        for (uint32_t a = 0; a < sizeof(activations) / sizeof(activations[0]); ++a)
+        {
+            int8_t expected_activations[HIDDEN_SIZE];
+            dense_int8_fused(
+                g_inputs[s],
+                (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+                (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+                (const int32_t *)&g_params[HIDDEN_FOLDED_BIAS_OFFSET],
+                expected_activations,
+                hidden_zp,
+                (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+                (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+                &activations[a],
+                INPUT_SIZE,
+                HIDDEN_SIZE);
+            dense_static_hidden(
+                g_inputs[s],
+                (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+                (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+                (const int32_t *)&g_params[HIDDEN_FOLDED_BIAS_OFFSET],
+                hiddens,
+                hidden_zp,
+                (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+                (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+                &activations[a]);
+            failures += check_equal("dense_static_hidden (activations)", s, expected_activations, hiddens, HIDDEN_SIZE);
+        }
+
+        dense_static_output(
+            expected_hiddens,
+            (const int8_t *)&g_params[OUTPUT_WEIGHT_OFFSET],
+            NULL,
+            (const int32_t *)&g_params[OUTPUT_FOLDED_BIAS_OFFSET],
+            logits,
+            (int8_t)g_params[OUTPUT_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER2_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER2_SCALE_OFFSET]);
+        failures += check_equal("dense_static_output", s, expected_logits, logits, OUTPUT_SIZE);
+
+        // int4 against the folded kernel over the same weights widened to int8
+        dense_relu_int8_folded(
+            g_inputs[s],
+            g_hidden_weights_int4_unpacked,
+            NULL,
+            g_hidden_int4_folded_biases,
+            expected_hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            g_hidden_int4_multipliers,
+            g_hidden_int4_shifts,
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        int4_hidden(g_inputs[s], hiddens);
+        failures += check_equal("dense_int8_int4w", s, expected_hiddens, hiddens, HIDDEN_SIZE);
+
+        // block-sparse against dense_int8 over the pruned dense weights
+        dense_relu_int8(
+            g_inputs[s],
+            (int8_t)g_params[INPUT_ZP_OFFSET],
+            g_hidden_weights_pruned,
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[HIDDEN_BIAS_OFFSET],
+            expected_hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        block_sparse_hidden(g_inputs[s], hiddens);
+        failures += check_equal("dense_int8_block_sparse", s, expected_hiddens, hiddens, HIDDEN_SIZE);
+
+        // codebook against the folded kernel over the clustered weights
+        const codebook_t *codebooks[] = {&g_codebook16, &g_codebook32};
+        for (uint32_t c = 0; c < 2; ++c)
+        {
+            dense_relu_int8_folded(
+                g_inputs[s],
+                codebooks[c]->decoded,
+                (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+                codebooks[c]->folded_biases,
+                expected_hiddens,
+                (int8_t)g_params[HIDDEN_ZP_OFFSET],
+                (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+                (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+                INPUT_SIZE,
+                HIDDEN_SIZE);
+            codebook_hidden(codebooks[c], g_inputs[s], hiddens);
+            failures += check_equal(c == 0 ? "dense_int8_codebook (16)" : "dense_int8_codebook (32)", s, expected_hiddens, hiddens, HIDDEN_SIZE);
+        }
+    }
+
+    // block-sparse encoding round-trips to the pruned dense weights
+    static int8_t decoded[HIDDEN_WEIGHT_SIZE];
+    decode_block_sparse(g_hidden_block_row_ptr, g_hidden_block_cols, g_hidden_block_values, decoded, INPUT_SIZE, HIDDEN_SIZE);
+    failures += check_equal("dense_encode_block_sparse", 0, g_hidden_weights_pruned, decoded, HIDDEN_WEIGHT_SIZE);
+
+    // all samples as one batch: full register blocks plus a remainder
+    int8_t batch_hiddens[NUM_SAMPLES][HIDDEN_SIZE];
+    dense_int8_batch_fused(
+        &g_inputs[0][0],
+        NUM_SAMPLES,
+        (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+        (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+        (const int32_t *)&g_params[HIDDEN_FOLDED_BIAS_OFFSET],
+        &batch_hiddens[0][0],
+        (int8_t)g_params[HIDDEN_ZP_OFFSET],
+        (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+        (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+        &relu,
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+    for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+    {
+        int8_t expected_hiddens[HIDDEN_SIZE];
+        reference_hidden(g_inputs[s], expected_hiddens);
+        failures += check_equal("dense_int8_batch_fused", s, expected_hiddens, batch_hiddens[s], HIDDEN_SIZE);
+    }
+
+    return failures;
+}
+
+// -----------------------------------------------------------------------------
+static uint32_t next_random(uint32_t *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
+
+// -----------------------------------------------------------------------------
+// an epilogue run as separate steps over unfused outputs
+static void apply_epilogue(const dense_epilogue_t *epilogue, const int8_t *inputs, int8_t *outputs, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        int8_t y = inputs[i];
+        y = (y < epilogue->min) ? epilogue->min : ((y > epilogue->max) ? epilogue->max : y);
+        outputs[i] = (epilogue->lut != NULL) ? epilogue->lut[y - INT8_MIN] : y;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// folded-bias kernels vs. dense_int8 on random shapes and operands, including
+// non-zero weight zero-points and odd sizes that exercise the tails; the
+// _fused variants vs. the same epilogue run separately
+static int check_random_shapes(void)
+{
+    static int8_t inputs[MAX_RANDOM_INPUT_SIZE] __attribute__((aligned(16)));
+    static int8_t weights[MAX_RANDOM_OUTPUT_SIZE * MAX_RANDOM_INPUT_SIZE] __attribute__((aligned(16)));
+    static int8_t packed[DENSE_PACKED_SIZE(MAX_RANDOM_INPUT_SIZE, MAX_RANDOM_OUTPUT_SIZE)];
+    static int8_t transposed[MAX_RANDOM_INPUT_SIZE * MAX_RANDOM_OUTPUT_SIZE];
+    uint16_t indices[MAX_RANDOM_INPUT_SIZE];
+    int16_t values[MAX_RANDOM_INPUT_SIZE];
+    int32_t accumulators[MAX_RANDOM_OUTPUT_SIZE];
+    static uint8_t int4_weights[DENSE_INT4_SIZE(MAX_RANDOM_INPUT_SIZE, MAX_RANDOM_OUTPUT_SIZE)];
+    static int8_t int4_unpacked[MAX_RANDOM_OUTPUT_SIZE * MAX_RANDOM_INPUT_SIZE];
+    int32_t int4_folded_biases[MAX_RANDOM_OUTPUT_SIZE];
+    uint32_t int4_multipliers[MAX_RANDOM_OUTPUT_SIZE];
+    int32_t int4_shifts[MAX_RANDOM_OUTPUT_SIZE];
+    static uint8_t block_mask[DENSE_SPARSE_MAX_BLOCKS(MAX_RANDOM_INPUT_SIZE, MAX_RANDOM_OUTPUT_SIZE)];
+    static int8_t pruned[MAX_RANDOM_OUTPUT_SIZE * MAX_RANDOM_INPUT_SIZE];
+    static uint16_t block_cols[DENSE_SPARSE_MAX_BLOCKS(MAX_RANDOM_INPUT_SIZE, MAX_RANDOM_OUTPUT_SIZE)];
+    static int8_t block_values[DENSE_SPARSE_MAX_BLOCKS(MAX_RANDOM_INPUT_SIZE, MAX_RANDOM_OUTPUT_SIZE) * DENSE_SPARSE_BLOCK];
+    uint32_t block_row_ptr[MAX_RANDOM_OUTPUT_SIZE + 1];
+    static uint8_t codebook_indices[DENSE_CODEBOOK_SIZE(MAX_RANDOM_INPUT_SIZE, MAX_RANDOM_OUTPUT_SIZE, DENSE_CODEBOOK_MAX_CENTROIDS)];
+    static int16_t codebook_centroids[MAX_RANDOM_OUTPUT_SIZE * DENSE_CODEBOOK_MAX_CENTROIDS];
+    int8_t weight_zps[MAX_RANDOM_OUTPUT_SIZE];
+    int32_t biases[MAX_RANDOM_OUTPUT_SIZE];
+    int32_t folded_biases[MAX_RANDOM_OUTPUT_SIZE];
+    uint32_t multipliers[MAX_RANDOM_OUTPUT_SIZE];
+    int32_t shifts[MAX_RANDOM_OUTPUT_SIZE];
+    int8_t expected[MAX_RANDOM_OUTPUT_SIZE];
+    int8_t outputs[MAX_RANDOM_OUTPUT_SIZE];
+    int8_t lut[DENSE_LUT_SIZE];
+    uint32_t seed = 42;
+    int failures = 0;
+
+    dense_activation_lut(DENSE_LUT_TANH, 0.05f, 0, 1.0f / 128.0f, 0, lut);
+
+    for (uint32_t t = 0; t < RANDOM_SHAPES; ++t)
+    {
+        uint32_t input_size = 1 + next_random(&seed) % MAX_RANDOM_INPUT_SIZE;
+        uint32_t output_size = 1 + next_random(&seed) % MAX_RANDOM_OUTPUT_SIZE;
+        int8_t input_zp = (int8_t)next_random(&seed);
+        int8_t output_zp = (int8_t)next_random(&seed);
+        int symmetric = (t % 2) == 0;
+
+        for (uint32_t i = 0; i < input_size; ++i)
+        {
+            inputs[i] = (int8_t)next_random(&seed);
+        }
+        for (uint32_t i = 0; i < input_size * output_size; ++i)
+        {
+            weights[i] = (int8_t)next_random(&seed);
+        }
+        for (uint32_t oc = 0; oc < output_size; ++oc)
+        {
+            weight_zps[oc] = symmetric ? 0 : (int8_t)next_random(&seed);
+            biases[oc] = (int32_t)(next_random(&seed) % 2000000) - 1000000;
+            multipliers[oc] = (1u << 30) + next_random(&seed) % (1u << 30);
+            shifts[oc] = (int32_t)(next_random(&seed) % 16);
+        }
+
+        dense_int8(inputs, input_zp, weights, weight_zps, biases, expected, output_zp, multipliers, shifts, input_size, output_size);
+        dense_fold_zero_points(weights, weight_zps, biases, input_zp, folded_biases, input_size, output_size);
+        dense_pack_weights(weights, packed, input_size, output_size);
+
+        const int8_t *zps = symmetric ? NULL : weight_zps;
+
+        dense_int8_folded(inputs, weights, zps, folded_biases, outputs, output_zp, multipliers, shifts, input_size, output_size);
+        failures += check_equal("random dense_int8_folded", t, expected, outputs, output_size);
+
+        dense_int8_packed(inputs, packed, zps, folded_biases, outputs, output_zp, multipliers, shifts, input_size, output_size);
+        failures += check_equal("random dense_int8_packed", t, expected, outputs, output_size);
+
+        dense_int8_simd(inputs, weights, zps, folded_biases, outputs, output_zp, multipliers, shifts, input_size, output_size);
+        failures += check_equal("random dense_int8_simd", t, expected, outputs, output_size);
+
+        // fused epilogues (ReLU, a clamp, a lookup table) against
+        // dense_int8's outputs run through the same steps separately
+        int8_t fused_expected[MAX_RANDOM_OUTPUT_SIZE];
+        dense_epilogue_t epilogue = {
+            (t % 3 == 0) ? INT8_MIN : output_zp,
+            (t % 3 == 2) ? (int8_t)(output_zp / 2 + 63) : INT8_MAX,
+            (t % 4 == 1) ? lut : NULL,
+        };
+        apply_epilogue(&epilogue, expected, fused_expected, output_size);
+
+        dense_int8_fused(inputs, weights, zps, folded_biases, outputs, output_zp, multipliers, shifts, &epilogue, input_size, output_size);
+        failures += check_equal("random dense_int8_fused", t, fused_expected, outputs, output_size);
+
+        dense_int8_simd_fused(inputs, weights, zps, folded_biases, outputs, output_zp, multipliers, shifts, &epilogue, input_size, output_size);
+        failures += check_equal("random dense_int8_simd_fused", t, fused_expected, outputs, output_size);
+
+        dense_int8_packed_fused(inputs, packed, zps, folded_biases, outputs, output_zp, multipliers, shifts, &epilogue, input_size, output_size);
+        failures += check_equal("random dense_int8_packed_fused", t, fused_expected, outputs, output_size);
+
+        dense_int8_batch_fused(inputs, 1, weights, zps, folded_biases, outputs, output_zp, multipliers, shifts, &epilogue, input_size, output_size);
+        failures += check_equal("random dense_int8_batch_fused", t, fused_expected, outputs, output_size);
+
+        dense_int8_accumulate(inputs, weights, zps, folded_biases, accumulators, input_size, output_size);
+        dense_requantize_int8_fused(accumulators, outputs, output_zp, multipliers, shifts, &epilogue, output_size);
+        failures += check_equal("random dense_requantize_int8_fused", t, fused_expected, outputs, output_size);
+
+        uint32_t count = dense_gather_nonzero(inputs, input_zp, indices, values, input_size);
+        dense_int8_sparse_fused(indices, values, count, weights, zps, biases, outputs, output_zp, multipliers, shifts, &epilogue, input_size, output_size);
+        failures += check_equal("random dense_int8_sparse_fused", t, fused_expected, outputs, output_size);
+
+        dense_transpose_weights(weights, transposed, input_size, output_size);
+        dense_int8_sparse_colmajor_fused(indices, values, count, transposed, zps, biases, accumulators, outputs, output_zp, multipliers, shifts, &epilogue, output_size);
+        failures += check_equal("random dense_int8_sparse_colmajor_fused", t, fused_expected, outputs, output_size);
+
+        if (epilogue.min == output_zp && epilogue.max == INT8_MAX && epilogue.lut == NULL)
+        {
+            dense_relu_int8_folded(inputs, weights, zps, folded_biases, outputs, output_zp, multipliers, shifts, input_size, output_size);
+            failures += check_equal("random dense_relu_int8_folded", t, fused_expected, outputs, output_size);
+
+            dense_relu_int8(inputs, input_zp, weights, weight_zps, biases, outputs, output_zp, multipliers, shifts, input_size, output_size);
+            failures += check_equal("random dense_relu_int8", t, fused_expected, outputs, output_size);
+        }
+
+        if (dense_quantize_int4(
+                weights,
+                weight_zps,
+                biases,
+                multipliers,
+                shifts,
+                input_zp,
+                int4_weights,
+                int4_folded_biases,
+                int4_multipliers,
+                int4_shifts,
+                input_size,
+                output_size) == 0)
+        {
+            unpack_int4(int4_weights, int4_unpacked, input_size, output_size);
+            dense_int8_folded(inputs, int4_unpacked, NULL, int4_folded_biases, expected, output_zp, int4_multipliers, int4_shifts, input_size, output_size);
+            dense_int8_int4w(inputs, int4_weights, int4_folded_biases, outputs, output_zp, int4_multipliers, int4_shifts, input_size, output_size);
+            failures += check_equal("random dense_int8_int4w", t, expected, outputs, output_size);
+            apply_epilogue(&epilogue, expected, fused_expected, output_size);
+            dense_int8_int4w_fused(inputs, int4_weights, int4_folded_biases, outputs, output_zp, int4_multipliers, int4_shifts, &epilogue, input_size, output_size);
+            failures += check_equal("random dense_int8_int4w_fused", t, fused_expected, outputs, output_size);
+        }
+
+        // block-sparse needs symmetric weights; the tail block of odd input
+        // sizes is partial
+        if (symmetric)
+        {
+            dense_prune_blocks(weights, block_mask, t % 100, input_size, output_size);
+            apply_block_mask(weights, block_mask, pruned, input_size, output_size);
+            dense_encode_block_sparse(weights, biases, input_zp, block_mask, block_row_ptr, block_cols, block_values, folded_biases, input_size, output_size);
+            dense_int8(inputs, input_zp, pruned, weight_zps, biases, expected, output_zp, multipliers, shifts, input_size, output_size);
+            dense_int8_block_sparse(inputs, block_row_ptr, block_cols, block_values, folded_biases, outputs, output_zp, multipliers, shifts, input_size, output_size);
+            failures += check_equal("random dense_int8_block_sparse", t, expected, outputs, output_size);
+            apply_epilogue(&epilogue, expected, fused_expected, output_size);
+            dense_int8_block_sparse_fused(inputs, block_row_ptr, block_cols, block_values, folded_biases, outputs, output_zp, multipliers, shifts, &epilogue, input_size, output_size);
+            failures += check_equal("random dense_int8_block_sparse_fused", t, fused_expected, outputs, output_size);
+        }
+
+        // codebook, alternating 4- and 5-bit indices
+        uint32_t centroid_count = (t % 4) < 2 ? 16 : 32;
+        dense_cluster_weights(weights, weight_zps, biases, input_zp, centroid_count, codebook_indices, codebook_centroids, folded_biases, input_size, output_size);
+        decode_codebook(codebook_indices, codebook_centroids, centroid_count, weight_zps, pruned, input_size, output_size);
+        dense_int8_folded(inputs, pruned, weight_zps, folded_biases, expected, output_zp, multipliers, shifts, input_size, output_size);
+        dense_int8_codebook(inputs, codebook_indices, codebook_centroids, centroid_count, folded_biases, outputs, output_zp, multipliers, shifts, input_size, output_size);
+        failures += check_equal("random dense_int8_codebook", t, expected, outputs, output_size);
+        apply_epilogue(&epilogue, expected, fused_expected, output_size);
+        dense_int8_codebook_fused(inputs, codebook_indices, codebook_centroids, centroid_count, folded_biases, outputs, output_zp, multipliers, shifts, &epilogue, input_size, output_size);
+        failures += check_equal("random dense_int8_codebook_fused", t, fused_expected, outputs, output_size);
+    }
+
+    return failures;
+}
+
+// -----------------------------------------------------------------------------
+// straight port of TFLM reference_ops::Softmax (int8 in, int8 out) and the
+// gemmlowp fixed-point it runs on, kept apart from softmax.c so check_softmax
+// compares against an independent implementation
+
+// gemmlowp SaturatingRoundingDoublingHighMul
+static int32_t tflm_srdhm(int32_t a, int32_t b)
+{
+    int overflow = a == b && a == INT32_MIN;
+    int64_t ab_64 = (int64_t)a * (int64_t)b;
+    int32_t nudge = ab_64 >= 0 ? (1 << 30) : (1 - (1 << 30));
+    int32_t ab_x2_high32 = (int32_t)((ab_64 + nudge) / (1ll << 31));
+    return overflow ? INT32_MAX : ab_x2_high32;
+}
+
+// gemmlowp RoundingDivideByPOT, defined for exponents up to 31
+static int32_t tflm_rounding_divide_by_pot(int32_t x, int32_t exponent)
+{
+    int32_t mask = (int32_t)((1ll << exponent) - 1);
+    int32_t remainder = x & mask;
+    int32_t threshold = (mask >> 1) + ((x < 0) ? 1 : 0);
+    return (x >> exponent) + ((remainder > threshold) ? 1 : 0);
+}
+
+// gemmlowp SaturatingRoundingMultiplyByPOT for exponent > 0
+static int32_t tflm_saturating_multiply_by_pot(int32_t x, int32_t exponent)
+{
+    int32_t threshold = (1 << (31 - exponent)) - 1;
+    if (x > threshold)
+    {
+        return INT32_MAX;
+    }
+    if (x < -threshold)
+    {
+        return INT32_MIN;
+    }
+    return (int32_t)((uint32_t)x << exponent);
+}
+
+// gemmlowp exp_on_interval_between_negative_one_quarter_and_0_excl (F0 in/out)
+static int32_t tflm_exp_on_interval(int32_t a)
+{
+    const int32_t constant_term = 1895147668;
+    const int32_t constant_1_over_3 = 715827883;
+    int32_t x = a + (1 << 28);
+    int32_t x2 = tflm_srdhm(x, x);
+    int32_t x3 = tflm_srdhm(x2, x);
+    int32_t x4 = tflm_srdhm(x2, x2);
+    int32_t x4_over_4 = tflm_rounding_divide_by_pot(x4, 2);
+    int32_t x4_over_24_plus_x3_over_6_plus_x2_over_2 =
+        tflm_rounding_divide_by_pot(tflm_srdhm(x4_over_4 + x3, constant_1_over_3) + x2, 1);
+    return constant_term + tflm_srdhm(constant_term, x + x4_over_24_plus_x3_over_6_plus_x2_over_2);
+}
+
+// gemmlowp exp_on_negative_values (F5 in, F0 out)
+static int32_t tflm_exp_on_negative_values(int32_t a)
+{
+    static const int32_t multipliers[] = {1672461947, 1302514674, 790015084, 290630308, 39332535, 720401, 242};
+    const int32_t one_quarter = 1 << 24;
+    int32_t a_mod_quarter_minus_one_quarter = (a & (one_quarter - 1)) - one_quarter;
+    int32_t result = tflm_exp_on_interval(tflm_saturating_multiply_by_pot(a_mod_quarter_minus_one_quarter, 5));
+    int32_t remainder = a_mod_quarter_minus_one_quarter - a;
+    for (int32_t exponent = -2; exponent <= 4; ++exponent)
+    {
+        if (remainder & (1 << (26 + exponent)))
+        {
+            result = tflm_srdhm(result, multipliers[exponent + 2]);
+        }
+    }
+    return (a == 0) ? INT32_MAX : result;
+}
+
+// gemmlowp one_over_one_plus_x_for_x_in_0_1 (F0 in/out, F2 iterations)
+static int32_t tflm_one_over_one_plus_x(int32_t a)
+{
+    int64_t sum = (int64_t)a + INT32_MAX;
+    int32_t half_denominator = (int32_t)((sum + (sum >= 0 ? 1 : -1)) / 2);
+    int32_t x = 1515870810 + tflm_srdhm(half_denominator, -1010580540);
+    for (int i = 0; i < 3; ++i)
+    {
+        int32_t half_denominator_times_x = tflm_srdhm(half_denominator, x);
+        int32_t one_minus_half_denominator_times_x = (1 << 29) - half_denominator_times_x;
+        x = x + tflm_saturating_multiply_by_pot(tflm_srdhm(x, one_minus_half_denominator_times_x), 2);
+    }
+    return tflm_saturating_multiply_by_pot(x, 1);
+}
+
+// reference_ops::Softmax over one row; -1 where its final RoundingDivideByPOT
+// would shift by more than 31 (sums past 2^8, undefined in TFLM)
+static int tflm_softmax(const int8_t *inputs, int8_t *outputs, uint32_t depth, const softmax_params_t *params)
+{
+    int8_t max_in_row = INT8_MIN;
+    for (uint32_t c = 0; c < depth; ++c)
+    {
+        max_in_row = inputs[c] > max_in_row ? inputs[c] : max_in_row;
+    }
+
+    int32_t sum_of_exps = 0;
+    for (uint32_t c = 0; c < depth; ++c)
+    {
+        int32_t input_diff = (int32_t)inputs[c] - max_in_row;
+        if (input_diff >= params->diff_min)
+        {
+            int32_t input_diff_rescaled = tflm_srdhm(input_diff * (1 << params->input_left_shift), params->input_multiplier);
+            sum_of_exps += tflm_rounding_divide_by_pot(tflm_exp_on_negative_values(input_diff_rescaled), 12);
+        }
+    }
+
+    int32_t headroom_plus_one = __builtin_clz((uint32_t)sum_of_exps);
+    int32_t num_bits_over_unit = 12 - headroom_plus_one;
+    int32_t shifted_sum_minus_one = (int32_t)(((uint32_t)sum_of_exps << headroom_plus_one) - (1u << 31));
+    int32_t shifted_scale = tflm_one_over_one_plus_x(shifted_sum_minus_one);
+    if (num_bits_over_unit + 31 - 8 > 31)
+    {
+        return -1;
+    }
+
+    for (uint32_t c = 0; c < depth; ++c)
+    {
+        int32_t input_diff = (int32_t)inputs[c] - max_in_row;
+        if (input_diff >= params->diff_min)
+        {
+            int32_t input_diff_rescaled = tflm_srdhm(input_diff * (1 << params->input_left_shift), params->input_multiplier);
+            int32_t exp_in_0 = tflm_exp_on_negative_values(input_diff_rescaled);
+            int32_t unsat_output = tflm_rounding_divide_by_pot(tflm_srdhm(shifted_scale, exp_in_0), num_bits_over_unit + 31 - 8);
+            int32_t shifted_output = unsat_output + INT8_MIN;
+            outputs[c] = (int8_t)(shifted_output < INT8_MIN ? INT8_MIN : shifted_output > INT8_MAX ? INT8_MAX : shifted_output);
+        }
+        else
+        {
+            outputs[c] = INT8_MIN;
+        }
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// softmax_int8 on lengths past the model's 10 classes, over logits spread
+// across the int8 range and bunched just below the max: bit-exact with the
+// TFLM reference port wherever that is defined, at most 1 LSB off a float
+// softmax quantized like the TFLM output (scale 1/256, zero-point -128),
+// identical in place and out of place; the embedded softmax params must be
+// the ones prepared from the model's logits scale
+static int check_softmax(void)
+{
+    static const uint32_t lengths[] = {1, 10, 16, 17, 40, 100, 255, MAX_SOFTMAX_LENGTH};
+    static const double scales[] = {0.01, 0.125, LOGITS_SCALE, 1.0};
+    static const double betas[] = {1.0, 0.5, 2.0};
+    static const uint32_t spreads[] = {256, 8};
+    static int8_t logits[MAX_SOFTMAX_LENGTH];
+    static int8_t outputs[MAX_SOFTMAX_LENGTH];
+    static int8_t inplace[MAX_SOFTMAX_LENGTH];
+    static int8_t expected[MAX_SOFTMAX_LENGTH];
+    uint32_t compared = 0;
+    uint32_t seed = 11;
+    int failures = 0;
+
+    softmax_params_t model_params;
+    if (softmax_prepare(LOGITS_SCALE, 1.0, &model_params) != 0 ||
+        memcmp(&model_params, &g_params[SOFTMAX_PARAMS_OFFSET], sizeof(model_params)) != 0)
+    {
+        fprintf(stderr, "MISMATCH: embedded softmax params\n");
+        return 1;
+    }
+
+    for (uint32_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l)
+    {
+        for (uint32_t c = 0; c < sizeof(scales) / sizeof(scales[0]); ++c)
+        {
+            for (uint32_t b = 0; b < sizeof(betas) / sizeof(betas[0]); ++b)
+            {
+                for (uint32_t v = 0; v < sizeof(spreads) / sizeof(spreads[0]); ++v)
+                {
+                    uint32_t length = lengths[l];
+                    softmax_params_t params;
+                    if (softmax_prepare(scales[c], betas[b], &params) != 0)
+                    {
+                        fprintf(stderr, "MISMATCH: softmax_prepare(%g, %g) failed\n", scales[c], betas[b]);
+                        return 1;
+                    }
+
+                    for (uint32_t i = 0; i < length; ++i)
+                    {
+                        logits[i] = (int8_t)(INT8_MAX - (int32_t)(next_random(&seed) % spreads[v]));
+                    }
+                    softmax_int8(logits, outputs, length, &params);
+                    memcpy(inplace, logits, length);
+                    softmax_int8(inplace, inplace, length, &params);
+                    failures += check_equal("softmax_int8 (in place)", length, outputs, inplace, length);
+
+                    if (tflm_softmax(logits, expected, length, &params) == 0)
+                    {
+                        failures += check_equal("softmax_int8 (TFLM reference)", length, expected, outputs, length);
+                        ++compared;
+                    }
+
+                    int8_t max_logit = logits[0];
+                    for (uint32_t i = 1; i < length; ++i)
+                    {
+                        max_logit = logits[i] > max_logit ? logits[i] : max_logit;
+                    }
+                    double sum = 0.0;
+                    for (uint32_t i = 0; i < length; ++i)
+                    {
+                        sum += exp((logits[i] - max_logit) * scales[c] * betas[b]);
+                    }
+                    for (uint32_t i = 0; i < length; ++i)
+                    {
+                        double p = exp((logits[i] - max_logit) * scales[c] * betas[b]) / sum;
+                        long quantized = lround(p * 256.0) - 128;
+                        quantized = quantized > 127 ? 127 : quantized;
+                        if (labs(quantized - outputs[i]) > 1)
+                        {
+                            fprintf(stderr, "MISMATCH: softmax_int8 length %" PRIu32 " scale %g beta %g [%" PRIu32 "]: expected %ld, got %d\n",
+                                    length, scales[c], betas[b], i, quantized, outputs[i]);
+                            return 1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (compared == 0)
+    {
+        fprintf(stderr, "MISMATCH: no softmax row within the TFLM reference's range\n");
+        return 1;
+    }
+
+    return failures;
+}
+
+// -----------------------------------------------------------------------------
+// bump allocator for the synthetic plan blob
+static uint32_t blob_alloc(uint32_t *used, uint32_t size, uint32_t align)
+{
+    uint32_t offset = (*used + align - 1) / align * align;
+    *used = offset + size;
+    return offset;
+}
+
+// -----------------------------------------------------------------------------
+// a random PLAN_TEST_LAYERS-deep MLP (dense+ReLU, dense+ReLU6, dense+tanh
+// (LUT), dense, softmax) built into a blob, run through the executor and
+// checked against dense_int8 and a separate activation pass layer by layer;
+// also checks that malformed plans are rejected
+static int check_plan(void)
+{
+    static uint8_t blob[PLAN_TEST_BLOB_SIZE] __attribute__((aligned(16)));
+    static const uint32_t sizes[PLAN_TEST_LAYERS + 1] = {100, 64, 33, 17, 10};
+    int8_t arena[PLAN_TEST_ARENA_SIZE] __attribute__((aligned(16)));
+    int8_t activations[2][128];
+    int8_t inputs[128] __attribute__((aligned(16)));
+    int8_t outputs[16];
+    uint32_t seed = 7;
+    uint32_t used = 0;
+    int failures = 0;
+
+    memset(blob, 0, sizeof(blob));
+    uint32_t plan_offset = blob_alloc(&used, sizeof(mlp_plan_t) + (PLAN_TEST_LAYERS + 1) * sizeof(mlp_plan_layer_t), 4);
+    mlp_plan_t *plan = (mlp_plan_t *)&blob[plan_offset];
+    mlp_plan_layer_t *layers = (mlp_plan_layer_t *)(plan + 1);
+    int32_t biases[PLAN_TEST_LAYERS][128];
+    uint32_t arena_size = 0;
+    static const uint8_t activations_by_layer[PLAN_TEST_LAYERS] = {
+        MLP_ACTIVATION_RELU,
+        MLP_ACTIVATION_RELU6,
+        MLP_ACTIVATION_LUT,
+        MLP_ACTIVATION_NONE,
+    };
+
+    for (uint32_t l = 0; l < PLAN_TEST_LAYERS; ++l)
+    {
+        mlp_plan_layer_t *layer = &layers[l];
+        uint32_t in = sizes[l];
+        uint32_t out = sizes[l + 1];
+
+        layer->type = MLP_LAYER_DENSE;
+        layer->activation = (l + 1 < PLAN_TEST_LAYERS) ? activations_by_layer[l] : MLP_ACTIVATION_NONE;
+        layer->input_zp = (l == 0) ? -128 : (layers[l - 1].activation == MLP_ACTIVATION_LUT) ? 0 : layers[l - 1].output_zp;
+        layer->output_zp = (int8_t)(next_random(&seed) % 64 - 32);
+        layer->input_size = in;
+        layer->output_size = out;
+        layer->weight_offset = blob_alloc(&used, in * out, 16);
+        layer->weight_zp_offset = (l % 2) ? blob_alloc(&used, out, 1) : MLP_PLAN_NONE;
+        layer->folded_bias_offset = blob_alloc(&used, out * sizeof(int32_t), 4);
+        layer->multiplier_offset = blob_alloc(&used, out * sizeof(uint32_t), 4);
+        layer->shift_offset = blob_alloc(&used, out * sizeof(int32_t), 4);
+        layer->activation_offset = MLP_PLAN_NONE;
+        if (layer->activation == MLP_ACTIVATION_RELU6)
+        {
+            layer->activation_offset = blob_alloc(&used, 1, 1);
+            blob[layer->activation_offset] = (uint8_t)dense_relu6_max(0.05f, layer->output_zp);
+        }
+        else if (layer->activation == MLP_ACTIVATION_LUT)
+        {
+            layer->activation_offset = blob_alloc(&used, DENSE_LUT_SIZE, 1);
+            dense_activation_lut(DENSE_LUT_TANH, 0.05f, layer->output_zp, 1.0f / 128.0f, 0, (int8_t *)&blob[layer->activation_offset]);
+        }
+
+        int8_t zero_zps[128] = {0};
+        int8_t *weights = (int8_t *)&blob[layer->weight_offset];
+        int8_t *weight_zps = (layer->weight_zp_offset != MLP_PLAN_NONE) ? (int8_t *)&blob[layer->weight_zp_offset] : zero_zps;
+        uint32_t *multipliers = (uint32_t *)&blob[layer->multiplier_offset];
+        int32_t *shifts = (int32_t *)&blob[layer->shift_offset];
+
+        for (uint32_t i = 0; i < in * out; ++i)
+        {
+            weights[i] = (int8_t)next_random(&seed);
+        }
+        for (uint32_t oc = 0; oc < out; ++oc)
+        {
+            if (layer->weight_zp_offset != MLP_PLAN_NONE)
+            {
+                weight_zps[oc] = (int8_t)(next_random(&seed) % 16 - 8);
+            }
+            biases[l][oc] = (int32_t)(next_random(&seed) % 20000) - 10000;
+            multipliers[oc] = (1u << 30) + next_random(&seed) % (1u << 30);
+            shifts[oc] = 8 + (int32_t)(next_random(&seed) % 4);
+        }
+        dense_fold_zero_points(
+            weights,
+            weight_zps,
+            biases[l],
+            layer->input_zp,
+            (int32_t *)&blob[layer->folded_bias_offset],
+            in,
+            out);
+
+        uint32_t pair = (l == 0 ? 0 : MLP_PLAN_ALIGN_UP(in)) + (l + 1 == PLAN_TEST_LAYERS ? 0 : MLP_PLAN_ALIGN_UP(out));
+        arena_size = pair > arena_size ? pair : arena_size;
+    }
+
+    mlp_plan_layer_t *softmax = &layers[PLAN_TEST_LAYERS];
+    memset(softmax, 0, sizeof(*softmax));
+    softmax->type = MLP_LAYER_SOFTMAX;
+    softmax->input_size = sizes[PLAN_TEST_LAYERS];
+    softmax->output_size = sizes[PLAN_TEST_LAYERS];
+    softmax->multiplier_offset = blob_alloc(&used, sizeof(softmax_params_t), 4);
+    softmax_params_t *softmax_params = (softmax_params_t *)&blob[softmax->multiplier_offset];
+    softmax_prepare(0.125, 1.0, softmax_params);
+
+    plan->magic = MLP_PLAN_MAGIC;
+    plan->version = MLP_PLAN_VERSION;
+    plan->layer_count = PLAN_TEST_LAYERS + 1;
+    plan->input_size = sizes[0];
+    plan->output_size = sizes[PLAN_TEST_LAYERS];
+    plan->arena_size = arena_size;
+
+    const mlp_plan_t *valid = mlp_plan_get(blob, used, plan_offset, sizeof(arena));
+    if (valid == NULL)
+    {
+        fprintf(stderr, "MISMATCH: synthetic plan rejected\n");
+        return 1;
+    }
+
+    for (uint32_t t = 0; t < 20; ++t)
+    {
+        for (uint32_t i = 0; i < sizes[0]; ++i)
+        {
+            inputs[i] = (int8_t)next_random(&seed);
+        }
+
+        // reference: dense_int8 over raw biases, layer by layer
+        const int8_t *current = inputs;
+        for (uint32_t l = 0; l < PLAN_TEST_LAYERS; ++l)
+        {
+            const mlp_plan_layer_t *layer = &layers[l];
+            int8_t zero_zps[128] = {0};
+            int8_t *next = activations[l % 2];
+            dense_int8(
+                current,
+                layer->input_zp,
+                (const int8_t *)&blob[layer->weight_offset],
+                layer->weight_zp_offset != MLP_PLAN_NONE ? (const int8_t *)&blob[layer->weight_zp_offset] : zero_zps,
+                biases[l],
+                next,
+                layer->output_zp,
+                (const uint32_t *)&blob[layer->multiplier_offset],
+                (const int32_t *)&blob[layer->shift_offset],
+                layer->input_size,
+                layer->output_size);
+            for (uint32_t oc = 0; oc < layer->output_size; ++oc)
+            {
+                if ((layer->activation == MLP_ACTIVATION_RELU || layer->activation == MLP_ACTIVATION_RELU6) && next[oc] < layer->output_zp)
+                {
+                    next[oc] = layer->output_zp;
+                }
+                if (layer->activation == MLP_ACTIVATION_RELU6 && next[oc] > (int8_t)blob[layer->activation_offset])
+                {
+                    next[oc] = (int8_t)blob[layer->activation_offset];
+                }
+                if (layer->activation == MLP_ACTIVATION_LUT)
+                {
+                    next[oc] = ((const int8_t *)&blob[layer->activation_offset])[next[oc] - INT8_MIN];
+                }
+            }
+            current = next;
+        }
+        memcpy(outputs, current, sizes[PLAN_TEST_LAYERS]);
+        softmax_int8(outputs, outputs, sizes[PLAN_TEST_LAYERS], softmax_params);
+
+        int8_t actual[16];
+        mlp_plan_run(valid, blob, arena, inputs, actual);
+        failures += check_equal("mlp_plan_run (synthetic)", t, outputs, actual, sizes[PLAN_TEST_LAYERS]);
+    }
+
+    // malformed plans
+    plan->arena_size = arena_size - 1;
+    failures += mlp_plan_get(blob, used, plan_offset, sizeof(arena)) != NULL;
+    plan->arena_size = arena_size;
+    failures += mlp_plan_get(blob, used, plan_offset, arena_size - 1) != NULL;
+    layers[2].input_size += 1;
+    failures += mlp_plan_get(blob, used, plan_offset, sizeof(arena)) != NULL;
+    layers[2].input_size -= 1;
+    failures += mlp_plan_get(blob, layers[3].shift_offset, plan_offset, sizeof(arena)) != NULL;
+    failures += mlp_plan_get(blob, softmax->multiplier_offset + 4, plan_offset, sizeof(arena)) != NULL;
+    plan->magic ^= 1;
+    failures += mlp_plan_get(blob, used, plan_offset, sizeof(arena)) != NULL;
+    plan->magic ^= 1;
+    layers[1].activation = MLP_ACTIVATION_LUT + 1;
+    failures += mlp_plan_get(blob, used, plan_offset, sizeof(arena)) != NULL;
+    layers[1].activation = MLP_ACTIVATION_RELU6;
+    uint32_t lut_offset = layers[2].activation_offset;
+    layers[2].activation_offset = used - DENSE_LUT_SIZE + 1;
+    failures += mlp_plan_get(blob, used, plan_offset, sizeof(arena)) != NULL;
+    layers[2].activation_offset = lut_offset;
+    if (failures != 0)
+    {
+        fprintf(stderr, "MISMATCH: mlp_plan_get\n");
+    }
+
+    return failures;
+}
+
+// -----------------------------------------------------------------------------
+// dense_int8_topk against dense_int8_folded on random shapes: rows it keeps
+// are exact, rows it drops are below the k-th best, and without finishing it
+// keeps exactly the top k; forward_pass_topk, and mlp_model_topk over a model
+// without top-k bounds, must agree across k and early stop, and their logits
+// must softmax to forward_pass's outputs
+static int check_topk(void)
+{
+    static int8_t inputs[MAX_RANDOM_INPUT_SIZE];
+    static int8_t weights[MAX_RANDOM_INPUT_SIZE * MAX_RANDOM_OUTPUT_SIZE];
+    static int32_t weight_sums[DENSE_TOPK_BOUNDS_SIZE(MAX_RANDOM_INPUT_SIZE, MAX_RANDOM_OUTPUT_SIZE)];
+    static int32_t weight_norms[DENSE_TOPK_BOUNDS_SIZE(MAX_RANDOM_INPUT_SIZE, MAX_RANDOM_OUTPUT_SIZE)];
+    int8_t weight_zps[MAX_RANDOM_OUTPUT_SIZE];
+    int32_t biases[MAX_RANDOM_OUTPUT_SIZE];
+    int32_t folded_biases[MAX_RANDOM_OUTPUT_SIZE];
+    uint32_t multipliers[MAX_RANDOM_OUTPUT_SIZE];
+    int32_t shifts[MAX_RANDOM_OUTPUT_SIZE];
+    int32_t scratch[DENSE_TOPK_SCRATCH_SIZE(MAX_RANDOM_OUTPUT_SIZE)];
+    int8_t expected[MAX_RANDOM_OUTPUT_SIZE];
+    int8_t outputs[MAX_RANDOM_OUTPUT_SIZE];
+    uint32_t seed = 5;
+    uint32_t dropped = 0;
+
+    for (uint32_t t = 0; t < RANDOM_SHAPES; ++t)
+    {
+        uint32_t in = 1 + next_random(&seed) % MAX_RANDOM_INPUT_SIZE;
+        uint32_t out = 1 + next_random(&seed) % MAX_RANDOM_OUTPUT_SIZE;
+        uint32_t k = 1 + next_random(&seed) % out;
+        int finish = (int)(next_random(&seed) % 2);
+        int asymmetric = (int)(next_random(&seed) % 2);
+        int8_t input_zp = (int8_t)(next_random(&seed) % 256);
+        int8_t output_zp = (int8_t)(next_random(&seed) % 256);
+
+        for (uint32_t i = 0; i < in; ++i)
+        {
+            // ReLU-like: mostly at the zero-point
+            inputs[i] = (next_random(&seed) % 3 == 0) ? (int8_t)next_random(&seed) : input_zp;
+        }
+        for (uint32_t i = 0; i < in * out; ++i)
+        {
+            weights[i] = (int8_t)(next_random(&seed) % 128 - 64);
+        }
+        for (uint32_t oc = 0; oc < out; ++oc)
+        {
+            weight_zps[oc] = asymmetric ? (int8_t)(next_random(&seed) % 16 - 8) : 0;
+            biases[oc] = (int32_t)(next_random(&seed) % 200000) - 100000;
+            multipliers[oc] = (1u << 30) + next_random(&seed) % (1u << 30);
+            shifts[oc] = 10 + (int32_t)(next_random(&seed) % 6);
+        }
+        dense_fold_zero_points(weights, weight_zps, biases, input_zp, folded_biases, in, out);
+        dense_topk_weight_bounds(weights, weight_sums, weight_norms, in, out);
+
+        dense_int8_folded(inputs, weights, asymmetric ? weight_zps : NULL, folded_biases, expected, output_zp, multipliers, shifts, in, out);
+        uint32_t running = dense_int8_topk(
+            inputs,
+            weights,
+            asymmetric ? weight_zps : NULL,
+            folded_biases,
+            weight_sums,
+            weight_norms,
+            scratch,
+            outputs,
+            output_zp,
+            multipliers,
+            shifts,
+            k,
+            finish,
+            in,
+            out);
+
+        // k-th best exact output
+        int8_t sorted[MAX_RANDOM_OUTPUT_SIZE];
+        memcpy(sorted, expected, out);
+        for (uint32_t i = 0; i < k; ++i)
+        {
+            for (uint32_t j = i + 1; j < out; ++j)
+            {
+                if (sorted[j] > sorted[i])
+                {
+                    int8_t tmp = sorted[i];
+                    sorted[i] = sorted[j];
+                    sorted[j] = tmp;
+                }
+            }
+        }
+        int8_t kth = sorted[k - 1];
+
+        int unordered = !finish && running <= k;
+        for (uint32_t oc = 0; oc < out; ++oc)
+        {
+            // dropped rows are strictly below the k-th best
+            int ok = (outputs[oc] == INT8_MIN && expected[oc] < kth) ||
+                     (unordered ? (outputs[oc] == INT8_MAX && expected[oc] >= kth) : outputs[oc] == expected[oc]);
+            if (!ok)
+            {
+                fprintf(stderr, "MISMATCH: dense_int8_topk (%" PRIu32 "x%" PRIu32 ", k %" PRIu32 ", finish %d) row %" PRIu32 ": %d vs %d\n",
+                        in, out, k, finish, oc, outputs[oc], expected[oc]);
+                return 1;
+            }
+        }
+        if (running < k || (unordered && running != k))
+        {
+            fprintf(stderr, "MISMATCH: dense_int8_topk kept %" PRIu32 " rows for k %" PRIu32 "\n", running, k);
+            return 1;
+        }
+        dropped += out - running;
+    }
+    if (dropped == 0)
+    {
+        fprintf(stderr, "MISMATCH: dense_int8_topk never dropped a row\n");
+        return 1;
+    }
+
+    // a copy of g_params resolves without the top-k bounds
+    static uint8_t params_copy[PARAMS_SIZE] __attribute__((aligned(16)));
+    mlp_model_t unbounded;
+    memcpy(params_copy, g_params, PARAMS_SIZE);
+    if (mlp_model_init(&unbounded, params_copy, PARAMS_SIZE) != 0 || unbounded.output_weight_sums != NULL)
+    {
+        fprintf(stderr, "MISMATCH: mlp_model_init (copy of g_params)\n");
+        return 1;
+    }
+
+    int failures = 0;
+    const softmax_params_t *softmax_params = (const softmax_params_t *)&g_params[SOFTMAX_PARAMS_OFFSET];
+    for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+    {
+        uint32_t all_classes[OUTPUT_SIZE];
+        int8_t all_logits[OUTPUT_SIZE];
+        int8_t logits[OUTPUT_SIZE];
+        int8_t scores[OUTPUT_SIZE];
+        int8_t expected_scores[OUTPUT_SIZE];
+
+        failures += forward_pass_topk(g_inputs[s], OUTPUT_SIZE + 1, 0, all_classes, all_logits) != OUTPUT_SIZE;
+        for (uint32_t i = 0; i < OUTPUT_SIZE; ++i)
+        {
+            logits[all_classes[i]] = all_logits[i];
+            failures += (i > 0 && (all_logits[i] > all_logits[i - 1] || (all_logits[i] == all_logits[i - 1] && all_classes[i] < all_classes[i - 1])));
+        }
+        softmax_int8(logits, scores, OUTPUT_SIZE, softmax_params);
+        forward_pass(g_inputs[s], expected_scores);
+        failures += check_equal("forward_pass_topk logits", s, expected_scores, scores, OUTPUT_SIZE);
+
+        for (uint32_t k = 1; k <= OUTPUT_SIZE; ++k)
+        {
+            for (int early_stop = 0; early_stop < 2; ++early_stop)
+            {
+                uint32_t classes[OUTPUT_SIZE];
+                int8_t top_logits[OUTPUT_SIZE];
+                forward_pass_topk(g_inputs[s], k, early_stop, classes, top_logits);
+                failures += check_equal("forward_pass_topk", s, all_logits, top_logits, k);
+                failures += memcmp(classes, all_classes, k * sizeof(uint32_t)) != 0;
+                mlp_model_topk(&unbounded, g_inputs[s], k, early_stop, classes, top_logits);
+                failures += check_equal("mlp_model_topk (no bounds)", s, all_logits, top_logits, k);
+                failures += memcmp(classes, all_classes, k * sizeof(uint32_t)) != 0;
+            }
+        }
+
+        for (int early_stop = 0; early_stop < 2; ++early_stop)
+        {
+            uint32_t best;
+            forward_pass_topk(g_inputs[s], 1, early_stop, &best, NULL);
+            failures += best != all_classes[0];
+            mlp_model_topk(&unbounded, g_inputs[s], 1, early_stop, &best, NULL);
+            failures += best != all_classes[0];
+        }
+    }
+    if (failures != 0)
+    {
+        fprintf(stderr, "MISMATCH: forward_pass_topk\n");
+    }
+
+    return failures;
+}
+
+// -----------------------------------------------------------------------------
+static int check_variants(void)
+{
+    int failures = 0;
+
+    for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+    {
+        int8_t expected[OUTPUT_SIZE];
+        int8_t outputs[OUTPUT_SIZE];
+        expected_forward(g_inputs[s], expected);
+        forward_pass(g_inputs[s], outputs);
+        failures += check_equal("forward_pass", s, expected, outputs, OUTPUT_SIZE);
+
+#if CONFIG_MLP_DUAL_CORE
+        // hammer the worker hand-off: a missed or early join shows up as a
+        // half-written hidden layer
+        for (uint32_t r = 0; r < DUAL_CORE_CHECK_ROUNDS && failures == 0; ++r)
+        {
+            memset(outputs, 0, sizeof(outputs));
+            forward_pass(g_inputs[s], outputs);
+            failures += check_equal("forward_pass (dual core)", s, expected, outputs, OUTPUT_SIZE);
+        }
+#endif
+
+        reference_forward(g_inputs[s], expected);
+        plan_forward(g_inputs[s], outputs);
+        failures += check_equal("mlp_plan_run", s, expected, outputs, OUTPUT_SIZE);
+    }
+
+    int8_t batch_outputs[NUM_SAMPLES][OUTPUT_SIZE];
+    forward_pass_batch(&g_inputs[0][0], &batch_outputs[0][0], NUM_SAMPLES);
+    for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+    {
+        int8_t expected[OUTPUT_SIZE];
+        reference_forward(g_inputs[s], expected);
+        failures += check_equal("forward_pass_batch", s, expected, batch_outputs[s], OUTPUT_SIZE);
+    }
+
+    mlp_model_t model;
+    if (mlp_model_init(&model, g_params, PARAMS_SIZE) != 0)
+    {
+        fprintf(stderr, "MISMATCH: mlp_model_init\n");
+        return failures + 1;
+    }
+    memset(batch_outputs, 0, sizeof(batch_outputs));
+    mlp_model_forward_batch(&model, &g_inputs[0][0], &batch_outputs[0][0], NUM_SAMPLES);
+    for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+    {
+        int8_t expected[OUTPUT_SIZE];
+        reference_forward(g_inputs[s], expected);
+        failures += check_equal("mlp_model_forward_batch", s, expected, batch_outputs[s], OUTPUT_SIZE);
+    }
+
+    return failures;
+}
+
+// -----------------------------------------------------------------------------
+static stats_t run_variant(const variant_t *variant, uint32_t rounds, uint64_t *samples)
+{
+    int8_t outputs[OUTPUT_SIZE];
+
+    for (uint32_t r = 0; r < WARMUP_ROUNDS; ++r)
+    {
+        for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+        {
+            variant->forward(g_inputs[s], outputs);
+        }
+    }
+
+    uint32_t count = rounds * NUM_SAMPLES;
+    for (uint32_t r = 0, i = 0; r < rounds; ++r)
+    {
+        for (uint32_t s = 0; s < NUM_SAMPLES; ++s, ++i)
+        {
+            uint64_t start = now_ns();
+            variant->forward(g_inputs[s], outputs);
+            uint64_t end = now_ns();
+            samples[i] = end - start;
+        }
+    }
+
+    stats_t stats = compute_stats(samples, count);
+
+    printf("%-24s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+           variant->name,
+           stats.min,
+           stats.median,
+           stats.p99);
+    return stats;
+}
+
+// -----------------------------------------------------------------------------
+// forward_pass_batch over all samples at once, reported per inference
+static void run_batch(uint32_t rounds, uint64_t *samples)
+{
+    int8_t outputs[NUM_SAMPLES][OUTPUT_SIZE];
+
+    for (uint32_t r = 0; r < WARMUP_ROUNDS; ++r)
+    {
+        forward_pass_batch(&g_inputs[0][0], &outputs[0][0], NUM_SAMPLES);
+    }
+
+    for (uint32_t r = 0; r < rounds; ++r)
+    {
+        uint64_t start = now_ns();
+        forward_pass_batch(&g_inputs[0][0], &outputs[0][0], NUM_SAMPLES);
+        uint64_t end = now_ns();
+        samples[r] = (end - start) / NUM_SAMPLES;
+    }
+
+    stats_t stats = compute_stats(samples, rounds);
+
+    printf("%-24s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+           "forward_pass_batch",
+           stats.min,
+           stats.median,
+           stats.p99);
+}
+
+// -----------------------------------------------------------------------------
+// hidden layer kernels timed in isolation
+typedef enum
+{
+    HIDDEN_REFERENCE,
+    HIDDEN_DENSE,
+    HIDDEN_PACKED,
+    HIDDEN_SIMD,
+    HIDDEN_STATIC,
+    HIDDEN_SPARSE,
+    HIDDEN_SPARSE_COLMAJOR,
+    HIDDEN_INT4,
+    HIDDEN_CODEBOOK16,
+    HIDDEN_CODEBOOK32,
+    NUM_HIDDEN_KERNELS,
+} hidden_kernel_t;
+
+static const char *g_hidden_kernel_names[NUM_HIDDEN_KERNELS] = {
+    "dense_int8",
+    "folded",
+    "packed",
+    "simd (" DENSE_SIMD_BACKEND ")",
+    "static (C++)",
+    "sparse",
+    "sparse-colmajor",
+    "int4",
+    "codebook-16",
+    "codebook-32",
+};
+
+// -----------------------------------------------------------------------------
+static void run_hidden_layer(hidden_kernel_t kernel, const int8_t *inputs, int8_t *hiddens)
+{
+    uint16_t indices[INPUT_SIZE];
+    int16_t values[INPUT_SIZE];
+    int32_t accumulators[HIDDEN_SIZE];
+    uint32_t count;
+    dense_epilogue_t relu = {(int8_t)g_params[HIDDEN_ZP_OFFSET], INT8_MAX, NULL};
+
+    switch (kernel)
+    {
+    case HIDDEN_REFERENCE:
+        dense_int8(
+            inputs,
+            (int8_t)g_params[INPUT_ZP_OFFSET],
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[HIDDEN_BIAS_OFFSET],
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        break;
+    case HIDDEN_PACKED:
+        dense_int8_packed(
+            inputs,
+            g_hidden_weights_packed,
+            NULL,
+            (const int32_t *)&g_params[HIDDEN_FOLDED_BIAS_OFFSET],
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        break;
+    case HIDDEN_SIMD:
+        dense_int8_simd(
+            inputs,
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+            NULL,
+            (const int32_t *)&g_params[HIDDEN_FOLDED_BIAS_OFFSET],
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        break;
+    case HIDDEN_STATIC:
+        dense_static_hidden(
+            inputs,
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+            NULL,
+            (const int32_t *)&g_params[HIDDEN_FOLDED_BIAS_OFFSET],
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            &relu);
+        break;
+    case HIDDEN_DENSE:
+        dense_int8_folded(
+            inputs,
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+            NULL,
+            (const int32_t *)&g_params[HIDDEN_FOLDED_BIAS_OFFSET],
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        break;
+    case HIDDEN_SPARSE:
+        count = dense_gather_nonzero(inputs, (int8_t)g_params[INPUT_ZP_OFFSET], indices, values, INPUT_SIZE);
+        dense_int8_sparse(
+            indices,
+            values,
+            count,
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+            NULL,
+            (const int32_t *)&g_params[HIDDEN_BIAS_OFFSET],
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        break;
+    case HIDDEN_SPARSE_COLMAJOR:
+        count = dense_gather_nonzero(inputs, (int8_t)g_params[INPUT_ZP_OFFSET], indices, values, INPUT_SIZE);
+        dense_int8_sparse_colmajor(
+            indices,
+            values,
+            count,
+            g_hidden_weights_colmajor,
+            NULL,
+            (const int32_t *)&g_params[HIDDEN_BIAS_OFFSET],
+            accumulators,
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            HIDDEN_SIZE);
+        break;
+    case HIDDEN_INT4:
+        dense_int8_int4w(
+            inputs,
+            g_hidden_weights_int4,
+            g_hidden_int4_folded_biases,
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            g_hidden_int4_multipliers,
+            g_hidden_int4_shifts,
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        break;
+    case HIDDEN_CODEBOOK16:
+    case HIDDEN_CODEBOOK32:
+        dense_int8_codebook(
+            inputs,
+            kernel == HIDDEN_CODEBOOK16 ? g_codebook16.indices : g_codebook32.indices,
+            kernel == HIDDEN_CODEBOOK16 ? g_codebook16.centroids : g_codebook32.centroids,
+            kernel == HIDDEN_CODEBOOK16 ? 16 : 32,
+            kernel == HIDDEN_CODEBOOK16 ? g_codebook16.folded_biases : g_codebook32.folded_biases,
+            hiddens,
+            (int8_t)g_params[HIDDEN_ZP_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            INPUT_SIZE,
+            HIDDEN_SIZE);
+        break;
+    default:
+        break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// hidden layer kernels over the real samples, with speedup vs. dense_int8
+static void run_hidden_kernels(uint32_t rounds, uint64_t *samples)
+{
+    int8_t hiddens[HIDDEN_SIZE];
+    uint64_t reference_median = 0;
+
+    printf("\nhidden layer kernels (ns)\n");
+    printf("%-24s %10s %10s %10s %8s\n", "kernel", "min", "median", "p99", "speedup");
+
+    for (uint32_t k = 0; k < NUM_HIDDEN_KERNELS; ++k)
+    {
+        for (uint32_t r = 0, i = 0; r < rounds; ++r)
+        {
+            for (uint32_t s = 0; s < NUM_SAMPLES; ++s, ++i)
+            {
+                uint64_t start = now_ns();
+                run_hidden_layer((hidden_kernel_t)k, g_inputs[s], hiddens);
+                uint64_t end = now_ns();
+                samples[i] = end - start;
+            }
+        }
+
+        stats_t stats = compute_stats(samples, rounds * NUM_SAMPLES);
+        if (k == HIDDEN_REFERENCE)
+        {
+            reference_median = stats.median;
+        }
+
+        printf("%-24s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %7.2fx\n",
+               g_hidden_kernel_names[k],
+               stats.min,
+               stats.median,
+               stats.p99,
+               (double)reference_median / (double)stats.median);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// hidden layer latency vs. input density on synthetic inputs, to place
+// CONFIG_MLP_SPARSE_DENSITY_THRESHOLD: 2% steps up to 50%, where the
+// row-major crossover lies, 10% steps above; the kernels take turns on every
+// iteration, so a noisy stretch of the host slows all of them alike
+static void run_density_sweep(uint64_t *samples)
+{
+    static const uint32_t densities[] = {
+        0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30, 32, 34, 36, 38, 40, 42, 44, 46, 48, 50,
+        60, 70, 80, 90, 100,
+    };
+    int8_t input_zp = (int8_t)g_params[INPUT_ZP_OFFSET];
+    int8_t inputs[INPUT_SIZE];
+    int8_t hiddens[HIDDEN_SIZE];
+    uint32_t seed = 1;
+    uint32_t crossover = 0;
+
+    printf("\ndensity sweep, hidden layer median (ns)\n");
+    printf("%-7s", "density");
+    for (uint32_t k = 0; k < NUM_HIDDEN_KERNELS; ++k)
+    {
+        printf(" %16s", g_hidden_kernel_names[k]);
+    }
+    printf("\n");
+
+    for (uint32_t d = 0; d < sizeof(densities) / sizeof(densities[0]); ++d)
+    {
+        uint32_t density = densities[d];
+        for (uint32_t ic = 0; ic < INPUT_SIZE; ++ic)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            int nonzero = (seed >> 8) % 100 < density;
+            inputs[ic] = nonzero ? (int8_t)(input_zp + 1 + (int32_t)((seed >> 20) % 127)) : input_zp;
+        }
+
+        uint64_t medians[NUM_HIDDEN_KERNELS];
+        for (uint32_t i = 0; i < SWEEP_ITERATIONS; ++i)
+        {
+            for (uint32_t k = 0; k < NUM_HIDDEN_KERNELS; ++k)
+            {
+                uint64_t start = now_ns();
+                run_hidden_layer((hidden_kernel_t)k, inputs, hiddens);
+                uint64_t end = now_ns();
+                samples[k * SWEEP_ITERATIONS + i] = end - start;
+            }
+        }
+        for (uint32_t k = 0; k < NUM_HIDDEN_KERNELS; ++k)
+        {
+            medians[k] = compute_stats(&samples[k * SWEEP_ITERATIONS], SWEEP_ITERATIONS).median;
+        }
+
+        printf("%6" PRIu32 "%% ", density);
+        for (uint32_t k = 0; k < NUM_HIDDEN_KERNELS; ++k)
+        {
+            printf(" %16" PRIu64, medians[k]);
+        }
+        printf("\n");
+
+        if (medians[HIDDEN_SPARSE] < medians[HIDDEN_DENSE])
+        {
+            crossover = density;
+        }
+    }
+
+    printf("row-major sparse wins up to %" PRIu32 "%% density (CONFIG_MLP_SPARSE_DENSITY_THRESHOLD=%d)\n",
+           crossover,
+           CONFIG_MLP_SPARSE_DENSITY_THRESHOLD);
+}
+
+// -----------------------------------------------------------------------------
+static uint32_t argmax_int8(const int8_t *values, uint32_t size)
+{
+    uint32_t best = 0;
+    for (uint32_t i = 1; i < size; ++i)
+    {
+        if (values[i] > values[best])
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// -----------------------------------------------------------------------------
+// compressed hidden layers vs. int8: footprint and output drift on the real
+// samples
+typedef struct
+{
+    const char *name;
+    void (*hidden)(const int8_t *inputs, int8_t *hiddens);
+    uint32_t weight_bytes;
+    uint32_t multiplies;
+} compressed_t;
+
+static void print_compressed_accuracy(void)
+{
+    const compressed_t formats[] = {
+        {"int8", reference_hidden, HIDDEN_WEIGHT_SIZE, INPUT_SIZE * HIDDEN_SIZE},
+        {"int4", int4_hidden, DENSE_INT4_SIZE(INPUT_SIZE, HIDDEN_SIZE), INPUT_SIZE * HIDDEN_SIZE},
+        {
+            "codebook-16",
+            codebook16_hidden,
+            DENSE_CODEBOOK_SIZE(INPUT_SIZE, HIDDEN_SIZE, 16) + HIDDEN_SIZE * 16 * sizeof(int16_t),
+            16 * HIDDEN_SIZE,
+        },
+        {
+            "codebook-32",
+            codebook32_hidden,
+            DENSE_CODEBOOK_SIZE(INPUT_SIZE, HIDDEN_SIZE, 32) + HIDDEN_SIZE * 32 * sizeof(int16_t),
+            32 * HIDDEN_SIZE,
+        },
+    };
+
+    printf("\ncompressed hidden layer vs. int8 on the samples\n");
+    printf("%-12s %8s %8s %6s %12s %12s\n", "format", "bytes", "MACs", "top-1", "max |d| hid", "max |d| out");
+
+    for (uint32_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+    {
+        uint32_t agree = 0;
+        int32_t max_hidden_diff = 0;
+        int32_t max_logit_diff = 0;
+
+        for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+        {
+            int8_t hiddens8[HIDDEN_SIZE];
+            int8_t hiddens[HIDDEN_SIZE];
+            int8_t logits8[OUTPUT_SIZE];
+            int8_t logits[OUTPUT_SIZE];
+
+            reference_hidden(g_inputs[s], hiddens8);
+            formats[f].hidden(g_inputs[s], hiddens);
+            reference_logits(hiddens8, logits8);
+            reference_logits(hiddens, logits);
+
+            for (uint32_t i = 0; i < HIDDEN_SIZE; ++i)
+            {
+                int32_t diff = abs((int32_t)hiddens8[i] - (int32_t)hiddens[i]);
+                max_hidden_diff = diff > max_hidden_diff ? diff : max_hidden_diff;
+            }
+            for (uint32_t i = 0; i < OUTPUT_SIZE; ++i)
+            {
+                int32_t diff = abs((int32_t)logits8[i] - (int32_t)logits[i]);
+                max_logit_diff = diff > max_logit_diff ? diff : max_logit_diff;
+            }
+
+            agree += argmax_int8(logits8, OUTPUT_SIZE) == argmax_int8(logits, OUTPUT_SIZE) ? 1 : 0;
+        }
+
+        printf("%-12s %8" PRIu32 " %8" PRIu32 " %3" PRIu32 "/%-2d %12" PRId32 " %12" PRId32 "\n",
+               formats[f].name,
+               formats[f].weight_bytes,
+               formats[f].multiplies,
+               agree,
+               NUM_SAMPLES,
+               max_hidden_diff,
+               max_logit_diff);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// block-sparse hidden layer vs. the dense (folded) kernel across pruning
+// levels, plus top-1 agreement of the pruned model with the unpruned one
+static void run_block_sparse_sweep(uint32_t rounds, uint64_t *samples)
+{
+    int8_t hiddens[HIDDEN_SIZE];
+    int8_t logits[OUTPUT_SIZE];
+    int8_t expected_logits[OUTPUT_SIZE];
+    uint64_t dense_median;
+    uint32_t crossover = 101;
+
+    for (uint32_t r = 0, i = 0; r < rounds; ++r)
+    {
+        for (uint32_t s = 0; s < NUM_SAMPLES; ++s, ++i)
+        {
+            uint64_t start = now_ns();
+            run_hidden_layer(HIDDEN_DENSE, g_inputs[s], hiddens);
+            uint64_t end = now_ns();
+            samples[i] = end - start;
+        }
+    }
+    dense_median = compute_stats(samples, rounds * NUM_SAMPLES).median;
+
+    printf("\nblock-sparse (1x%d) hidden layer vs. folded dense (%" PRIu64 " ns median)\n", DENSE_SPARSE_BLOCK, dense_median);
+    printf("%-9s %8s %10s %10s %8s %6s\n", "sparsity", "blocks", "bytes", "median", "speedup", "top-1");
+
+    for (uint32_t sparsity = 0; sparsity <= 90; sparsity += 10)
+    {
+        uint32_t blocks = prepare_block_sparse(sparsity);
+
+        uint32_t agree = 0;
+        for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+        {
+            int8_t expected_hiddens[HIDDEN_SIZE];
+            reference_hidden(g_inputs[s], expected_hiddens);
+            reference_logits(expected_hiddens, expected_logits);
+            block_sparse_hidden(g_inputs[s], hiddens);
+            reference_logits(hiddens, logits);
+            agree += argmax_int8(expected_logits, OUTPUT_SIZE) == argmax_int8(logits, OUTPUT_SIZE) ? 1 : 0;
+        }
+
+        for (uint32_t r = 0, i = 0; r < rounds; ++r)
+        {
+            for (uint32_t s = 0; s < NUM_SAMPLES; ++s, ++i)
+            {
+                uint64_t start = now_ns();
+                block_sparse_hidden(g_inputs[s], hiddens);
+                uint64_t end = now_ns();
+                samples[i] = end - start;
+            }
+        }
+        uint64_t median = compute_stats(samples, rounds * NUM_SAMPLES).median;
+
+        if (median < dense_median && sparsity < crossover)
+        {
+            crossover = sparsity;
+        }
+
+        // values + block indices + row pointers
+        uint32_t bytes = blocks * (DENSE_SPARSE_BLOCK + sizeof(uint16_t)) + (HIDDEN_SIZE + 1) * sizeof(uint32_t);
+        printf("%8" PRIu32 "%% %8" PRIu32 " %10" PRIu32 " %10" PRIu64 " %7.2fx %3" PRIu32 "/%d\n",
+               sparsity,
+               blocks,
+               bytes,
+               median,
+               (double)dense_median / (double)median,
+               agree,
+               NUM_SAMPLES);
+    }
+
+    if (crossover <= 100)
+    {
+        printf("block-sparse beats dense from %" PRIu32 "%% sparsity\n", crossover);
+    }
+    else
+    {
+        printf("block-sparse never beats dense\n");
+    }
+
+    prepare_block_sparse(CHECK_BLOCK_SPARSITY);
+}
+
+// -----------------------------------------------------------------------------
+static void print_paths(void)
+{
+    printf("\nforward_pass hidden layer path\n");
+    for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+    {
+        int8_t input_zp = (int8_t)g_params[INPUT_ZP_OFFSET];
+        uint32_t count = 0;
+        for (uint32_t ic = 0; ic < INPUT_SIZE; ++ic)
+        {
+            count += (g_inputs[s][ic] != input_zp) ? 1 : 0;
+        }
+        printf("sample %" PRIu32 ": density %3" PRIu32 "%% -> %s\n",
+               s,
+               count * 100 / INPUT_SIZE,
+               forward_pass_path(g_inputs[s]) == MLP_PATH_SPARSE ? "sparse" : "dense");
+    }
+}
+
+// -----------------------------------------------------------------------------
+// latency forward_pass_topk saves over forward_pass per inference
+static void print_topk_savings(const stats_t *variant_stats)
+{
+    const stats_t *full = NULL;
+    printf("\ntop-1 vs forward_pass (ns saved per inference)\n");
+    printf("%-24s %10s %10s\n", "variant", "min", "median");
+    for (uint32_t v = 0; v < NUM_VARIANTS; ++v)
+    {
+        if (g_variants[v].forward == forward_pass)
+        {
+            full = &variant_stats[v];
+        }
+    }
+    for (uint32_t v = 0; v < NUM_VARIANTS; ++v)
+    {
+        if (g_variants[v].forward == top1_forward || g_variants[v].forward == top1_early_forward)
+        {
+            printf("%-24s %10" PRId64 " %10" PRId64 "\n",
+                   g_variants[v].name,
+                   (int64_t)full->min - (int64_t)variant_stats[v].min,
+                   (int64_t)full->median - (int64_t)variant_stats[v].median);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// delta inference against a full recompute: stroke-like frames (a few pixels
+// set per frame), frames that change everything, forced delta on large
+// changes and resets
+static int check_delta(void)
+{
+    static const uint32_t changes[] = {0, 1, 3, 8, 20, 100, 400};
+    int failures = 0;
+    uint32_t seed = 3;
+    mlp_model_t model;
+    mlp_delta_t delta;
+    int8_t frame[INPUT_SIZE] __attribute__((aligned(16)));
+    int8_t expected[OUTPUT_SIZE];
+    int8_t outputs[OUTPUT_SIZE];
+
+    if (mlp_model_init(&model, g_params, PARAMS_SIZE) != 0)
+    {
+        fprintf(stderr, "mlp_model_init: rejected g_params\n");
+        return 1;
+    }
+    mlp_delta_init(&delta, &model);
+    memcpy(frame, g_inputs[0], INPUT_SIZE);
+
+    for (uint32_t f = 0; f < DELTA_CHECK_FRAMES; ++f)
+    {
+        int8_t previous[INPUT_SIZE];
+        memcpy(previous, frame, INPUT_SIZE);
+
+        if (f % 50 == 25)
+        {
+            // another digit altogether
+            memcpy(frame, g_inputs[f % NUM_SAMPLES], INPUT_SIZE);
+        }
+        else
+        {
+            uint32_t count = changes[f % (sizeof(changes) / sizeof(changes[0]))];
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                frame[next_random(&seed) % INPUT_SIZE] = (int8_t)(next_random(&seed) & 0xff);
+            }
+        }
+        if (f % 70 == 69)
+        {
+            mlp_delta_reset(&delta);
+        }
+        // every third frame takes the delta path whatever the change
+        delta.full_threshold = (f % 3 == 0) ? INPUT_SIZE : CONFIG_MLP_DELTA_FULL_THRESHOLD * INPUT_SIZE / 100;
+
+        uint32_t changed = 0;
+        for (uint32_t ic = 0; ic < INPUT_SIZE; ++ic)
+        {
+            changed += (frame[ic] != previous[ic]) ? 1 : 0;
+        }
+        int was_valid = delta.valid;
+
+        reference_forward(frame, expected);
+        uint32_t count = mlp_delta_forward(&delta, frame, outputs);
+        failures += check_equal("mlp_delta_forward", f, expected, outputs, OUTPUT_SIZE);
+        if (count != (was_valid ? changed : INPUT_SIZE))
+        {
+            fprintf(stderr, "mlp_delta_forward: frame %" PRIu32 " reports %" PRIu32 " changed pixels, not %" PRIu32 "\n",
+                    f, count, was_valid ? changed : INPUT_SIZE);
+            ++failures;
+        }
+    }
+
+    return failures;
+}
+
+#if CONFIG_MLP_PLAN_EXECUTOR && !CONFIG_MLP_HIDDEN_INT4 && !CONFIG_MLP_HIDDEN_BLOCK_SPARSE && !CONFIG_MLP_HIDDEN_CODEBOOK
+// -----------------------------------------------------------------------------
+// the hidden activation of the plan reaches every path of the model context:
+// a copy of g_params with the plan's first layer switched to ReLU6 and to a
+// tanh lookup, against the plan executor over the same copy
+static int check_hidden_activations(void)
+{
+    static uint8_t params[PARAMS_SIZE + DENSE_LUT_SIZE] __attribute__((aligned(16)));
+    int failures = 0;
+
+    for (uint8_t activation = MLP_ACTIVATION_RELU6; activation <= MLP_ACTIVATION_LUT; ++activation)
+    {
+        memcpy(params, g_params, PARAMS_SIZE);
+        mlp_plan_layer_t *layer = (mlp_plan_layer_t *)((mlp_plan_t *)&params[PLAN_OFFSET] + 1);
+        layer->activation = activation;
+        layer->activation_offset = PARAMS_SIZE;
+        if (activation == MLP_ACTIVATION_RELU6)
+        {
+            params[PARAMS_SIZE] = (uint8_t)(layer->output_zp + 40);
+        }
+        else
+        {
+            dense_activation_lut(DENSE_LUT_TANH, 0.05f, layer->output_zp, 1.0f / 128.0f, 0, (int8_t *)&params[PARAMS_SIZE]);
+        }
+
+        mlp_model_t model;
+        mlp_delta_t delta;
+        if (mlp_model_init(&model, params, sizeof(params)) != 0)
+        {
+            fprintf(stderr, "MISMATCH: mlp_model_init (hidden activation %u)\n", activation);
+            return failures + 1;
+        }
+        mlp_delta_init(&delta, &model);
+
+        int8_t batch_outputs[NUM_SAMPLES][OUTPUT_SIZE];
+        mlp_model_forward_batch(&model, &g_inputs[0][0], &batch_outputs[0][0], NUM_SAMPLES);
+        const softmax_params_t *softmax_params = (const softmax_params_t *)&params[SOFTMAX_PARAMS_OFFSET];
+        for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+        {
+            int8_t arena[PLAN_ARENA_SIZE] __attribute__((aligned(16)));
+            int8_t expected[OUTPUT_SIZE];
+            int8_t outputs[OUTPUT_SIZE];
+            uint32_t classes[OUTPUT_SIZE];
+            int8_t top_logits[OUTPUT_SIZE];
+            int8_t logits[OUTPUT_SIZE];
+
+            mlp_plan_run(model.plan, params, arena, g_inputs[s], expected);
+            mlp_model_forward(&model, g_inputs[s], outputs);
+            failures += check_equal("mlp_model_forward (hidden activation)", s, expected, outputs, OUTPUT_SIZE);
+            failures += check_equal("mlp_model_forward_batch (hidden activation)", s, expected, batch_outputs[s], OUTPUT_SIZE);
+
+            mlp_model_topk(&model, g_inputs[s], OUTPUT_SIZE, 0, classes, top_logits);
+            for (uint32_t i = 0; i < OUTPUT_SIZE; ++i)
+            {
+                logits[classes[i]] = top_logits[i];
+            }
+            softmax_int8(logits, outputs, OUTPUT_SIZE, softmax_params);
+            failures += check_equal("mlp_model_topk (hidden activation)", s, expected, outputs, OUTPUT_SIZE);
+
+            mlp_delta_forward(&delta, g_inputs[s], outputs);
+            failures += check_equal("mlp_delta_forward (hidden activation)", s, expected, outputs, OUTPUT_SIZE);
+        }
+    }
+
+    return failures;
+}
+#endif
+
+#if !MLP_WEIGHTS_DERIVED
+// -----------------------------------------------------------------------------
+// one corruption of a valid container, which mlp_model_load must reject;
+// refresh_crc keeps the checksum valid so the check behind it runs
+static int check_container_rejects(const char *what, const uint8_t *valid, uint32_t size, uint8_t *scratch,
+                                   void (*corrupt)(uint8_t *container, uint32_t *size), int refresh_crc)
+{
+    mlp_model_t model;
+
+    memcpy(scratch, valid, size);
+    corrupt(scratch, &size);
+    if (refresh_crc)
+    {
+        mlp_container_header_t *header = (mlp_container_header_t *)scratch;
+        header->data_crc32 = mlp_container_crc32(0, &scratch[header->data_offset], header->data_size);
+    }
+    if (mlp_model_load(&model, scratch, size) == 0)
+    {
+        fprintf(stderr, "mlp_model_load: accepted a container with %s\n", what);
+        return 1;
+    }
+    return 0;
+}
+
+static mlp_tensor_desc_t *container_tensors(uint8_t *container)
+{
+    return (mlp_tensor_desc_t *)&container[sizeof(mlp_container_header_t)];
+}
+
+static void corrupt_magic(uint8_t *container, uint32_t *size)
+{
+    (void)size;
+    ((mlp_container_header_t *)container)->magic ^= 1;
+}
+
+static void corrupt_version(uint8_t *container, uint32_t *size)
+{
+    (void)size;
+    ((mlp_container_header_t *)container)->version = MLP_CONTAINER_VERSION + 1;
+}
+
+static void corrupt_truncated(uint8_t *container, uint32_t *size)
+{
+    (void)container;
+    *size -= 1;
+}
+
+static void corrupt_dims(uint8_t *container, uint32_t *size)
+{
+    (void)size;
+    ((mlp_container_header_t *)container)->hidden_size = HIDDEN_SIZE / 2;
+}
+
+static void corrupt_data(uint8_t *container, uint32_t *size)
+{
+    (void)size;
+    container[((mlp_container_header_t *)container)->data_offset + 1000] ^= 0x10;
+}
+
+static void corrupt_alignment(uint8_t *container, uint32_t *size)
+{
+    (void)size;
+    container_tensors(container)[0].offset += 1;
+}
+
+static void corrupt_shape(uint8_t *container, uint32_t *size)
+{
+    (void)size;
+    container_tensors(container)[0].shape[1] = HIDDEN_SIZE;
+}
+
+static void corrupt_dtype(uint8_t *container, uint32_t *size)
+{
+    (void)size;
+    container_tensors(container)[4].dtype = MLP_DTYPE_INT8;
+}
+
+static void corrupt_bounds(uint8_t *container, uint32_t *size)
+{
+    (void)size;
+    container_tensors(container)[4].offset = ((mlp_container_header_t *)container)->data_size;
+}
+
+static void corrupt_duplicate(uint8_t *container, uint32_t *size)
+{
+    (void)size;
+    container_tensors(container)[3].id = container_tensors(container)[1].id;
+}
+
+static void corrupt_missing(uint8_t *container, uint32_t *size)
+{
+    (void)size;
+    container_tensors(container)[0].id = 0x7fff;
+}
+
+#if CONFIG_MLP_PLAN_EXECUTOR
+static void corrupt_plan(uint8_t *container, uint32_t *size)
+{
+    (void)size;
+    const mlp_container_header_t *header = (const mlp_container_header_t *)container;
+    const mlp_tensor_desc_t *plan = mlp_container_tensor(container, MLP_TENSOR_PLAN);
+    mlp_plan_layer_t *layers = (mlp_plan_layer_t *)&container[header->data_offset + plan->offset + sizeof(mlp_plan_t)];
+    layers[0].weight_offset = header->data_size;
+}
+
+// a consistent plan for one output fewer, which mlp_plan_get accepts but the
+// built-in sequence can't run
+static void corrupt_plan_size(uint8_t *container, uint32_t *size)
+{
+    (void)size;
+    const mlp_container_header_t *header = (const mlp_container_header_t *)container;
+    const mlp_tensor_desc_t *tensor = mlp_container_tensor(container, MLP_TENSOR_PLAN);
+    mlp_plan_t *plan = (mlp_plan_t *)&container[header->data_offset + tensor->offset];
+    mlp_plan_layer_t *layers = (mlp_plan_layer_t *)(plan + 1);
+    for (uint32_t l = 1; l < plan->layer_count; ++l)
+    {
+        layers[l].input_size -= (layers[l].type == MLP_LAYER_SOFTMAX) ? 1 : 0;
+        layers[l].output_size -= 1;
+    }
+    plan->output_size -= 1;
+}
+#endif
+#endif
+
+// -----------------------------------------------------------------------------
+// g_params converted to a model container: loaded in memory and through
+// mlp_model_map it must match forward_pass, and every kind of damage must be
+// caught at load time; the layouts derived from g_params have no
+// mlp_model_load, only the conversion runs there
+static int check_container(void)
+{
+    int failures = 0;
+
+    if (mlp_container_crc32(0, (const uint8_t *)"123456789", 9) != 0xcbf43926)
+    {
+        fprintf(stderr, "mlp_container_crc32: wrong check value\n");
+        return 1;
+    }
+
+    uint32_t size = container_build(g_params, NULL, 0);
+    uint8_t *container = aligned_alloc(MLP_CONTAINER_ALIGN, MLP_CONTAINER_ALIGN_UP(size));
+    uint8_t *scratch = aligned_alloc(MLP_CONTAINER_ALIGN, MLP_CONTAINER_ALIGN_UP(size + 1));
+    if (container == NULL || scratch == NULL || container_build(g_params, container, size) != size)
+    {
+        fprintf(stderr, "container_build: can't convert g_params\n");
+        free(container);
+        free(scratch);
+        return 1;
+    }
+
+#if !MLP_WEIGHTS_DERIVED
+    mlp_model_t model;
+    mlp_model_mapping_t mapping;
+    int8_t expected[OUTPUT_SIZE];
+    int8_t outputs[OUTPUT_SIZE];
+
+    // 1) in memory
+    if (mlp_model_load(&model, container, size) != 0)
+    {
+        fprintf(stderr, "mlp_model_load: rejected the converted g_params\n");
+        ++failures;
+    }
+    else
+    {
+        for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+        {
+            forward_pass(g_inputs[s], expected);
+            mlp_model_forward(&model, g_inputs[s], outputs);
+            failures += check_equal("mlp_model_load", s, expected, outputs, OUTPUT_SIZE);
+        }
+    }
+
+    // 2) mapped from a file
+    char path[] = "/tmp/mlp_containerXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0 || write(fd, container, size) != (ssize_t)size)
+    {
+        fprintf(stderr, "Cannot write %s\n", path);
+        ++failures;
+    }
+    else if (mlp_model_map(path, &model, &mapping) != 0)
+    {
+        fprintf(stderr, "mlp_model_map: can't map %s\n", path);
+        ++failures;
+    }
+    else
+    {
+        for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+        {
+            forward_pass(g_inputs[s], expected);
+            mlp_model_forward(&model, g_inputs[s], outputs);
+            failures += check_equal("mlp_model_map", s, expected, outputs, OUTPUT_SIZE);
+        }
+        mlp_model_unmap(&mapping);
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+        unlink(path);
+    }
+
+    // 3) damage
+    failures += check_container_rejects("a bad magic", container, size, scratch, corrupt_magic, 0);
+    failures += check_container_rejects("a newer version", container, size, scratch, corrupt_version, 0);
+    failures += check_container_rejects("a truncated data section", container, size, scratch, corrupt_truncated, 0);
+    failures += check_container_rejects("other model dimensions", container, size, scratch, corrupt_dims, 0);
+    failures += check_container_rejects("a flipped data bit", container, size, scratch, corrupt_data, 0);
+    failures += check_container_rejects("a misaligned tensor", container, size, scratch, corrupt_alignment, 0);
+    failures += check_container_rejects("a tensor of the wrong shape", container, size, scratch, corrupt_shape, 0);
+    failures += check_container_rejects("a tensor of the wrong dtype", container, size, scratch, corrupt_dtype, 0);
+    failures += check_container_rejects("a tensor out of bounds", container, size, scratch, corrupt_bounds, 0);
+    failures += check_container_rejects("a duplicate tensor", container, size, scratch, corrupt_duplicate, 0);
+    failures += check_container_rejects("a missing tensor", container, size, scratch, corrupt_missing, 0);
+#if CONFIG_MLP_PLAN_EXECUTOR
+    failures += check_container_rejects("a broken plan", container, size, scratch, corrupt_plan, 1);
+    failures += check_container_rejects("a plan of other dimensions", container, size, scratch, corrupt_plan_size, 1);
+#endif
+
+    // a misaligned mapping
+    memcpy(&scratch[1], container, size);
+    if (mlp_model_load(&model, &scratch[1], size) == 0)
+    {
+        fprintf(stderr, "mlp_model_load: accepted a misaligned container\n");
+        ++failures;
+    }
+#endif
+
+    free(container);
+    free(scratch);
+    return failures;
+}
+
+// -----------------------------------------------------------------------------
+// place a g_params model per policy and run it against forward_pass; returns
+// the failures, -1 in *fallbacks if the policy was rejected
+static int check_placed_model(const char *what, const mlp_placement_policy_t *policy, mlp_placement_t *placement, int *fallbacks)
+{
+    int failures = 0;
+    mlp_model_t model;
+    mlp_model_t flash;
+    int8_t expected[OUTPUT_SIZE];
+    int8_t outputs[OUTPUT_SIZE];
+
+    mlp_model_init(&model, g_params, PARAMS_SIZE);
+    flash = model;
+    *fallbacks = mlp_model_place(&model, policy, placement);
+    if (*fallbacks < 0)
+    {
+        if (memcmp(&model, &flash, sizeof(model)) != 0)
+        {
+            fprintf(stderr, "mlp_model_place (%s): changed the model of a rejected policy\n", what);
+            ++failures;
+        }
+        return failures;
+    }
+
+    // every copy is aligned and outside the blob
+    for (uint32_t i = 0; i < placement->copy_count; ++i)
+    {
+        const uint8_t *copy = placement->copies[i];
+        if (((uintptr_t)copy % MLP_CONTAINER_ALIGN) != 0 ||
+            (copy + placement->copy_sizes[i] > g_params && copy < g_params + PARAMS_SIZE))
+        {
+            fprintf(stderr, "mlp_model_place (%s): copy %" PRIu32 " misplaced\n", what, i);
+            ++failures;
+        }
+    }
+    if (placement->copy_count != placement->tensors[MLP_PLACE_DRAM] + placement->tensors[MLP_PLACE_PSRAM] ||
+        mlp_region_mock_used(MLP_PLACE_DRAM) != placement->bytes[MLP_PLACE_DRAM] ||
+        mlp_region_mock_used(MLP_PLACE_PSRAM) != placement->bytes[MLP_PLACE_PSRAM])
+    {
+        fprintf(stderr, "mlp_model_place (%s): footprint doesn't match the allocations\n", what);
+        ++failures;
+    }
+    if (model.hidden_weights == flash.hidden_weights && policy->place[MLP_TENSOR_HIDDEN_WEIGHTS] != MLP_PLACE_FLASH &&
+        *fallbacks == 0)
+    {
+        fprintf(stderr, "mlp_model_place (%s): hidden weights not moved\n", what);
+        ++failures;
+    }
+    if (model.output_weights != flash.output_weights && policy->place[MLP_TENSOR_OUTPUT_WEIGHTS] == MLP_PLACE_FLASH)
+    {
+        fprintf(stderr, "mlp_model_place (%s): output weights moved\n", what);
+        ++failures;
+    }
+
+    for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+    {
+        forward_pass(g_inputs[s], expected);
+        mlp_model_forward(&model, g_inputs[s], outputs);
+        failures += check_equal(what, s, expected, outputs, OUTPUT_SIZE);
+    }
+    return failures;
+}
+
+// -----------------------------------------------------------------------------
+// placement policies over the mock regions: all in flash, the Kconfig
+// defaults, everything in DRAM, and regions too small to hold it all
+static int check_placement(void)
+{
+    int failures = 0;
+    int fallbacks;
+    mlp_placement_policy_t policy;
+    mlp_placement_t placement;
+
+    memset(&policy, MLP_PLACE_FLASH, sizeof(policy));
+    failures += check_placed_model("mlp_model_place (flash)", &policy, &placement, &fallbacks);
+    uint32_t total = placement.bytes[MLP_PLACE_FLASH];
+    if (fallbacks != 0 || placement.copy_count != 0 || total == 0)
+    {
+        fprintf(stderr, "mlp_model_place (flash): copied tensors\n");
+        ++failures;
+    }
+
+    mlp_placement_policy_default(&policy);
+    failures += check_placed_model("mlp_model_place (default)", &policy, &placement, &fallbacks);
+    mlp_placement_release(&placement);
+#if CONFIG_MLP_PLAN_EXECUTOR || MLP_WEIGHTS_DERIVED
+    // the plan reads the blob, the derived layouts their own tables: only an
+    // all-flash policy goes
+    if (fallbacks >= 0)
+    {
+        fprintf(stderr, "mlp_model_place: accepted a policy this build can't honor\n");
+        ++failures;
+    }
+#else
+    if (fallbacks != 0)
+    {
+        fprintf(stderr, "mlp_model_place (default): %d fallbacks\n", fallbacks);
+        ++failures;
+    }
+
+    memset(&policy, MLP_PLACE_DRAM, sizeof(policy));
+    failures += check_placed_model("mlp_model_place (DRAM)", &policy, &placement, &fallbacks);
+    if (fallbacks != 0 || placement.bytes[MLP_PLACE_DRAM] != total)
+    {
+        fprintf(stderr, "mlp_model_place (DRAM): %" PRIu32 " of %" PRIu32 " bytes placed\n", placement.bytes[MLP_PLACE_DRAM], total);
+        ++failures;
+    }
+    mlp_placement_release(&placement);
+
+    // no PSRAM and 2 KB of DRAM: the hidden weights stay in flash, the DRAM
+    // fills up with the first tables and the rest falls back
+    mlp_region_mock_set(2048, 0);
+    policy.place[MLP_TENSOR_HIDDEN_WEIGHTS] = MLP_PLACE_PSRAM;
+    failures += check_placed_model("mlp_model_place (out of memory)", &policy, &placement, &fallbacks);
+    if (fallbacks <= 1 || placement.bytes[MLP_PLACE_DRAM] > 2048 || placement.bytes[MLP_PLACE_PSRAM] != 0 ||
+        placement.bytes[MLP_PLACE_FLASH] + placement.bytes[MLP_PLACE_DRAM] != total ||
+        placement.fallbacks != (uint32_t)fallbacks)
+    {
+        fprintf(stderr, "mlp_model_place (out of memory): %d fallbacks, %" PRIu32 " bytes in DRAM\n", fallbacks, placement.bytes[MLP_PLACE_DRAM]);
+        ++failures;
+    }
+    mlp_placement_release(&placement);
+    mlp_region_mock_set(512u << 10, 8u << 20);
+#endif
+    if (mlp_region_mock_used(MLP_PLACE_DRAM) != 0 || mlp_region_mock_used(MLP_PLACE_PSRAM) != 0)
+    {
+        fprintf(stderr, "mlp_placement_release: regions not freed\n");
+        ++failures;
+    }
+
+    policy.place[MLP_TENSOR_OUTPUT_WEIGHTS] = MLP_PLACE_COUNT;
+    if (mlp_model_place(&(mlp_model_t){0}, &policy, &placement) != -1)
+    {
+        fprintf(stderr, "mlp_model_place: accepted an unknown region\n");
+        ++failures;
+    }
+    return failures;
+}
+
+// -----------------------------------------------------------------------------
+// g_params as a container in a temporary file (path: a mkstemp template,
+// remove it afterwards); returns 0 on success
+static int write_container_file(char *path)
+{
+    uint32_t size = container_build(g_params, NULL, 0);
+    uint8_t *container = malloc(size);
+    int fd = mkstemp(path);
+    int result = (container != NULL && fd >= 0 && container_build(g_params, container, size) == size &&
+                  write(fd, container, size) == (ssize_t)size) ? 0 : -1;
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    free(container);
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+// streamed weights vs. the int8 reference over g_params, which the container
+// is built from (not forward_pass: in the CONFIG_MLP_HIDDEN_* builds that runs
+// the compressed hidden layer): tiles of one row, of a few rows and of a whole
+// layer, two passes over the samples each (the second pass starts from the
+// tile prefetched by the first); then the containers it must reject
+static int check_stream(void)
+{
+    static const uint32_t tile_sizes[] = {INPUT_SIZE, 4096, HIDDEN_WEIGHT_SIZE};
+    int failures = 0;
+    mlp_stream_t stream;
+    int8_t expected[OUTPUT_SIZE];
+    int8_t outputs[OUTPUT_SIZE];
+    char path[] = "/tmp/mlp_streamXXXXXX";
+
+    if (write_container_file(path) != 0)
+    {
+        fprintf(stderr, "Cannot write %s\n", path);
+        unlink(path);
+        return 1;
+    }
+
+#if CONFIG_MLP_PLAN_EXECUTOR
+    if (mlp_stream_open(&stream, path, CONFIG_MLP_STREAM_TILE_SIZE) == 0)
+    {
+        fprintf(stderr, "mlp_stream_open: opened a model for the plan executor\n");
+        mlp_stream_close(&stream);
+        ++failures;
+    }
+    (void)tile_sizes;
+    (void)expected;
+    (void)outputs;
+#else
+    for (uint32_t t = 0; t < sizeof(tile_sizes) / sizeof(tile_sizes[0]); ++t)
+    {
+        if (mlp_stream_open(&stream, path, tile_sizes[t]) != 0)
+        {
+            fprintf(stderr, "mlp_stream_open: can't open %s with %" PRIu32 "-byte tiles\n", path, tile_sizes[t]);
+            ++failures;
+            continue;
+        }
+        for (uint32_t i = 0; i < 2 * NUM_SAMPLES; ++i)
+        {
+            uint32_t s = i % NUM_SAMPLES;
+            reference_forward(g_inputs[s], expected);
+            if (mlp_stream_forward(&stream, g_inputs[s], outputs) != 0)
+            {
+                fprintf(stderr, "mlp_stream_forward: read failed\n");
+                ++failures;
+            }
+            failures += check_equal("mlp_stream_forward", s, expected, outputs, OUTPUT_SIZE);
+        }
+        mlp_stream_close(&stream);
+    }
+
+    if (mlp_stream_open(&stream, path, INPUT_SIZE - 1) == 0)
+    {
+        fprintf(stderr, "mlp_stream_open: accepted tiles smaller than a row\n");
+        mlp_stream_close(&stream);
+        ++failures;
+    }
+
+    // a flipped data bit fails the streamed CRC
+    FILE *file = fopen(path, "r+b");
+    mlp_container_header_t header;
+    if (file == NULL || fread(&header, sizeof(header), 1, file) != 1 ||
+        fseek(file, (long)header.data_offset + 1000, SEEK_SET) != 0 || fputc(0x10, file) == EOF)
+    {
+        fprintf(stderr, "Cannot corrupt %s\n", path);
+        ++failures;
+    }
+    if (file != NULL)
+    {
+        fclose(file);
+    }
+    if (mlp_stream_open(&stream, path, CONFIG_MLP_STREAM_TILE_SIZE) == 0)
+    {
+        fprintf(stderr, "mlp_stream_open: accepted a container with a flipped data bit\n");
+        mlp_stream_close(&stream);
+        ++failures;
+    }
+#endif
+    unlink(path);
+
+    if (mlp_stream_open(&stream, path, CONFIG_MLP_STREAM_TILE_SIZE) == 0)
+    {
+        fprintf(stderr, "mlp_stream_open: opened a missing file\n");
+        mlp_stream_close(&stream);
+        ++failures;
+    }
+    if (mlp_region_mock_used(MLP_PLACE_DRAM) != 0)
+    {
+        fprintf(stderr, "mlp_stream_close: tiles not freed\n");
+        ++failures;
+    }
+    return failures;
+}
+
+// -----------------------------------------------------------------------------
+// latency vs changed pixels: frames alternate between a digit and a copy with
+// changed pixels flipped, so every call sees exactly that many changes; the
+// delta path is forced and compared with forward_pass on the same frames
+static void run_delta_sweep(uint64_t *samples)
+{
+    static const uint32_t changes[] = {0, 1, 2, 4, 8, 16, 32, 64, 128, 196, 256, 392, 784};
+    mlp_model_t model;
+    mlp_delta_t delta;
+    int8_t frames[2][INPUT_SIZE] __attribute__((aligned(16)));
+    int8_t outputs[OUTPUT_SIZE];
+    uint32_t seed = 5;
+    uint32_t crossover = 0;
+
+    mlp_model_init(&model, g_params, PARAMS_SIZE);
+    mlp_delta_init(&delta, &model);
+    delta.full_threshold = INPUT_SIZE;
+
+    printf("\ndelta inference, median (ns)\n");
+    printf("%-8s %12s %12s\n", "changed", "delta", "forward_pass");
+
+    for (uint32_t c = 0; c < sizeof(changes) / sizeof(changes[0]); ++c)
+    {
+        memcpy(frames[0], g_inputs[3], INPUT_SIZE);
+        memcpy(frames[1], g_inputs[3], INPUT_SIZE);
+        // flip changes[c] distinct pixels: pick from a shuffled index list
+        uint16_t order[INPUT_SIZE];
+        for (uint32_t ic = 0; ic < INPUT_SIZE; ++ic)
+        {
+            order[ic] = (uint16_t)ic;
+        }
+        for (uint32_t ic = INPUT_SIZE - 1; ic > 0; --ic)
+        {
+            uint32_t j = next_random(&seed) % (ic + 1);
+            uint16_t t = order[ic];
+            order[ic] = order[j];
+            order[j] = t;
+        }
+        for (uint32_t i = 0; i < changes[c]; ++i)
+        {
+            frames[1][order[i]] = (int8_t)(frames[0][order[i]] ^ 0x55);
+        }
+
+        mlp_delta_reset(&delta);
+        mlp_delta_forward(&delta, frames[0], outputs);
+        for (uint32_t i = 0; i < SWEEP_ITERATIONS; ++i)
+        {
+            uint64_t start = now_ns();
+            mlp_delta_forward(&delta, frames[(i + 1) & 1], outputs);
+            uint64_t end = now_ns();
+            samples[i] = end - start;
+        }
+        uint64_t delta_median = compute_stats(samples, SWEEP_ITERATIONS).median;
+
+        for (uint32_t i = 0; i < SWEEP_ITERATIONS; ++i)
+        {
+            uint64_t start = now_ns();
+            forward_pass(frames[(i + 1) & 1], outputs);
+            uint64_t end = now_ns();
+            samples[i] = end - start;
+        }
+        uint64_t full_median = compute_stats(samples, SWEEP_ITERATIONS).median;
+
+        printf("%-8" PRIu32 " %12" PRIu64 " %12" PRIu64 "\n", changes[c], delta_median, full_median);
+        if (delta_median < full_median)
+        {
+            crossover = changes[c];
+        }
+    }
+
+    printf("delta wins up to %" PRIu32 " changed pixels (%" PRIu32 "%%, CONFIG_MLP_DELTA_FULL_THRESHOLD=%d)\n",
+           crossover,
+           crossover * 100 / INPUT_SIZE,
+           CONFIG_MLP_DELTA_FULL_THRESHOLD);
+}
+
+// -----------------------------------------------------------------------------
+// host stand-in for streaming the device's dummy flash partition (see
+// latency_bench_evict): write one byte per cache line of a buffer far larger
+// than the last-level cache, so the next inference reads its weights (and
+// code) from DRAM again
+static void evict_caches(uint8_t *buffer)
+{
+    for (uint32_t i = 0; i < EVICT_SIZE; i += 64)
+    {
+        buffer[i] += 1;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// cold vs. warm cache: COLD_ITERATIONS inferences back to back, then as many
+// each right after evict_caches; a device that wakes up for one inference
+// pays the cold number
+static void run_cold_cache(uint64_t *samples)
+{
+    uint8_t *buffer = calloc(EVICT_SIZE, 1);
+    int8_t outputs[OUTPUT_SIZE];
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return;
+    }
+
+    printf("\ncold vs. warm cache, %d inferences each, %u MB swept before every cold one (ns)\n",
+           COLD_ITERATIONS, EVICT_SIZE >> 20);
+    printf("%-24s %10s %10s %10s %10s %10s\n", "variant", "warm med", "warm p99", "cold med", "cold p99", "cold/warm");
+    for (uint32_t v = 0; v < NUM_VARIANTS; ++v)
+    {
+        const variant_t *variant = &g_variants[v];
+
+        for (uint32_t i = 0; i < WARMUP_ROUNDS; ++i)
+        {
+            variant->forward(g_inputs[i % NUM_SAMPLES], outputs);
+        }
+        for (uint32_t i = 0; i < COLD_ITERATIONS; ++i)
+        {
+            uint64_t start = now_ns();
+            variant->forward(g_inputs[i % NUM_SAMPLES], outputs);
+            samples[i] = now_ns() - start;
+        }
+        stats_t warm = compute_stats(samples, COLD_ITERATIONS);
+
+        for (uint32_t i = 0; i < COLD_ITERATIONS; ++i)
+        {
+            evict_caches(buffer);
+            uint64_t start = now_ns();
+            variant->forward(g_inputs[i % NUM_SAMPLES], outputs);
+            samples[i] = now_ns() - start;
+        }
+        stats_t cold = compute_stats(samples, COLD_ITERATIONS);
+
+        printf("%-24s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %9.1fx\n",
+               variant->name,
+               warm.median,
+               warm.p99,
+               cold.median,
+               cold.p99,
+               (double)cold.median / (double)warm.median);
+    }
+
+    free(buffer);
+}
+
+#if !CONFIG_MLP_PLAN_EXECUTOR
+// -----------------------------------------------------------------------------
+// streamed weights by tile size vs. the mapped container (not in the builds
+// whose hidden layout mlp_model_load rejects); pread from the page cache here,
+// so this is the tiling and hand-off overhead rather than the flash read time
+// a device sees
+static void run_stream(uint64_t *samples)
+{
+    static const uint32_t tile_sizes[] = {INPUT_SIZE, 4096, 8192, 16384, 32768, HIDDEN_WEIGHT_SIZE};
+    char path[] = "/tmp/mlp_streamXXXXXX";
+    mlp_stream_t stream;
+    int8_t outputs[OUTPUT_SIZE];
+
+    stats_t stats;
+
+    if (write_container_file(path) != 0)
+    {
+        fprintf(stderr, "Cannot write %s\n", path);
+        unlink(path);
+        return;
+    }
+
+    printf("\nweight streaming, %d inferences each (ns)\n", COLD_ITERATIONS);
+    printf("%-24s %10s %10s %10s %10s\n", "weights", "RAM (B)", "min", "median", "p99");
+
+#if !MLP_WEIGHTS_DERIVED
+    mlp_model_t model;
+    mlp_model_mapping_t mapping;
+    if (mlp_model_map(path, &model, &mapping) == 0)
+    {
+        for (uint32_t i = 0; i < COLD_ITERATIONS; ++i)
+        {
+            uint64_t start = now_ns();
+            mlp_model_forward(&model, g_inputs[i % NUM_SAMPLES], outputs);
+            samples[i] = now_ns() - start;
+        }
+        stats = compute_stats(samples, COLD_ITERATIONS);
+        printf("%-24s %10s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n", "mapped", "-", stats.min, stats.median, stats.p99);
+        mlp_model_unmap(&mapping);
+    }
+#endif
+
+    for (uint32_t t = 0; t < sizeof(tile_sizes) / sizeof(tile_sizes[0]); ++t)
+    {
+        if (mlp_stream_open(&stream, path, tile_sizes[t]) != 0)
+        {
+            fprintf(stderr, "mlp_stream_open: can't open %s\n", path);
+            break;
+        }
+        for (uint32_t i = 0; i < WARMUP_ROUNDS; ++i)
+        {
+            mlp_stream_forward(&stream, g_inputs[i % NUM_SAMPLES], outputs);
+        }
+        for (uint32_t i = 0; i < COLD_ITERATIONS; ++i)
+        {
+            uint64_t start = now_ns();
+            mlp_stream_forward(&stream, g_inputs[i % NUM_SAMPLES], outputs);
+            samples[i] = now_ns() - start;
+        }
+        stats = compute_stats(samples, COLD_ITERATIONS);
+
+        char name[32];
+        snprintf(name, sizeof(name), "streamed, %" PRIu32 " B tiles", tile_sizes[t]);
+        printf("%-24s %10" PRIu32 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+               name, 2 * stream.tile_size + stream.resident_size, stats.min, stats.median, stats.p99);
+        mlp_stream_close(&stream);
+    }
+
+    unlink(path);
+}
+#endif
+
+#if CONFIG_MLP_SCHEDULER
+// -----------------------------------------------------------------------------
+// scheduler requests complete on the workers; the bench waits on a semaphore
+static sem_t g_requests_done;
+static mlp_request_t g_requests[SCHEDULER_BURST];
+static int8_t g_request_outputs[SCHEDULER_BURST][OUTPUT_SIZE];
+
+// -----------------------------------------------------------------------------
+static void request_done(mlp_request_t *request)
+{
+    (void)request;
+    sem_post(&g_requests_done);
+}
+
+// -----------------------------------------------------------------------------
+// submit count (<= SCHEDULER_BURST) requests over the samples at once, then
+// wait for all of them
+static void run_burst(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        memset(&g_requests[i], 0, sizeof(g_requests[i]));
+        g_requests[i].inputs = g_inputs[i % NUM_SAMPLES];
+        g_requests[i].outputs = g_request_outputs[i];
+        g_requests[i].done = request_done;
+        mlp_scheduler_submit(&g_requests[i]);
+    }
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        while (sem_wait(&g_requests_done) != 0)
+        {
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+static int check_scheduler(void)
+{
+    int failures = 0;
+    mlp_model_t model;
+
+    if (mlp_model_init(&model, g_params, PARAMS_SIZE - 1) == 0)
+    {
+        fprintf(stderr, "mlp_model_init: accepted a truncated blob\n");
+        ++failures;
+    }
+    if (mlp_model_init(&model, g_params, PARAMS_SIZE) != 0)
+    {
+        fprintf(stderr, "mlp_model_init: rejected g_params\n");
+        return failures + 1;
+    }
+    sem_init(&g_requests_done, 0, 0);
+
+    for (uint32_t workers = 1; workers <= MLP_SCHEDULER_MAX_WORKERS; ++workers)
+    {
+        if (mlp_scheduler_start(&model, workers) != 0)
+        {
+            fprintf(stderr, "mlp_scheduler_start(%" PRIu32 ") failed\n", workers);
+            ++failures;
+            continue;
+        }
+        run_burst(SCHEDULER_BURST);
+
+        mlp_scheduler_stats_t stats;
+        mlp_scheduler_stats(&stats);
+        mlp_scheduler_stop();
+
+        for (uint32_t i = 0; i < SCHEDULER_BURST; ++i)
+        {
+            int8_t expected[OUTPUT_SIZE];
+            expected_forward(g_inputs[i % NUM_SAMPLES], expected);
+            failures += check_equal("mlp_scheduler", i, expected, g_request_outputs[i], OUTPUT_SIZE);
+            if (g_requests[i].worker >= workers || g_requests[i].start_us < g_requests[i].submit_us ||
+                g_requests[i].end_us < g_requests[i].start_us)
+            {
+                fprintf(stderr, "mlp_scheduler: request %" PRIu32 " has bad bookkeeping\n", i);
+                ++failures;
+            }
+        }
+
+        uint32_t completed = 0;
+        for (uint32_t w = 0; w < workers; ++w)
+        {
+            completed += stats.worker_completed[w];
+        }
+        if (stats.submitted != SCHEDULER_BURST || stats.completed != SCHEDULER_BURST || completed != SCHEDULER_BURST ||
+            stats.queued != 0 || stats.workers != workers)
+        {
+            fprintf(stderr, "mlp_scheduler (%" PRIu32 " workers): submitted %" PRIu32 ", completed %" PRIu32 ", queued %" PRIu32 "\n",
+                    workers, stats.submitted, stats.completed, stats.queued);
+            ++failures;
+        }
+    }
+
+    sem_destroy(&g_requests_done);
+    return failures;
+}
+
+// -----------------------------------------------------------------------------
+// bursts of SCHEDULER_BURST requests per worker count: throughput and the
+// submit -> start (queueing) latency of every request
+static void run_scheduler_load(uint32_t rounds, uint64_t *samples)
+{
+    mlp_model_t model;
+    mlp_model_init(&model, g_params, PARAMS_SIZE);
+    sem_init(&g_requests_done, 0, 0);
+
+    // capacity >= SCHEDULER_BURST, see main
+    uint32_t bursts = rounds * NUM_SAMPLES / SCHEDULER_BURST;
+    bursts = (bursts == 0) ? 1 : bursts;
+    printf("\nscheduler, %" PRIu32 " bursts of %d requests (queueing latency in us)\n", bursts, SCHEDULER_BURST);
+    printf("%-8s %12s %8s %8s %8s %8s\n", "workers", "inferences/s", "median", "p99", "max", "stolen");
+
+    for (uint32_t workers = 1; workers <= MLP_SCHEDULER_MAX_WORKERS; ++workers)
+    {
+        if (mlp_scheduler_start(&model, workers) != 0)
+        {
+            continue;
+        }
+        run_burst(SCHEDULER_BURST);
+
+        uint32_t count = 0;
+        uint64_t start = now_ns();
+        for (uint32_t b = 0; b < bursts; ++b)
+        {
+            run_burst(SCHEDULER_BURST);
+            for (uint32_t i = 0; i < SCHEDULER_BURST; ++i)
+            {
+                samples[count++] = g_requests[i].start_us - g_requests[i].submit_us;
+            }
+        }
+        uint64_t end = now_ns();
+
+        mlp_scheduler_stats_t stats;
+        mlp_scheduler_stats(&stats);
+        mlp_scheduler_stop();
+
+        stats_t latency = compute_stats(samples, count);
+        printf("%-8" PRIu32 " %12.0f %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu32 "\n",
+               workers,
+               (double)count * 1e9 / (double)(end - start),
+               latency.median,
+               latency.p99,
+               samples[count - 1],
+               stats.stolen);
+    }
+
+    sem_destroy(&g_requests_done);
+}
+#endif
+
+#if CONFIG_MLP_PROFILE
+// -----------------------------------------------------------------------------
+// profiler dump, in memory
+typedef struct
+{
+    uint8_t data[sizeof(mlp_profile_header_t) + CONFIG_MLP_PROFILE_RECORDS * sizeof(mlp_profile_record_t)];
+    uint32_t size;
+} profile_buffer_t;
+
+static void profile_buffer_write(const void *data, uint32_t size, void *arg)
+{
+    profile_buffer_t *buffer = (profile_buffer_t *)arg;
+    memcpy(&buffer->data[buffer->size], data, size);
+    buffer->size += size;
+}
+
+static void profile_file_write(const void *data, uint32_t size, void *arg)
+{
+    fwrite(data, 1, size, (FILE *)arg);
+}
+
+// -----------------------------------------------------------------------------
+// dump and check the header; returns the records, NULL on a bad header
+static const mlp_profile_record_t *profile_dump_checked(profile_buffer_t *buffer, uint32_t *count)
+{
+    const mlp_profile_header_t *header = (const mlp_profile_header_t *)buffer->data;
+
+    buffer->size = 0;
+    *count = mlp_profile_dump(profile_buffer_write, buffer);
+    if (header->magic != MLP_PROFILE_MAGIC || header->version != MLP_PROFILE_VERSION ||
+        header->record_size != sizeof(mlp_profile_record_t) || header->clock_hz == 0 ||
+        header->flags != MLP_PROFILE_SHARED_CLOCK || header->count != *count ||
+        buffer->size != sizeof(mlp_profile_header_t) + *count * sizeof(mlp_profile_record_t))
+    {
+        fprintf(stderr, "mlp_profile_dump: bad header\n");
+        return NULL;
+    }
+    return (const mlp_profile_record_t *)(header + 1);
+}
+
+// -----------------------------------------------------------------------------
+// a forward pass records its stages inside FORWARD, which ends (is appended)
+// last; a ring that wrapped keeps the newest CONFIG_MLP_PROFILE_RECORDS
+// records, oldest first, and counts the others as dropped
+static int check_profile(void)
+{
+    static profile_buffer_t buffer;
+    const mlp_profile_header_t *header = (const mlp_profile_header_t *)buffer.data;
+    const mlp_profile_record_t *records;
+    int8_t outputs[OUTPUT_SIZE];
+    int failures = 0;
+    uint32_t count;
+
+    mlp_profile_reset();
+    forward_pass(g_inputs[0], outputs);
+    records = profile_dump_checked(&buffer, &count);
+    if (records == NULL)
+    {
+        return 1;
+    }
+    if (count < 2 || header->dropped != 0 || records[count - 1].scope != MLP_SCOPE_FORWARD)
+    {
+        fprintf(stderr, "mlp_profile: a forward pass recorded %" PRIu32 " records, not ending with FORWARD\n", count);
+        return 1;
+    }
+
+    const mlp_profile_record_t *forward = &records[count - 1];
+    uint32_t scopes = 0;
+    for (uint32_t i = 0; i + 1 < count; ++i)
+    {
+        const mlp_profile_record_t *record = &records[i];
+        if (record->scope == MLP_SCOPE_FORWARD || record->scope >= MLP_SCOPE_COUNT || record->start < forward->start ||
+            record->start + record->duration > forward->start + forward->duration)
+        {
+            fprintf(stderr, "mlp_profile: record %" PRIu32 " (scope %u) outside the forward pass\n", i, record->scope);
+            ++failures;
+        }
+        scopes |= 1u << record->scope;
+    }
+    // the fixed pipeline and the plan both run a first dense layer, a second
+    // one and the softmax
+    uint32_t stages = (1u << MLP_SCOPE_DENSE1) | (1u << MLP_SCOPE_DENSE2) | (1u << MLP_SCOPE_SOFTMAX);
+    if ((scopes & stages) != stages)
+    {
+        fprintf(stderr, "mlp_profile: a forward pass recorded scopes 0x%" PRIx32 "\n", scopes);
+        ++failures;
+    }
+
+    // wrap: same input, so every pass appends the same number of records
+    uint32_t per_pass = count;
+    uint32_t passes = CONFIG_MLP_PROFILE_RECORDS;
+    mlp_profile_reset();
+    for (uint32_t p = 0; p < passes; ++p)
+    {
+        forward_pass(g_inputs[0], outputs);
+    }
+    records = profile_dump_checked(&buffer, &count);
+    if (records == NULL)
+    {
+        return failures + 1;
+    }
+    if (count != CONFIG_MLP_PROFILE_RECORDS || header->dropped != passes * per_pass - count ||
+        records[count - 1].scope != MLP_SCOPE_FORWARD)
+    {
+        fprintf(stderr, "mlp_profile: wrapped ring dumped %" PRIu32 " records, %" PRIu32 " dropped\n", count, header->dropped);
+        ++failures;
+    }
+    uint8_t context = records[count - 1].context;
+    uint64_t last_end = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (records[i].context != context)
+        {
+            continue;
+        }
+        uint64_t end = records[i].start + records[i].duration;
+        if (end < last_end)
+        {
+            fprintf(stderr, "mlp_profile: wrapped ring out of order at record %" PRIu32 "\n", i);
+            ++failures;
+            break;
+        }
+        last_end = end;
+    }
+
+    mlp_profile_reset();
+    records = profile_dump_checked(&buffer, &count);
+    if (records == NULL || count != 0 || header->dropped != 0)
+    {
+        fprintf(stderr, "mlp_profile_reset: %" PRIu32 " records left\n", count);
+        ++failures;
+    }
+
+    return failures;
+}
+
+// -----------------------------------------------------------------------------
+// rounds forward passes and delta passes over the samples into the ring, then
+// the dump into path (see scripts/profile_decode.py)
+static int write_profile(const char *path, uint32_t rounds)
+{
+    int8_t outputs[OUTPUT_SIZE];
+    mlp_model_t model;
+    mlp_delta_t delta;
+
+    if (mlp_model_init(&model, g_params, PARAMS_SIZE) != 0)
+    {
+        fprintf(stderr, "mlp_model_init: rejected g_params\n");
+        return 1;
+    }
+    mlp_delta_init(&delta, &model);
+
+    mlp_profile_reset();
+    for (uint32_t r = 0; r < rounds; ++r)
+    {
+        for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+        {
+            forward_pass(g_inputs[s], outputs);
+            mlp_delta_forward(&delta, g_inputs[s], outputs);
+        }
+    }
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Can't open %s\n", path);
+        return 1;
+    }
+    uint32_t count = mlp_profile_dump(profile_file_write, file);
+    if (fclose(file) != 0)
+    {
+        fprintf(stderr, "Can't write %s\n", path);
+        return 1;
+    }
+    printf("%" PRIu32 " profile records written to %s\n", count, path);
+    return 0;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    uint32_t rounds = DEFAULT_ROUNDS;
+    int check_only = 0;
+    const char *profile_path = NULL;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--check") == 0)
+        {
+            check_only = 1;
+            continue;
+        }
+        if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+        {
+            profile_path = argv[++i];
+            continue;
+        }
+
+        rounds = (uint32_t)strtoul(argv[i], NULL, 10);
+        if (rounds == 0)
+        {
+            fprintf(stderr, "Usage: %s [--check] [--profile FILE] [rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+#if !CONFIG_MLP_PROFILE
+    if (profile_path != NULL)
+    {
+        fprintf(stderr, "--profile needs a build with MLP_PROFILE=ON\n");
+        return 1;
+    }
+#endif
+
+    for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+    {
+        memcpy(g_inputs[s], g_samples[s], INPUT_SIZE);
+    }
+
+    dense_transpose_weights(
+        (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+        g_hidden_weights_colmajor,
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+    dense_pack_weights(
+        (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+        g_hidden_weights_packed,
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+    dense_pack_weights(
+        (const int8_t *)&g_params[OUTPUT_WEIGHT_OFFSET],
+        g_output_weights_packed,
+        HIDDEN_SIZE,
+        OUTPUT_SIZE);
+    if (dense_quantize_int4(
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[HIDDEN_BIAS_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            (int8_t)g_params[INPUT_ZP_OFFSET],
+            g_hidden_weights_int4,
+            g_hidden_int4_folded_biases,
+            g_hidden_int4_multipliers,
+            g_hidden_int4_shifts,
+            INPUT_SIZE,
+            HIDDEN_SIZE) != 0)
+    {
+        fprintf(stderr, "Hidden layer scales out of range for int4\n");
+        return 1;
+    }
+    unpack_int4(g_hidden_weights_int4, g_hidden_weights_int4_unpacked, INPUT_SIZE, HIDDEN_SIZE);
+    prepare_block_sparse(CHECK_BLOCK_SPARSITY);
+    if (prepare_codebook(&g_codebook16) != 0 || prepare_codebook(&g_codebook32) != 0)
+    {
+        fprintf(stderr, "Codebook clustering failed\n");
+        return 1;
+    }
+
+    if (check_kernels() != 0 || check_random_shapes() != 0 || check_variants() != 0 || check_plan() != 0 ||
+        check_softmax() != 0 || check_topk() != 0 || check_delta() != 0 || check_container() != 0 ||
+        check_placement() != 0 || check_stream() != 0)
+    {
+        return 1;
+    }
+#if CONFIG_MLP_PLAN_EXECUTOR && !CONFIG_MLP_HIDDEN_INT4 && !CONFIG_MLP_HIDDEN_BLOCK_SPARSE && !CONFIG_MLP_HIDDEN_CODEBOOK
+    if (check_hidden_activations() != 0)
+    {
+        return 1;
+    }
+#endif
+#if CONFIG_MLP_SCHEDULER
+    if (check_scheduler() != 0)
+    {
+        return 1;
+    }
+#endif
+#if CONFIG_MLP_PROFILE
+    if (check_profile() != 0)
+    {
+        return 1;
+    }
+    if (profile_path != NULL)
+    {
+        return write_profile(profile_path, rounds);
+    }
+#endif
+
+    if (check_only)
+    {
+        printf("all kernels bit-exact with dense_int8 (SIMD backend: %s)\n", DENSE_SIMD_BACKEND);
+        return 0;
+    }
+
+    uint32_t capacity = rounds * NUM_SAMPLES;
+    if (capacity < SWEEP_ITERATIONS * NUM_HIDDEN_KERNELS)
+    {
+        capacity = SWEEP_ITERATIONS * NUM_HIDDEN_KERNELS;
+    }
+    if (capacity < SCHEDULER_BURST)
+    {
+        capacity = SCHEDULER_BURST;
+    }
+    if (capacity < COLD_ITERATIONS)
+    {
+        capacity = COLD_ITERATIONS;
+    }
+    uint64_t *samples = malloc(capacity * sizeof(uint64_t));
+    if (samples == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    printf("%" PRIu32 " inferences per variant (ns)\n", rounds * NUM_SAMPLES);
+    printf("%-24s %10s %10s %10s\n", "variant", "min", "median", "p99");
+    stats_t variant_stats[NUM_VARIANTS];
+    for (uint32_t v = 0; v < NUM_VARIANTS; ++v)
+    {
+        variant_stats[v] = run_variant(&g_variants[v], rounds, samples);
+    }
+    run_batch(rounds, samples);
+    print_topk_savings(variant_stats);
+#if CONFIG_MLP_SCHEDULER
+    run_scheduler_load(rounds, samples);
+#endif
+
+    run_hidden_kernels(rounds, samples);
+    print_compressed_accuracy();
+    run_block_sparse_sweep(rounds, samples);
+    print_paths();
+    run_density_sweep(samples);
+    run_delta_sweep(samples);
+    run_cold_cache(samples);
+#if !CONFIG_MLP_PLAN_EXECUTOR
+    run_stream(samples);
+#endif
+
+    free(samples);
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include "container_build.h"
+#include "container.h"
+#include "params.h"
+#include "plan.h"
+#include "softmax.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// the params.h regions that become tensors; the activation zero-points go to
+// the header instead
+typedef struct
+{
+    uint16_t id;
+    uint8_t dtype;
+    uint8_t quant;
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t offset;
+} source_tensor_t;
+
+static const source_tensor_t k_sources[] = {
+    {MLP_TENSOR_HIDDEN_WEIGHTS, MLP_DTYPE_INT8, MLP_QUANT_PER_CHANNEL, HIDDEN_SIZE, INPUT_SIZE, HIDDEN_WEIGHT_OFFSET},
+    {MLP_TENSOR_HIDDEN_BIASES, MLP_DTYPE_INT32, MLP_QUANT_PER_CHANNEL, HIDDEN_SIZE, 1, HIDDEN_BIAS_OFFSET},
+    {MLP_TENSOR_HIDDEN_WEIGHT_ZPS, MLP_DTYPE_INT8, MLP_QUANT_NONE, HIDDEN_SIZE, 1, HIDDEN_WEIGHT_ZP_OFFSET},
+    {MLP_TENSOR_HIDDEN_FOLDED_BIASES, MLP_DTYPE_INT32, MLP_QUANT_PER_CHANNEL, HIDDEN_SIZE, 1, HIDDEN_FOLDED_BIAS_OFFSET},
+    {MLP_TENSOR_HIDDEN_MULTIPLIERS, MLP_DTYPE_UINT32, MLP_QUANT_NONE, HIDDEN_SIZE, 1, LAYER1_MULTIPLIER_OFFSET},
+    {MLP_TENSOR_HIDDEN_SHIFTS, MLP_DTYPE_INT32, MLP_QUANT_NONE, HIDDEN_SIZE, 1, LAYER1_SCALE_OFFSET},
+    {MLP_TENSOR_OUTPUT_WEIGHTS, MLP_DTYPE_INT8, MLP_QUANT_PER_CHANNEL, OUTPUT_SIZE, HIDDEN_SIZE, OUTPUT_WEIGHT_OFFSET},
+    {MLP_TENSOR_OUTPUT_BIASES, MLP_DTYPE_INT32, MLP_QUANT_PER_CHANNEL, OUTPUT_SIZE, 1, OUTPUT_BIAS_OFFSET},
+    {MLP_TENSOR_OUTPUT_WEIGHT_ZPS, MLP_DTYPE_INT8, MLP_QUANT_NONE, OUTPUT_SIZE, 1, OUTPUT_WEIGHT_ZP_OFFSET},
+    {MLP_TENSOR_OUTPUT_FOLDED_BIASES, MLP_DTYPE_INT32, MLP_QUANT_PER_CHANNEL, OUTPUT_SIZE, 1, OUTPUT_FOLDED_BIAS_OFFSET},
+    {MLP_TENSOR_OUTPUT_MULTIPLIERS, MLP_DTYPE_UINT32, MLP_QUANT_NONE, OUTPUT_SIZE, 1, LAYER2_MULTIPLIER_OFFSET},
+    {MLP_TENSOR_OUTPUT_SHIFTS, MLP_DTYPE_INT32, MLP_QUANT_NONE, OUTPUT_SIZE, 1, LAYER2_SCALE_OFFSET},
+    {MLP_TENSOR_SOFTMAX_PARAMS, MLP_DTYPE_INT32, MLP_QUANT_NONE, sizeof(softmax_params_t) / sizeof(int32_t), 1, SOFTMAX_PARAMS_OFFSET},
+    {MLP_TENSOR_PLAN, MLP_DTYPE_UINT8, MLP_QUANT_NONE, PLAN_SIZE, 1, PLAN_OFFSET},
+};
+
+#define NUM_SOURCES (sizeof(k_sources) / sizeof(k_sources[0]))
+
+// -----------------------------------------------------------------------------
+static uint32_t source_size(const source_tensor_t *source)
+{
+    uint32_t element_size = (source->dtype == MLP_DTYPE_INT32 || source->dtype == MLP_DTYPE_UINT32) ? 4 : 1;
+    return source->rows * source->cols * element_size;
+}
+
+// -----------------------------------------------------------------------------
+// the container offset of the tensor that starts at params offset, for the
+// plan; MLP_PLAN_NONE stays as is
+static int remap_offset(uint32_t *offset, const mlp_tensor_desc_t *tensors)
+{
+    if (*offset == MLP_PLAN_NONE)
+    {
+        return 0;
+    }
+    for (uint32_t t = 0; t < NUM_SOURCES; ++t)
+    {
+        if (k_sources[t].offset == *offset)
+        {
+            *offset = tensors[t].offset;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// -----------------------------------------------------------------------------
+uint32_t container_build(const uint8_t *params, uint8_t *container, uint32_t capacity)
+{
+    uint32_t data_offset = MLP_CONTAINER_ALIGN_UP(sizeof(mlp_container_header_t) + NUM_SOURCES * sizeof(mlp_tensor_desc_t));
+    uint32_t data_size = 0;
+    for (uint32_t t = 0; t < NUM_SOURCES; ++t)
+    {
+        data_size = MLP_CONTAINER_ALIGN_UP(data_size) + source_size(&k_sources[t]);
+    }
+    if (container == NULL)
+    {
+        return data_offset + data_size;
+    }
+    if (capacity < data_offset + data_size)
+    {
+        return 0;
+    }
+    memset(container, 0, data_offset + data_size);
+
+    // 1) tensors
+    mlp_tensor_desc_t *tensors = (mlp_tensor_desc_t *)&container[sizeof(mlp_container_header_t)];
+    uint8_t *data = &container[data_offset];
+    uint32_t offset = 0;
+    for (uint32_t t = 0; t < NUM_SOURCES; ++t)
+    {
+        const source_tensor_t *source = &k_sources[t];
+        mlp_tensor_desc_t *tensor = &tensors[t];
+
+        offset = MLP_CONTAINER_ALIGN_UP(offset);
+        tensor->id = source->id;
+        tensor->dtype = source->dtype;
+        tensor->rank = (source->cols == 1) ? 1 : 2;
+        tensor->shape[0] = source->rows;
+        tensor->shape[1] = source->cols;
+        tensor->offset = offset;
+        tensor->size = source_size(source);
+        tensor->quant = source->quant;
+        tensor->quant_axis = 0;
+        memcpy(&data[offset], &params[source->offset], tensor->size);
+        offset += tensor->size;
+    }
+
+    // 2) plan offsets, from params.h to the data section (the plan is the last
+    // tensor)
+    const mlp_tensor_desc_t *plan_tensor = &tensors[NUM_SOURCES - 1];
+    mlp_plan_t *plan = (mlp_plan_t *)&data[plan_tensor->offset];
+    mlp_plan_layer_t *layers = (mlp_plan_layer_t *)&plan[1];
+    if (sizeof(mlp_plan_t) + plan->layer_count * sizeof(mlp_plan_layer_t) > plan_tensor->size)
+    {
+        return 0;
+    }
+    for (uint32_t l = 0; l < plan->layer_count; ++l)
+    {
+        mlp_plan_layer_t *layer = &layers[l];
+        if (layer->type == MLP_LAYER_SOFTMAX)
+        {
+            if (remap_offset(&layer->multiplier_offset, tensors) != 0)
+            {
+                return 0;
+            }
+            continue;
+        }
+        if (remap_offset(&layer->weight_offset, tensors) != 0 ||
+            remap_offset(&layer->weight_zp_offset, tensors) != 0 ||
+            remap_offset(&layer->folded_bias_offset, tensors) != 0 ||
+            remap_offset(&layer->multiplier_offset, tensors) != 0 ||
+            remap_offset(&layer->shift_offset, tensors) != 0 ||
+            remap_offset(&layer->activation_offset, tensors) != 0)
+        {
+            return 0;
+        }
+    }
+
+    // 3) header, checksum last
+    mlp_container_header_t *header = (mlp_container_header_t *)container;
+    header->magic = MLP_CONTAINER_MAGIC;
+    header->version = MLP_CONTAINER_VERSION;
+    header->tensor_count = NUM_SOURCES;
+    header->header_size = sizeof(mlp_container_header_t) + NUM_SOURCES * sizeof(mlp_tensor_desc_t);
+    header->data_offset = data_offset;
+    header->data_size = data_size;
+    header->input_size = INPUT_SIZE;
+    header->hidden_size = HIDDEN_SIZE;
+    header->output_size = OUTPUT_SIZE;
+    header->input_zp = (int8_t)params[INPUT_ZP_OFFSET];
+    header->hidden_zp = (int8_t)params[HIDDEN_ZP_OFFSET];
+    header->output_zp = (int8_t)params[OUTPUT_ZP_OFFSET];
+    header->data_crc32 = mlp_container_crc32(0, data, data_size);
+
+    return data_offset + data_size;
+}
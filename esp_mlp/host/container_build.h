@@ -0,0 +1,15 @@
+#ifndef CONTAINER_BUILD_H_
+#define CONTAINER_BUILD_H_
+
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// convert a params blob laid out as g_params (see params.h) into a model
+// container (see container.h): every tensor moved to a MLP_CONTAINER_ALIGN
+// boundary of the data section and the plan offsets rewritten to match;
+// container == NULL returns the size it needs; returns the container size,
+// or 0 if capacity is too small or the plan references something that isn't
+// a tensor
+uint32_t container_build(const uint8_t *params, uint8_t *container, uint32_t capacity);
+
+#endif
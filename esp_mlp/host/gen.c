@@ -0,0 +1,614 @@
+#include "container_build.h"
+#include "dense.h"
+#include "params.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// offline generator for params variants derived from g_params
+//   mlp_gen folded <component-dir>
+//   mlp_gen colmajor <component-dir>
+//   mlp_gen packed <component-dir>
+//   mlp_gen int4 <component-dir>
+//   mlp_gen blocksparse <component-dir> <sparsity-%>
+//   mlp_gen blocksparse <component-dir> --mask <file>
+//   mlp_gen codebook <component-dir> {16|32}
+//   mlp_gen container <output-file>
+
+#define GENERATED_NOTICE "// generated by mlp_gen from g_params; do not edit\n"
+
+// -----------------------------------------------------------------------------
+static FILE *open_output(const char *dir, const char *name)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Cannot open %s for writing\n", path);
+    }
+    return file;
+}
+
+// -----------------------------------------------------------------------------
+static void emit_int32_array(FILE *file, const char *name, const int32_t *data, uint32_t size)
+{
+    fprintf(file, "const int32_t %s[%" PRIu32 "] = {", name, size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        fprintf(file, "%s%" PRId32 ",", (i % 8) == 0 ? "\n    " : " ", data[i]);
+    }
+    fprintf(file, "\n};\n");
+}
+
+// -----------------------------------------------------------------------------
+static void emit_uint32_array(FILE *file, const char *name, const uint32_t *data, uint32_t size)
+{
+    fprintf(file, "const uint32_t %s[%" PRIu32 "] = {", name, size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        fprintf(file, "%s%" PRIu32 ",", (i % 8) == 0 ? "\n    " : " ", data[i]);
+    }
+    fprintf(file, "\n};\n");
+}
+
+// -----------------------------------------------------------------------------
+static void emit_uint16_array(FILE *file, const char *name, const uint16_t *data, uint32_t size)
+{
+    fprintf(file, "const uint16_t %s[%" PRIu32 "] = {", name, size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        fprintf(file, "%s%" PRIu16 ",", (i % 12) == 0 ? "\n    " : " ", data[i]);
+    }
+    fprintf(file, "\n};\n");
+}
+
+// -----------------------------------------------------------------------------
+static void emit_int16_array(FILE *file, const char *name, const int16_t *data, uint32_t size)
+{
+    fprintf(file, "const int16_t %s[%" PRIu32 "] = {", name, size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        fprintf(file, "%s%" PRId16 ",", (i % 12) == 0 ? "\n    " : " ", data[i]);
+    }
+    fprintf(file, "\n};\n");
+}
+
+// -----------------------------------------------------------------------------
+static void emit_uint8_array(FILE *file, const char *name, const uint8_t *data, uint32_t size)
+{
+    fprintf(file, "const uint8_t %s[%" PRIu32 "] __attribute__((aligned(16))) = {", name, size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        fprintf(file, "%s0x%02x,", (i % 12) == 0 ? "\n    " : " ", data[i]);
+    }
+    fprintf(file, "\n};\n");
+}
+
+// -----------------------------------------------------------------------------
+static void emit_int8_array(FILE *file, const char *name, const int8_t *data, uint32_t size)
+{
+    fprintf(file, "const int8_t %s[%" PRIu32 "] __attribute__((aligned(16))) = {", name, size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        fprintf(file, "%s0x%02x,", (i % 12) == 0 ? "\n    " : " ", (uint8_t)data[i]);
+    }
+    fprintf(file, "\n};\n");
+}
+
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    const char *comment;
+    const char *name;
+    const char *size_macro;
+    const int8_t *data;
+    uint32_t size;
+} int8_tensor_t;
+
+// -----------------------------------------------------------------------------
+// write <dir>/include/<basename>.h + <dir>/<basename>.c holding int8 tensors
+static int write_int8_tensors(const char *dir, const char *basename, const int8_tensor_t *tensors, uint32_t count)
+{
+    char name[128];
+    char guard[128];
+    uint32_t i;
+
+    for (i = 0; basename[i] != 0 && i + 1 < sizeof(guard); ++i)
+    {
+        guard[i] = (basename[i] >= 'a' && basename[i] <= 'z') ? (char)(basename[i] - 'a' + 'A') : basename[i];
+    }
+    guard[i] = 0;
+
+    snprintf(name, sizeof(name), "include/%s.h", basename);
+    FILE *header = open_output(dir, name);
+    if (header == NULL)
+    {
+        return 1;
+    }
+    fprintf(header, "#ifndef %s_H_\n#define %s_H_\n\n", guard, guard);
+    fprintf(header, GENERATED_NOTICE "\n");
+    fprintf(header, "#include \"dense.h\"\n");
+    fprintf(header, "#include \"params.h\"\n\n");
+    for (uint32_t t = 0; t < count; ++t)
+    {
+        fprintf(header, "// -----------------------------------------------------------------------------\n");
+        fprintf(header, "// %s\n\n", tensors[t].comment);
+        fprintf(header, "extern const int8_t %s[%s];\n\n", tensors[t].name, tensors[t].size_macro);
+    }
+    fprintf(header, "#endif\n");
+    fclose(header);
+
+    snprintf(name, sizeof(name), "%s.c", basename);
+    FILE *source = open_output(dir, name);
+    if (source == NULL)
+    {
+        return 1;
+    }
+    fprintf(source, GENERATED_NOTICE "\n");
+    fprintf(source, "#include \"%s.h\"\n", basename);
+    for (uint32_t t = 0; t < count; ++t)
+    {
+        fprintf(source, "\n");
+        emit_int8_array(source, tensors[t].name, tensors[t].data, tensors[t].size);
+    }
+    fclose(source);
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+static int all_zero(const int8_t *data, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        if (data[i] != 0)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// -----------------------------------------------------------------------------
+// output layer weight bounds for dense_int8_topk (the folded biases live in
+// g_params itself)
+static int gen_folded(const char *dir)
+{
+    int32_t output_weight_sums[DENSE_TOPK_BOUNDS_SIZE(HIDDEN_SIZE, OUTPUT_SIZE)];
+    int32_t output_weight_norms[DENSE_TOPK_BOUNDS_SIZE(HIDDEN_SIZE, OUTPUT_SIZE)];
+
+    dense_topk_weight_bounds(
+        (const int8_t *)&g_params[OUTPUT_WEIGHT_OFFSET],
+        output_weight_sums,
+        output_weight_norms,
+        HIDDEN_SIZE,
+        OUTPUT_SIZE);
+
+    FILE *header = open_output(dir, "include/params_folded.h");
+    if (header == NULL)
+    {
+        return 1;
+    }
+    fprintf(header, "#ifndef PARAMS_FOLDED_H_\n#define PARAMS_FOLDED_H_\n\n");
+    fprintf(header, GENERATED_NOTICE "\n");
+    fprintf(header, "#include \"params.h\"\n\n");
+    fprintf(header, "// -----------------------------------------------------------------------------\n");
+    fprintf(header, "// output layer weight sums/norms for dense_int8_topk\n\n");
+    fprintf(header, "#define OUTPUT_TOPK_BOUNDS_SIZE     %d\n\n", (int)DENSE_TOPK_BOUNDS_SIZE(HIDDEN_SIZE, OUTPUT_SIZE));
+    fprintf(header, "extern const int32_t g_output_weight_sums[OUTPUT_TOPK_BOUNDS_SIZE];\n");
+    fprintf(header, "extern const int32_t g_output_weight_norms[OUTPUT_TOPK_BOUNDS_SIZE];\n\n");
+    fprintf(header, "#endif\n");
+    fclose(header);
+
+    FILE *source = open_output(dir, "params_folded.c");
+    if (source == NULL)
+    {
+        return 1;
+    }
+    fprintf(source, GENERATED_NOTICE "\n");
+    fprintf(source, "#include \"params_folded.h\"\n\n");
+    emit_int32_array(source, "g_output_weight_sums", output_weight_sums, DENSE_TOPK_BOUNDS_SIZE(HIDDEN_SIZE, OUTPUT_SIZE));
+    fprintf(source, "\n");
+    emit_int32_array(source, "g_output_weight_norms", output_weight_norms, DENSE_TOPK_BOUNDS_SIZE(HIDDEN_SIZE, OUTPUT_SIZE));
+    fclose(source);
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// hidden layer weights transposed to [INPUT_SIZE][HIDDEN_SIZE]
+static int gen_colmajor(const char *dir)
+{
+    static int8_t hidden_weights_colmajor[HIDDEN_WEIGHT_SIZE];
+
+    dense_transpose_weights(
+        (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+        hidden_weights_colmajor,
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+
+    const int8_tensor_t tensors[] = {
+        {
+            "hidden layer weights, column-major [INPUT_SIZE][HIDDEN_SIZE]",
+            "g_hidden_weights_colmajor",
+            "HIDDEN_WEIGHT_SIZE",
+            hidden_weights_colmajor,
+            HIDDEN_WEIGHT_SIZE,
+        },
+    };
+
+    return write_int8_tensors(dir, "params_colmajor", tensors, 1);
+}
+
+// -----------------------------------------------------------------------------
+// weights of both layers repacked in DENSE_PACK_BLOCK-interleaved blocks
+static int gen_packed(const char *dir)
+{
+    static int8_t hidden_weights_packed[DENSE_PACKED_SIZE(INPUT_SIZE, HIDDEN_SIZE)];
+    static int8_t output_weights_packed[DENSE_PACKED_SIZE(HIDDEN_SIZE, OUTPUT_SIZE)];
+
+    dense_pack_weights(
+        (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+        hidden_weights_packed,
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+
+    dense_pack_weights(
+        (const int8_t *)&g_params[OUTPUT_WEIGHT_OFFSET],
+        output_weights_packed,
+        HIDDEN_SIZE,
+        OUTPUT_SIZE);
+
+    const int8_tensor_t tensors[] = {
+        {
+            "hidden layer weights, packed (see dense_pack_weights)",
+            "g_hidden_weights_packed",
+            "DENSE_PACKED_SIZE(INPUT_SIZE, HIDDEN_SIZE)",
+            hidden_weights_packed,
+            sizeof(hidden_weights_packed),
+        },
+        {
+            "output layer weights, packed (see dense_pack_weights)",
+            "g_output_weights_packed",
+            "DENSE_PACKED_SIZE(HIDDEN_SIZE, OUTPUT_SIZE)",
+            output_weights_packed,
+            sizeof(output_weights_packed),
+        },
+    };
+
+    return write_int8_tensors(dir, "params_packed", tensors, 2);
+}
+
+// -----------------------------------------------------------------------------
+// hidden layer re-quantized to per-channel int4 (see dense_quantize_int4)
+static int gen_int4(const char *dir)
+{
+    static uint8_t hidden_weights_int4[DENSE_INT4_SIZE(INPUT_SIZE, HIDDEN_SIZE)];
+    int32_t hidden_int4_folded_biases[HIDDEN_SIZE];
+    uint32_t hidden_int4_multipliers[HIDDEN_SIZE];
+    int32_t hidden_int4_shifts[HIDDEN_SIZE];
+
+    if (dense_quantize_int4(
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[HIDDEN_BIAS_OFFSET],
+            (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+            (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+            (int8_t)g_params[INPUT_ZP_OFFSET],
+            hidden_weights_int4,
+            hidden_int4_folded_biases,
+            hidden_int4_multipliers,
+            hidden_int4_shifts,
+            INPUT_SIZE,
+            HIDDEN_SIZE) != 0)
+    {
+        fprintf(stderr, "Hidden layer scales out of range for int4\n");
+        return 1;
+    }
+
+    FILE *header = open_output(dir, "include/params_int4.h");
+    if (header == NULL)
+    {
+        return 1;
+    }
+    fprintf(header, "#ifndef PARAMS_INT4_H_\n#define PARAMS_INT4_H_\n\n");
+    fprintf(header, GENERATED_NOTICE "\n");
+    fprintf(header, "#include \"dense.h\"\n");
+    fprintf(header, "#include \"params.h\"\n\n");
+    fprintf(header, "// -----------------------------------------------------------------------------\n");
+    fprintf(header, "// hidden layer weights, per-channel symmetric int4 (see DENSE_INT4_ROW_SIZE)\n\n");
+    fprintf(header, "extern const uint8_t g_hidden_weights_int4[DENSE_INT4_SIZE(INPUT_SIZE, HIDDEN_SIZE)];\n\n");
+    fprintf(header, "// -----------------------------------------------------------------------------\n");
+    fprintf(header, "// hidden layer biases (input zero-point folded in) and requantization at the\n");
+    fprintf(header, "// int4 weight scales\n\n");
+    fprintf(header, "extern const int32_t g_hidden_int4_folded_biases[HIDDEN_SIZE];\n");
+    fprintf(header, "extern const uint32_t g_hidden_int4_multipliers[HIDDEN_SIZE];\n");
+    fprintf(header, "extern const int32_t g_hidden_int4_shifts[HIDDEN_SIZE];\n\n");
+    fprintf(header, "#endif\n");
+    fclose(header);
+
+    FILE *source = open_output(dir, "params_int4.c");
+    if (source == NULL)
+    {
+        return 1;
+    }
+    fprintf(source, GENERATED_NOTICE "\n");
+    fprintf(source, "#include \"params_int4.h\"\n\n");
+    emit_uint8_array(source, "g_hidden_weights_int4", hidden_weights_int4, sizeof(hidden_weights_int4));
+    fprintf(source, "\n");
+    emit_int32_array(source, "g_hidden_int4_folded_biases", hidden_int4_folded_biases, HIDDEN_SIZE);
+    fprintf(source, "\n");
+    emit_uint32_array(source, "g_hidden_int4_multipliers", hidden_int4_multipliers, HIDDEN_SIZE);
+    fprintf(source, "\n");
+    emit_int32_array(source, "g_hidden_int4_shifts", hidden_int4_shifts, HIDDEN_SIZE);
+    fclose(source);
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// pruning mask from a file: one byte per DENSE_SPARSE_BLOCK block of the
+// hidden layer, [HIDDEN_SIZE][DENSE_SPARSE_ROW_BLOCKS(INPUT_SIZE)], 0 = pruned
+static int read_mask(const char *path, uint8_t *mask, uint32_t size)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 1;
+    }
+    size_t read = fread(mask, 1, size, file);
+    int extra = fgetc(file) != EOF;
+    fclose(file);
+    if (read != size || extra)
+    {
+        fprintf(stderr, "%s: expected %" PRIu32 " mask bytes\n", path, size);
+        return 1;
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// hidden layer pruned to 1xDENSE_SPARSE_BLOCK blocks, either to a target
+// sparsity (magnitude pruning) or by an external mask
+static int gen_block_sparse(const char *dir, const char *sparsity, const char *mask_path)
+{
+    static uint8_t mask[DENSE_SPARSE_MAX_BLOCKS(INPUT_SIZE, HIDDEN_SIZE)];
+    static uint16_t block_cols[DENSE_SPARSE_MAX_BLOCKS(INPUT_SIZE, HIDDEN_SIZE)];
+    static int8_t values[DENSE_SPARSE_MAX_BLOCKS(INPUT_SIZE, HIDDEN_SIZE) * DENSE_SPARSE_BLOCK];
+    uint32_t row_ptr[HIDDEN_SIZE + 1];
+    int32_t folded_biases[HIDDEN_SIZE];
+
+    const int8_t *weights = (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET];
+
+    if (!all_zero((const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET], HIDDEN_SIZE))
+    {
+        fprintf(stderr, "Block-sparse weights need symmetric (zero zero-point) weights\n");
+        return 1;
+    }
+
+    if (mask_path != NULL)
+    {
+        if (read_mask(mask_path, mask, sizeof(mask)) != 0)
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        char *end;
+        unsigned long pct = strtoul(sparsity, &end, 10);
+        if (*end != 0 || pct > 100 || dense_prune_blocks(weights, mask, (uint32_t)pct, INPUT_SIZE, HIDDEN_SIZE) != 0)
+        {
+            fprintf(stderr, "Invalid sparsity %s\n", sparsity);
+            return 1;
+        }
+    }
+
+    uint32_t count = dense_encode_block_sparse(
+        weights,
+        (const int32_t *)&g_params[HIDDEN_BIAS_OFFSET],
+        (int8_t)g_params[INPUT_ZP_OFFSET],
+        mask,
+        row_ptr,
+        block_cols,
+        values,
+        folded_biases,
+        INPUT_SIZE,
+        HIDDEN_SIZE);
+    // keep the arrays non-empty so the generated source stays valid C
+    uint32_t stored = count > 0 ? count : 1;
+
+    FILE *header = open_output(dir, "include/params_block_sparse.h");
+    if (header == NULL)
+    {
+        return 1;
+    }
+    fprintf(header, "#ifndef PARAMS_BLOCK_SPARSE_H_\n#define PARAMS_BLOCK_SPARSE_H_\n\n");
+    fprintf(header, GENERATED_NOTICE "\n");
+    fprintf(header, "#include \"dense.h\"\n");
+    fprintf(header, "#include \"params.h\"\n\n");
+    fprintf(header, "// -----------------------------------------------------------------------------\n");
+    fprintf(header, "// hidden layer weights, block-sparse (see dense_encode_block_sparse): %" PRIu32 " of\n", count);
+    fprintf(header, "// %u blocks kept\n\n", (unsigned)DENSE_SPARSE_MAX_BLOCKS(INPUT_SIZE, HIDDEN_SIZE));
+    fprintf(header, "#define HIDDEN_BLOCK_SPARSE_BLOCKS  %" PRIu32 "\n\n", count);
+    fprintf(header, "extern const uint32_t g_hidden_block_sparse_row_ptr[HIDDEN_SIZE + 1];\n");
+    fprintf(header, "extern const uint16_t g_hidden_block_sparse_cols[];\n");
+    fprintf(header, "extern const int8_t g_hidden_block_sparse_values[];\n\n");
+    fprintf(header, "// -----------------------------------------------------------------------------\n");
+    fprintf(header, "// hidden layer biases with the input zero-point folded in over the kept weights\n\n");
+    fprintf(header, "extern const int32_t g_hidden_block_sparse_folded_biases[HIDDEN_SIZE];\n\n");
+    fprintf(header, "#endif\n");
+    fclose(header);
+
+    FILE *source = open_output(dir, "params_block_sparse.c");
+    if (source == NULL)
+    {
+        return 1;
+    }
+    fprintf(source, GENERATED_NOTICE "\n");
+    fprintf(source, "#include \"params_block_sparse.h\"\n\n");
+    emit_uint32_array(source, "g_hidden_block_sparse_row_ptr", row_ptr, HIDDEN_SIZE + 1);
+    fprintf(source, "\n");
+    emit_uint16_array(source, "g_hidden_block_sparse_cols", block_cols, stored);
+    fprintf(source, "\n");
+    emit_int8_array(source, "g_hidden_block_sparse_values", values, stored * DENSE_SPARSE_BLOCK);
+    fprintf(source, "\n");
+    emit_int32_array(source, "g_hidden_block_sparse_folded_biases", folded_biases, HIDDEN_SIZE);
+    fclose(source);
+
+    printf("kept %" PRIu32 " of %u blocks\n", count, (unsigned)DENSE_SPARSE_MAX_BLOCKS(INPUT_SIZE, HIDDEN_SIZE));
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// hidden layer clustered to 16 or 32 shared weights per output channel (see
+// dense_cluster_weights)
+static int gen_codebook(const char *dir, const char *count)
+{
+    static uint8_t indices[DENSE_CODEBOOK_SIZE(INPUT_SIZE, HIDDEN_SIZE, DENSE_CODEBOOK_MAX_CENTROIDS)];
+    static int16_t centroids[HIDDEN_SIZE * DENSE_CODEBOOK_MAX_CENTROIDS];
+    int32_t folded_biases[HIDDEN_SIZE];
+
+    uint32_t centroid_count = (uint32_t)strtoul(count, NULL, 10);
+    if (dense_cluster_weights(
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET],
+            (const int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET],
+            (const int32_t *)&g_params[HIDDEN_BIAS_OFFSET],
+            (int8_t)g_params[INPUT_ZP_OFFSET],
+            centroid_count,
+            indices,
+            centroids,
+            folded_biases,
+            INPUT_SIZE,
+            HIDDEN_SIZE) != 0)
+    {
+        fprintf(stderr, "Unsupported centroid count %s (16 or 32)\n", count);
+        return 1;
+    }
+
+    FILE *header = open_output(dir, "include/params_codebook.h");
+    if (header == NULL)
+    {
+        return 1;
+    }
+    fprintf(header, "#ifndef PARAMS_CODEBOOK_H_\n#define PARAMS_CODEBOOK_H_\n\n");
+    fprintf(header, GENERATED_NOTICE "\n");
+    fprintf(header, "#include \"dense.h\"\n");
+    fprintf(header, "#include \"params.h\"\n\n");
+    fprintf(header, "// -----------------------------------------------------------------------------\n");
+    fprintf(header, "// hidden layer weights, clustered per output channel (see dense_cluster_weights)\n\n");
+    fprintf(header, "#define HIDDEN_CODEBOOK_CENTROIDS  %" PRIu32 "\n\n", centroid_count);
+    fprintf(header, "extern const uint8_t g_hidden_codebook_indices[DENSE_CODEBOOK_SIZE(INPUT_SIZE, HIDDEN_SIZE, HIDDEN_CODEBOOK_CENTROIDS)];\n");
+    fprintf(header, "extern const int16_t g_hidden_codebook_centroids[HIDDEN_SIZE * HIDDEN_CODEBOOK_CENTROIDS];\n\n");
+    fprintf(header, "// -----------------------------------------------------------------------------\n");
+    fprintf(header, "// hidden layer biases with the input zero-point folded in over the clustered\n");
+    fprintf(header, "// weights\n\n");
+    fprintf(header, "extern const int32_t g_hidden_codebook_folded_biases[HIDDEN_SIZE];\n\n");
+    fprintf(header, "#endif\n");
+    fclose(header);
+
+    FILE *source = open_output(dir, "params_codebook.c");
+    if (source == NULL)
+    {
+        return 1;
+    }
+    fprintf(source, GENERATED_NOTICE "\n");
+    fprintf(source, "#include \"params_codebook.h\"\n\n");
+    emit_uint8_array(source, "g_hidden_codebook_indices", indices, DENSE_CODEBOOK_SIZE(INPUT_SIZE, HIDDEN_SIZE, centroid_count));
+    fprintf(source, "\n");
+    emit_int16_array(source, "g_hidden_codebook_centroids", centroids, HIDDEN_SIZE * centroid_count);
+    fprintf(source, "\n");
+    emit_int32_array(source, "g_hidden_codebook_folded_biases", folded_biases, HIDDEN_SIZE);
+    fclose(source);
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// g_params as a model container (see container.h), to flash into the model
+// partition or mlp_model_map on the host
+static int gen_container(const char *path)
+{
+    uint32_t size = container_build(g_params, NULL, 0);
+    uint8_t *container = malloc(size);
+    if (container == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    if (container_build(g_params, container, size) != size)
+    {
+        fprintf(stderr, "g_params can't be converted: its plan references a region that isn't a tensor\n");
+        free(container);
+        return 1;
+    }
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Cannot open %s for writing\n", path);
+        free(container);
+        return 1;
+    }
+    int written = fwrite(container, 1, size, file) == size;
+    written = (fclose(file) == 0) && written;
+    free(container);
+    if (!written)
+    {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return 1;
+    }
+
+    printf("%s: %" PRIu32 " bytes\n", path, size);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc == 3 && strcmp(argv[1], "folded") == 0)
+    {
+        return gen_folded(argv[2]);
+    }
+    if (argc == 3 && strcmp(argv[1], "colmajor") == 0)
+    {
+        return gen_colmajor(argv[2]);
+    }
+    if (argc == 3 && strcmp(argv[1], "packed") == 0)
+    {
+        return gen_packed(argv[2]);
+    }
+    if (argc == 3 && strcmp(argv[1], "int4") == 0)
+    {
+        return gen_int4(argv[2]);
+    }
+    if (argc == 4 && strcmp(argv[1], "blocksparse") == 0)
+    {
+        return gen_block_sparse(argv[2], argv[3], NULL);
+    }
+    if (argc == 5 && strcmp(argv[1], "blocksparse") == 0 && strcmp(argv[3], "--mask") == 0)
+    {
+        return gen_block_sparse(argv[2], NULL, argv[4]);
+    }
+    if (argc == 4 && strcmp(argv[1], "codebook") == 0)
+    {
+        return gen_codebook(argv[2], argv[3]);
+    }
+    if (argc == 3 && strcmp(argv[1], "container") == 0)
+    {
+        return gen_container(argv[2]);
+    }
+
+    fprintf(stderr, "Usage: %s {folded|colmajor|packed|int4} <component-dir>\n", argv[0]);
+    fprintf(stderr, "       %s blocksparse <component-dir> {<sparsity-%%>|--mask <file>}\n", argv[0]);
+    fprintf(stderr, "       %s codebook <component-dir> {16|32}\n", argv[0]);
+    fprintf(stderr, "       %s container <output-file>\n", argv[0]);
+    return 1;
+}
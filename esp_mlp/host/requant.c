@@ -0,0 +1,318 @@
+#include "input.h"
+#include "params.h"
+#include "quant.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// -----------------------------------------------------------------------------
+// requantization backends vs. exact64, which is bit-exact with TFLM's
+// MultiplyByQuantizedMultiplier, over every (multiplier, shift) pair in
+// g_params:
+//   - ns per call
+//   - output (int8, after zero-point and saturation) mismatch rate on the
+//     model's own accumulators for the sample inputs and on random
+//     accumulators spanning each channel's int8 output range
+//   - top-1 agreement of the whole model with the exact64 model
+//   mlp_requant [random-per-pair]
+
+#define NUM_SAMPLES         10
+#define DEFAULT_RANDOM      1000
+#define TIMING_VALUES       4096
+#define TIMING_ROUNDS       200
+
+typedef int32_t (*requant_fn)(int32_t val, uint32_t multiplier, int32_t shift);
+
+typedef struct
+{
+    const char *name;
+    requant_fn requant;
+    uint64_t (*time)(const int32_t *values, uint32_t count, uint32_t multiplier, int32_t shift);
+} backend_t;
+
+static const unsigned char *g_samples[NUM_SAMPLES] = {
+    g_zero_input,
+    g_one_input,
+    g_two_input,
+    g_three_input,
+    g_four_input,
+    g_five_input,
+    g_six_input,
+    g_seven_input,
+    g_eight_input,
+    g_nine_input,
+};
+
+// -----------------------------------------------------------------------------
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// -----------------------------------------------------------------------------
+// timed loops with the backend inlined, as in the kernels
+static volatile int32_t g_sink;
+
+#define DEFINE_TIMING_LOOP(backend)                                                                        \
+    static uint64_t time_##backend(const int32_t *values, uint32_t count, uint32_t multiplier, int32_t shift) \
+    {                                                                                                      \
+        int32_t sum = 0;                                                                                   \
+        uint64_t start = now_ns();                                                                         \
+        for (uint32_t r = 0; r < TIMING_ROUNDS; ++r)                                                       \
+        {                                                                                                  \
+            for (uint32_t i = 0; i < count; ++i)                                                           \
+            {                                                                                              \
+                sum += requant_##backend(values[i], multiplier, shift);                                    \
+            }                                                                                              \
+        }                                                                                                  \
+        uint64_t end = now_ns();                                                                           \
+        g_sink = sum;                                                                                      \
+        return end - start;                                                                                \
+    }
+
+DEFINE_TIMING_LOOP(exact64)
+DEFINE_TIMING_LOOP(approx32)
+DEFINE_TIMING_LOOP(pot)
+DEFINE_TIMING_LOOP(float)
+
+static const backend_t g_backends[] = {
+    {"exact64", requant_exact64, time_exact64},
+    {"approx32", requant_approx32, time_approx32},
+    {"pot", requant_pot, time_pot},
+    {"float", requant_float, time_float},
+};
+
+#define NUM_BACKENDS (sizeof(g_backends) / sizeof(g_backends[0]))
+
+// -----------------------------------------------------------------------------
+static uint32_t next_random(uint32_t *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
+
+// -----------------------------------------------------------------------------
+// one layer's int32 accumulators over folded biases
+static void layer_accumulators(const int8_t *inputs, const int8_t *weights, const int32_t *folded_biases, int32_t *accumulators, uint32_t input_size, uint32_t output_size)
+{
+    for (uint32_t oc = 0; oc < output_size; ++oc)
+    {
+        int32_t acc = folded_biases[oc];
+        for (uint32_t ic = 0; ic < input_size; ++ic)
+        {
+            acc += (int32_t)inputs[ic] * (int32_t)weights[oc * input_size + ic];
+        }
+        accumulators[oc] = acc;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// int32 accumulators -> int8 outputs with a given backend
+static void requantize(requant_fn requant, const int32_t *accumulators, int8_t *outputs, int8_t zp, const uint32_t *multipliers, const int32_t *shifts, uint32_t size)
+{
+    for (uint32_t oc = 0; oc < size; ++oc)
+    {
+        outputs[oc] = saturate_to_int8(requant(accumulators[oc], multipliers[oc], shifts[oc]) + (int32_t)zp);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// the model (dense+ReLU, dense) with a given backend; logits only, softmax
+// doesn't change the top-1
+static void model_logits(requant_fn requant, const int8_t *inputs, int8_t *logits, int32_t *hidden_accumulators, int32_t *output_accumulators)
+{
+    int8_t hiddens[HIDDEN_SIZE];
+    int8_t hidden_zp = (int8_t)g_params[HIDDEN_ZP_OFFSET];
+
+    layer_accumulators(inputs, (const int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET], (const int32_t *)&g_params[HIDDEN_FOLDED_BIAS_OFFSET], hidden_accumulators, INPUT_SIZE, HIDDEN_SIZE);
+    requantize(
+        requant,
+        hidden_accumulators,
+        hiddens,
+        hidden_zp,
+        (const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET],
+        (const int32_t *)&g_params[LAYER1_SCALE_OFFSET],
+        HIDDEN_SIZE);
+    for (uint32_t i = 0; i < HIDDEN_SIZE; ++i)
+    {
+        hiddens[i] = relu_int8(hiddens[i], hidden_zp);
+    }
+
+    layer_accumulators(hiddens, (const int8_t *)&g_params[OUTPUT_WEIGHT_OFFSET], (const int32_t *)&g_params[OUTPUT_FOLDED_BIAS_OFFSET], output_accumulators, HIDDEN_SIZE, OUTPUT_SIZE);
+    requantize(
+        requant,
+        output_accumulators,
+        logits,
+        (int8_t)g_params[OUTPUT_ZP_OFFSET],
+        (const uint32_t *)&g_params[LAYER2_MULTIPLIER_OFFSET],
+        (const int32_t *)&g_params[LAYER2_SCALE_OFFSET],
+        OUTPUT_SIZE);
+}
+
+// -----------------------------------------------------------------------------
+static uint32_t argmax_int8(const int8_t *values, uint32_t size)
+{
+    uint32_t best = 0;
+    for (uint32_t i = 1; i < size; ++i)
+    {
+        if (values[i] > values[best])
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t compared;
+    uint64_t mismatches;
+    int32_t max_diff;
+} mismatch_t;
+
+// -----------------------------------------------------------------------------
+static void compare(const backend_t *backend, int32_t acc, uint32_t multiplier, int32_t shift, int8_t zp, mismatch_t *stats)
+{
+    int32_t expected = saturate_to_int8(requant_exact64(acc, multiplier, shift) + (int32_t)zp);
+    int32_t actual = saturate_to_int8(backend->requant(acc, multiplier, shift) + (int32_t)zp);
+    int32_t diff = abs(expected - actual);
+
+    ++stats->compared;
+    stats->mismatches += (diff != 0) ? 1 : 0;
+    stats->max_diff = diff > stats->max_diff ? diff : stats->max_diff;
+}
+
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    uint32_t random_per_pair = DEFAULT_RANDOM;
+    if (argc > 1)
+    {
+        random_per_pair = (uint32_t)strtoul(argv[1], NULL, 10);
+        if (random_per_pair == 0)
+        {
+            fprintf(stderr, "Usage: %s [random-per-pair]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    static int8_t inputs[NUM_SAMPLES][INPUT_SIZE];
+    static int32_t hidden_accumulators[NUM_SAMPLES][HIDDEN_SIZE];
+    static int32_t output_accumulators[NUM_SAMPLES][OUTPUT_SIZE];
+    int8_t expected_logits[NUM_SAMPLES][OUTPUT_SIZE];
+
+    for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+    {
+        memcpy(inputs[s], g_samples[s], INPUT_SIZE);
+        model_logits(requant_exact64, inputs[s], expected_logits[s], hidden_accumulators[s], output_accumulators[s]);
+    }
+
+    // every (multiplier, shift, zero-point) in g_params
+    typedef struct
+    {
+        uint32_t multiplier;
+        int32_t shift;
+        int8_t zp;
+        uint32_t layer;
+        uint32_t channel;
+    } pair_t;
+    pair_t pairs[HIDDEN_SIZE + OUTPUT_SIZE];
+    for (uint32_t oc = 0; oc < HIDDEN_SIZE; ++oc)
+    {
+        pairs[oc].multiplier = ((const uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET])[oc];
+        pairs[oc].shift = ((const int32_t *)&g_params[LAYER1_SCALE_OFFSET])[oc];
+        pairs[oc].zp = (int8_t)g_params[HIDDEN_ZP_OFFSET];
+        pairs[oc].layer = 0;
+        pairs[oc].channel = oc;
+    }
+    for (uint32_t oc = 0; oc < OUTPUT_SIZE; ++oc)
+    {
+        pairs[HIDDEN_SIZE + oc].multiplier = ((const uint32_t *)&g_params[LAYER2_MULTIPLIER_OFFSET])[oc];
+        pairs[HIDDEN_SIZE + oc].shift = ((const int32_t *)&g_params[LAYER2_SCALE_OFFSET])[oc];
+        pairs[HIDDEN_SIZE + oc].zp = (int8_t)g_params[OUTPUT_ZP_OFFSET];
+        pairs[HIDDEN_SIZE + oc].layer = 1;
+        pairs[HIDDEN_SIZE + oc].channel = oc;
+    }
+    uint32_t num_pairs = HIDDEN_SIZE + OUTPUT_SIZE;
+
+    static int32_t timing_values[TIMING_VALUES];
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < TIMING_VALUES; ++i)
+    {
+        timing_values[i] = (int32_t)(next_random(&seed) % 200000) - 100000;
+    }
+
+    printf("%" PRIu32 " (multiplier, shift) pairs, exact64 == TFLM MultiplyByQuantizedMultiplier\n", num_pairs);
+    printf("%-10s %9s %14s %10s %14s %10s %7s %8s\n",
+           "backend", "ns/call", "model mism.", "max |d|", "random mism.", "max |d|", "top-1", "logits");
+
+    for (uint32_t b = 0; b < NUM_BACKENDS; ++b)
+    {
+        const backend_t *backend = &g_backends[b];
+        mismatch_t model = {0};
+        mismatch_t random = {0};
+
+        uint64_t ns = 0;
+        for (uint32_t p = 0; p < num_pairs; ++p)
+        {
+            ns += backend->time(timing_values, TIMING_VALUES, pairs[p].multiplier, pairs[p].shift);
+        }
+
+        for (uint32_t p = 0; p < num_pairs; ++p)
+        {
+            const pair_t *pair = &pairs[p];
+
+            for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+            {
+                int32_t acc = (pair->layer == 0) ? hidden_accumulators[s][pair->channel] : output_accumulators[s][pair->channel];
+                compare(backend, acc, pair->multiplier, pair->shift, pair->zp, &model);
+            }
+
+            // accumulators spanning the int8 output range (plus a margin) of
+            // this channel: |acc| <= 384 / real
+            double real = ldexp((double)pair->multiplier, -31 - pair->shift);
+            uint32_t span = (uint32_t)(384.0 / real);
+            for (uint32_t i = 0; i < random_per_pair; ++i)
+            {
+                int32_t acc = (int32_t)(next_random(&seed) % (2 * span + 1)) - (int32_t)span;
+                compare(backend, acc, pair->multiplier, pair->shift, pair->zp, &random);
+            }
+        }
+
+        uint32_t agree = 0;
+        uint32_t logits_equal = 0;
+        for (uint32_t s = 0; s < NUM_SAMPLES; ++s)
+        {
+            int8_t logits[OUTPUT_SIZE];
+            int32_t scratch_hidden[HIDDEN_SIZE];
+            int32_t scratch_output[OUTPUT_SIZE];
+            model_logits(backend->requant, inputs[s], logits, scratch_hidden, scratch_output);
+            agree += argmax_int8(logits, OUTPUT_SIZE) == argmax_int8(expected_logits[s], OUTPUT_SIZE) ? 1 : 0;
+            logits_equal += memcmp(logits, expected_logits[s], OUTPUT_SIZE) == 0 ? 1 : 0;
+        }
+
+        printf("%-10s %9.3f %13.3f%% %10" PRId32 " %13.3f%% %10" PRId32 " %4" PRIu32 "/%d %5" PRIu32 "/%d\n",
+               backend->name,
+               (double)ns / ((double)num_pairs * TIMING_ROUNDS * TIMING_VALUES),
+               100.0 * (double)model.mismatches / (double)model.compared,
+               model.max_diff,
+               100.0 * (double)random.mismatches / (double)random.compared,
+               random.max_diff,
+               agree,
+               NUM_SAMPLES,
+               logits_equal,
+               NUM_SAMPLES);
+    }
+
+    printf("top-1: agreement with the exact64 model; logits: samples with bit-identical logits\n");
+
+    return 0;
+}
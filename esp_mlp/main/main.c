@@ -3,10 +3,29 @@
 #include "esp_log.h"
 #include "driver/uart.h"
 #include "driver/uart_vfs.h"
+#if CONFIG_MLP_MODEL_PARTITION
+#include "container.h"
+#endif
+#include "delta.h"
 #include "input.h"
+#include "latency_bench.h"
+#include "mlp.h"
 #include "params.h"
+#if CONFIG_MLP_PLACEMENT
+#include "placement.h"
+#endif
+#if CONFIG_MLP_PROFILE
+#include "profile.h"
+#endif
+#if CONFIG_MLP_SCHEDULER
+#include "scheduler.h"
+#endif
+#if CONFIG_MLP_STREAM
+#include "stream.h"
+#endif
 
 #include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <freertos/task.h>
 
 #include "portmacro.h"
@@ -14,555 +33,257 @@
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
 // -----------------------------------------------------------------------------
-// LUT with approximate uint32 e^x for x=-128..127
-static const uint32_t g_exp_lut_32[256] = {
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000000,
-    0x00000001,
-    0x00000002,
-    0x00000005,
-    0x0000000D,
-    0x00000023,
-    0x0000005E,
-    0x00000100,
-    0x000002B8,
-    0x00000764,
-    0x00001416,
-    0x00003699,
-    0x0000946A,
-    0x0001936E,
-    0x000448A2,
-    0x000BA4F5,
-    0x001FA715,
-    0x00560A77,
-    0x00E9E224,
-    0x027BC2CB,
-    0x06C02D64,
-    0x1259AC49,
-    0x31E1995F,
-    0x87975E85,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-    0xFFFFFFFF,
-};
+// inferences are timed inside a critical section, except with
+// CONFIG_MLP_DUAL_CORE: forward_pass then blocks on the worker task's
+// notification, which needs the scheduler
+#if CONFIG_MLP_DUAL_CORE
+#define INFERENCE_ENTER()
+#define INFERENCE_EXIT()
+#else
+static portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+#define INFERENCE_ENTER() portENTER_CRITICAL(&g_lock)
+#define INFERENCE_EXIT() portEXIT_CRITICAL(&g_lock)
+#endif
 
 // -----------------------------------------------------------------------------
-// saturate a 32-bit integer to int8 range [INT8_MIN..INT8_MAX]
-static inline int8_t saturate_to_int8(int32_t x)
+// model context (the model partition's or the built-in one), for the digit
+// inference, the delta inference (and the scheduler)
+static mlp_model_t g_model;
+static mlp_delta_t g_delta;
+
+// -----------------------------------------------------------------------------
+// the container in the model partition if there is a valid one (checked once,
+// here), else g_params
+static void model_setup(void)
 {
-    if (x > INT8_MAX)
+#if CONFIG_MLP_MODEL_PARTITION
+    static mlp_model_mapping_t mapping;
+    if (mlp_model_map(CONFIG_MLP_MODEL_PARTITION_LABEL, &g_model, &mapping) == 0)
     {
-        return INT8_MAX;
+        ESP_LOGI("esp_mlp", "Model mapped from partition \"%s\" (%" PRIu32 " bytes)", CONFIG_MLP_MODEL_PARTITION_LABEL, mapping.size);
+        return;
     }
-    else if (x < INT8_MIN)
-    {
-        return INT8_MIN;
-    }
-    else
+    ESP_LOGW("esp_mlp", "No valid model in partition \"%s\", running g_params", CONFIG_MLP_MODEL_PARTITION_LABEL);
+#endif
+
+    if (mlp_model_init(&g_model, g_params, PARAMS_SIZE) != 0)
     {
-        return (int8_t)x;
+        ESP_LOGE("esp_mlp", "Broken params blob");
+        abort();
     }
 }
 
+#if CONFIG_MLP_PLACEMENT
 // -----------------------------------------------------------------------------
-// saturating rounding doubling high mul: (a * b + 2^30) >> 31
-static inline int32_t saturating_rounding_doubling_high_mul(int32_t a, int32_t b)
+// copy the hot tensors of g_model out of flash (CONFIG_MLP_PLACE_*); the
+// copies are kept for good
+static void model_place(void)
 {
-    // special case: INT32_MIN * INT32_MIN => saturates
-    if (a == INT32_MIN && b == INT32_MIN)
+    static mlp_placement_t placement;
+    mlp_placement_policy_t policy;
+    mlp_placement_policy_default(&policy);
+
+    int fallbacks = mlp_model_place(&g_model, &policy, &placement);
+    if (fallbacks < 0)
     {
-        return INT32_MAX;
+        ESP_LOGE("esp_mlp", "Placement policy rejected, running from flash");
+        return;
+    }
+    ESP_LOGI("esp_mlp", "Placement: %" PRIu32 " bytes in flash, %" PRIu32 " in DRAM, %" PRIu32 " in PSRAM",
+             placement.bytes[MLP_PLACE_FLASH], placement.bytes[MLP_PLACE_DRAM], placement.bytes[MLP_PLACE_PSRAM]);
+    if (fallbacks > 0)
+    {
+        ESP_LOGW("esp_mlp", "%d tensors left in flash: out of memory", fallbacks);
     }
-
-    // 32-bit only version of: (int64_t)a * (int64_t)b
-    int32_t a_high = a >> 16;
-    int32_t a_low = a & 0xffff;
-    int32_t b_high = b >> 16;
-    int32_t b_low = b & 0xffff;
-
-    int32_t high_high = a_high * b_high;
-    int32_t high_low = a_high * b_low;
-    int32_t low_high = a_low * b_high;
-    int32_t low_low = a_low * b_low;
-
-    // 32x32 = 64 approximation: extract top 32 bits of result
-    // combine partial products and simulate rounding
-    int32_t mid = (low_high + high_low);
-    int32_t mid_high = mid >> 15;
-    int32_t result = high_high << 1;
-    result += mid_high;
-    result += (low_low >> 31); // rounding
-
-    return result;
 }
+#endif
 
+#if CONFIG_MLP_STREAM
 // -----------------------------------------------------------------------------
-// rounding right shift by power-of-two
-static inline int32_t rounding_divide_by_pot(int32_t x, int32_t exponent)
+// the container in CONFIG_MLP_STREAM_PARTITION_LABEL with its weights
+// streamed, run next to every inference
+static mlp_stream_t g_stream;
+static int g_stream_open = 0;
+
+// -----------------------------------------------------------------------------
+static void stream_setup(void)
 {
-    int32_t mask = (1 << exponent) - 1;
-    int32_t remainder = x & mask;
-    int32_t threshold = (mask >> 1) + ((x < 0) ? 1 : 0);
-    return (x >> exponent) + (remainder > threshold ? 1 : 0);
+    if (mlp_stream_open(&g_stream, CONFIG_MLP_STREAM_PARTITION_LABEL, CONFIG_MLP_STREAM_TILE_SIZE) != 0)
+    {
+        ESP_LOGW("esp_mlp", "No valid model in partition \"%s\", not streaming", CONFIG_MLP_STREAM_PARTITION_LABEL);
+        return;
+    }
+    g_stream_open = 1;
+    ESP_LOGI("esp_mlp", "Streaming from partition \"%s\": %" PRIu32 " + %" PRIu32 " tiles of %" PRIu32 " bytes, %" PRIu32 " bytes resident",
+             CONFIG_MLP_STREAM_PARTITION_LABEL, g_stream.hidden_tiles, g_stream.output_tiles, g_stream.tile_size, g_stream.resident_size);
 }
+#endif
 
+#if CONFIG_MLP_SCHEDULER
 // -----------------------------------------------------------------------------
-// multiply by quantized multiplier
-static inline int32_t multiply_by_quantized_multiplier(int32_t val, uint32_t multiplier, int32_t shift)
+// 'b' submits a burst of BURST_SIZE requests over the ten digits to the
+// scheduler and reports throughput and queueing latency
+#define BURST_SIZE 100
+
+static SemaphoreHandle_t g_burst_done;
+static int8_t g_burst_inputs[10][INPUT_SIZE] __attribute__((aligned(16)));
+static int8_t g_burst_outputs[BURST_SIZE][OUTPUT_SIZE];
+static mlp_request_t g_burst_requests[BURST_SIZE];
+
+// -----------------------------------------------------------------------------
+static void burst_request_done(mlp_request_t *request)
 {
-    int32_t result = saturating_rounding_doubling_high_mul(val, (int32_t)multiplier);
-    return rounding_divide_by_pot(result, shift);
+    (void)request;
+    xSemaphoreGive(g_burst_done);
 }
 
 // -----------------------------------------------------------------------------
-// ReLU on int8
-static inline int8_t relu_int8(int8_t x, int8_t zero_point)
+static void scheduler_setup(void)
 {
-    if (x < zero_point)
+    const unsigned char *digits[10] = {
+        g_zero_input, g_one_input, g_two_input, g_three_input, g_four_input,
+        g_five_input, g_six_input, g_seven_input, g_eight_input, g_nine_input,
+    };
+    for (uint32_t d = 0; d < 10; ++d)
     {
-        return zero_point;
+        memcpy((void *)g_burst_inputs[d], (const void *)digits[d], g_input_len);
     }
-    else
+
+    g_burst_done = xSemaphoreCreateCounting(BURST_SIZE, 0);
+    if (g_burst_done == NULL ||
+        mlp_scheduler_start(&g_model, CONFIG_MLP_SCHEDULER_WORKERS) != 0)
     {
-        return x;
+        ESP_LOGE("esp_mlp", "Scheduler start failed");
+        abort();
     }
 }
 
 // -----------------------------------------------------------------------------
-// dense (int8)
-static void dense_int8(
-    const int8_t *inputs,
-    int8_t input_zp,
-    const int8_t *weights,
-    const int8_t *weight_zps,
-    const int32_t *biases,
-    int8_t *outputs,
-    int8_t output_zp,
-    const uint32_t *multipliers,
-    const int32_t *shifts,
-    uint32_t input_size,
-    uint32_t output_size)
+static void run_burst(void)
 {
-    for (uint32_t oc = 0; oc < output_size; ++oc)
-    {
-        // accumulate in 32-bit
-        int32_t acc = 0;
+    mlp_scheduler_stats_t before, after;
+    mlp_scheduler_stats(&before);
 
-        // weighted sum
-        for (uint32_t ic = 0, wc = oc * input_size; ic < input_size; ++ic, ++wc)
-        {
-            int32_t x = (int32_t)inputs[ic] - (int32_t)input_zp;
-            int32_t w = (int32_t)weights[wc] - (int32_t)weight_zps[oc];
-            acc += x * w;
-        }
-
-        acc += biases[oc];
-
-        acc = multiply_by_quantized_multiplier(acc, multipliers[oc], shifts[oc]);
-
-        acc += (int32_t)output_zp;
+    for (uint32_t i = 0; i < BURST_SIZE; ++i)
+    {
+        memset(&g_burst_requests[i], 0, sizeof(g_burst_requests[i]));
+        g_burst_requests[i].inputs = g_burst_inputs[i % 10];
+        g_burst_requests[i].outputs = g_burst_outputs[i];
+        g_burst_requests[i].done = burst_request_done;
+        mlp_scheduler_submit(&g_burst_requests[i]);
+    }
+    for (uint32_t i = 0; i < BURST_SIZE; ++i)
+    {
+        xSemaphoreTake(g_burst_done, portMAX_DELAY);
+    }
 
-        outputs[oc] = saturate_to_int8(acc);
+    mlp_scheduler_stats(&after);
+    uint32_t completed = after.completed - before.completed;
+    uint64_t first = g_burst_requests[0].submit_us;
+    uint64_t last = 0;
+    for (uint32_t i = 0; i < BURST_SIZE; ++i)
+    {
+        last = (g_burst_requests[i].end_us > last) ? g_burst_requests[i].end_us : last;
+    }
+    ESP_LOGI("esp_mlp", "Burst of %" PRIu32 " took %" PRIu64 " us: %" PRIu64 " inferences/s, mean queueing %" PRIu64 " us (max %" PRIu64 "), %" PRIu32 " stolen",
+             completed,
+             last - first,
+             (uint64_t)completed * 1000000u / (last - first),
+             (after.queue_us - before.queue_us) / completed,
+             after.max_queue_us,
+             after.stolen - before.stolen);
+    for (uint32_t w = 0; w < after.workers; ++w)
+    {
+        ESP_LOGI("esp_mlp", "  worker %" PRIu32 ": %" PRIu32 " inferences", w, after.worker_completed[w] - before.worker_completed[w]);
     }
 }
+#endif
 
 // -----------------------------------------------------------------------------
-// dense + ReLU (int8)
-static void dense_relu_int8(
-    const int8_t *inputs,
-    int8_t input_zp,
-    const int8_t *weights,
-    const int8_t *weight_zps,
-    const int32_t *biases,
-    int8_t *outputs,
-    int8_t output_zp,
-    const uint32_t *multipliers,
-    const int32_t *shifts,
-    uint32_t input_size,
-    uint32_t output_size)
+// 'm' benchmarks mlp_model_forward on the selected digit (see latency_bench.h):
+// in a critical section, then preemptible, then with a cold cache
+// (CONFIG_LATENCY_BENCH_COLD); only preemptible with CONFIG_MLP_DUAL_CORE (see
+// INFERENCE_ENTER)
+typedef struct
 {
-    dense_int8(
-        inputs,
-        input_zp,
-        weights,
-        weight_zps,
-        biases,
-        outputs,
-        output_zp,
-        multipliers,
-        shifts,
-        input_size,
-        output_size);
-
-    for (uint32_t oc = 0; oc < output_size; ++oc)
-    {
-        outputs[oc] = relu_int8(outputs[oc], output_zp);
-    }
+    const int8_t *inputs;
+    int8_t *outputs;
+} bench_job_t;
+
+static void bench_forward(void *arg)
+{
+    const bench_job_t *job = (const bench_job_t *)arg;
+    mlp_model_forward(&g_model, job->inputs, job->outputs);
 }
 
 // -----------------------------------------------------------------------------
-// in-place approximate softmax (int8)
-//   1) find max logit
-//   2) shift each logit by (logit[i] - max_logit)
-//   3) convert to e^(shifted_value) using LUT
-//   4) accumulate sum
-//   5) out[i] = (127 * e^shifted_value) / sum (clamped to int8)
-static void softmax_int8_inplace(int8_t *data, uint32_t length)
+static void run_benchmark(const int8_t *inputs)
 {
-    // 1) find max
-    int8_t max_val = data[0];
-    for (uint32_t i = 1; i < length; ++i)
+    int8_t outputs[OUTPUT_SIZE];
+    bench_job_t job = {inputs, outputs};
+    latency_bench_stats_t stats;
+
+#if !CONFIG_MLP_DUAL_CORE
+    if (latency_bench_run(LATENCY_BENCH_CRITICAL, bench_forward, &job, &stats) != 0)
     {
-        if (data[i] > max_val)
-        {
-            max_val = data[i];
-        }
+        ESP_LOGE("esp_mlp", "Benchmark failed");
+        return;
     }
-
-    // 2) exponential transform
-    // store intermediate e^x in a 32-bit
-    // sum_exp in 32-bit as well
-    // clamp partial sums to avoid overflow
-    uint32_t exp_array[16]; // arbitrary max length
-    uint32_t sum_exp = 0;
-
-    for (uint32_t i = 0; i < length; ++i)
+    latency_bench_print("esp_mlp", "mlp_model_forward", &stats);
+#endif
+    if (latency_bench_run(LATENCY_BENCH_PREEMPTIBLE, bench_forward, &job, &stats) != 0)
     {
-        int32_t shift_val = (int32_t)data[i] - (int32_t)max_val; // range -255..255
-        if (shift_val < -128)
-        {
-            shift_val = -128; // clamp
-        }
-        else if (shift_val > 127)
-        {
-            shift_val = 127; // clamp
-        }
-
-        // look up e^shift_val from the LUT [0..255]
-        uint32_t e_val = g_exp_lut_32[shift_val + 128];
-
-        exp_array[i] = e_val;
-
-        // accumulte
-        sum_exp += e_val;
-
-        if (sum_exp < e_val)
-        {
-            // clamp sum_exp to max 32-bit
-            sum_exp = UINT32_MAX;
-        }
+        ESP_LOGE("esp_mlp", "Benchmark failed");
+        return;
     }
-
-    // 3) out[i] = (127 * exp_array[i]) / sum_exp
-    for (uint32_t i = 0; i < length; ++i)
+    latency_bench_print("esp_mlp", "mlp_model_forward", &stats);
+#if CONFIG_LATENCY_BENCH_COLD
+#if CONFIG_MLP_DUAL_CORE
+    latency_bench_mode_t cold_mode = LATENCY_BENCH_PREEMPTIBLE;
+#else
+    latency_bench_mode_t cold_mode = LATENCY_BENCH_CRITICAL;
+#endif
+    if (latency_bench_run_cold(cold_mode, bench_forward, &job, &stats) != 0)
     {
-        if (sum_exp == 0)
-        {
-            data[i] = 0;
-        }
-        else
-        {
-            uint32_t val = (exp_array[i] * 127) / sum_exp;
-            if (val > 127)
-            {
-                val = 127;
-            }
-            data[i] = (int8_t)val;
-        }
+        ESP_LOGE("esp_mlp", "Cold benchmark failed (no \"%s\" partition?)", CONFIG_LATENCY_BENCH_EVICT_PARTITION);
+        return;
     }
+    latency_bench_print("esp_mlp", "mlp_model_forward", &stats);
+#endif
 }
 
+#if CONFIG_MLP_PROFILE
 // -----------------------------------------------------------------------------
-// forward pass:
-//   1) dense+ReLU
-//   2) dense
-//   3) softmax
-static void forward_pass(const int8_t *inputs, int8_t *outputs)
+static void profile_write(const void *data, uint32_t size, void *arg)
 {
-    int8_t hiddens[HIDDEN_SIZE];
-
-    const int8_t *hidden_weights = (int8_t *)&g_params[HIDDEN_WEIGHT_OFFSET];
-    const int32_t *hidden_biases = (int32_t *)&g_params[HIDDEN_BIAS_OFFSET];
-    const int8_t *output_weights = (int8_t *)&g_params[OUTPUT_WEIGHT_OFFSET];
-    const int32_t *output_biases = (int32_t *)&g_params[OUTPUT_BIAS_OFFSET];
-    int8_t input_zp = (int8_t)g_params[INPUT_ZP_OFFSET];
-    const int8_t *hidden_weight_zps = (int8_t *)&g_params[HIDDEN_WEIGHT_ZP_OFFSET];
-    int8_t hidden_zp = (int8_t)g_params[HIDDEN_ZP_OFFSET];
-    const uint32_t *layer1_multipliers = (uint32_t *)&g_params[LAYER1_MULTIPLIER_OFFSET];
-    const int32_t *layer1_scales = (int32_t *)&g_params[LAYER1_SCALE_OFFSET];
-    const int8_t *output_weight_zps = (int8_t *)&g_params[OUTPUT_WEIGHT_ZP_OFFSET];
-    int8_t output_zp = (int8_t)g_params[OUTPUT_ZP_OFFSET];
-    const uint32_t *layer2_multipliers = (uint32_t *)&g_params[LAYER2_MULTIPLIER_OFFSET];
-    const int32_t *layer2_scales = (int32_t *)&g_params[LAYER2_SCALE_OFFSET];
-
-    // 1) dense+ReLU: input -> hidden
-    dense_relu_int8(
-        inputs,
-        input_zp,
-        hidden_weights,
-        hidden_weight_zps,
-        hidden_biases,
-        hiddens,
-        hidden_zp,
-        layer1_multipliers,
-        layer1_scales,
-        INPUT_SIZE,
-        HIDDEN_SIZE);
-
-    // 2) dense (no activation) for final logits
-    dense_int8(
-        hiddens,
-        hidden_zp,
-        output_weights,
-        output_weight_zps,
-        output_biases,
-        outputs,
-        output_zp,
-        layer2_multipliers,
-        layer2_scales,
-        HIDDEN_SIZE,
-        OUTPUT_SIZE);
-
-    // 3) in-place quantized softmax
-    softmax_int8_inplace(outputs, OUTPUT_SIZE);
+    (void)arg;
+    uart_write_bytes(CONFIG_ESP_CONSOLE_UART_NUM, data, size);
 }
 
+// -----------------------------------------------------------------------------
+// binary dump of the profiler's records (see profile.h) straight to the console
+// UART, for scripts/profile_decode.py, which finds it by its magic; the records
+// are dropped afterwards so each dump covers the inferences since the last
+static void profile_dump(void)
+{
+    fflush(stdout);
+    uint32_t count = mlp_profile_dump(profile_write, NULL);
+    uart_wait_tx_done(CONFIG_ESP_CONSOLE_UART_NUM, portMAX_DELAY);
+    mlp_profile_reset();
+    printf("\n");
+    ESP_LOGI("esp_mlp", "Profile: %" PRIu32 " records dumped", count);
+}
+#endif
+
 // -----------------------------------------------------------------------------
 void app_main(void)
 {
-    int8_t inputs[INPUT_SIZE];
+    int8_t inputs[INPUT_SIZE] __attribute__((aligned(16)));
     int8_t outputs[OUTPUT_SIZE];
     char c;
     uint32_t start, end;
@@ -578,9 +299,30 @@ void app_main(void)
     printf(" |_|  |_| |______| |_|       \n");
     printf("\n");
 
+    model_setup();
+#if CONFIG_MLP_PLACEMENT
+    model_place();
+#endif
+    mlp_delta_init(&g_delta, &g_model);
+    memcpy((void *)inputs, (void *)g_zero_input, g_input_len);
+
+#if CONFIG_MLP_SCHEDULER
+    scheduler_setup();
+#endif
+#if CONFIG_MLP_STREAM
+    stream_setup();
+#endif
+
     while (1)
     {
-        printf("Select digit [0-9]: ");
+        printf("Select digit [0-9], benchmark it [m]");
+#if CONFIG_MLP_SCHEDULER
+        printf(", burst [b]");
+#endif
+#if CONFIG_MLP_PROFILE
+        printf(", profile dump [p]");
+#endif
+        printf(": ");
 
         c = (char)getchar();
 
@@ -618,17 +360,29 @@ void app_main(void)
         case '9':
             memcpy((void *)inputs, (void *)g_nine_input, g_input_len);
             break;
+        case 'm':
+            run_benchmark(inputs);
+            continue;
+#if CONFIG_MLP_SCHEDULER
+        case 'b':
+            run_burst();
+            continue;
+#endif
+#if CONFIG_MLP_PROFILE
+        case 'p':
+            profile_dump();
+            continue;
+#endif
         default:
             printf("Invalid digit: %c", c);
             continue;
         }
 
-        static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
-        portENTER_CRITICAL(&lock);
+        INFERENCE_ENTER();
         start = esp_cpu_get_cycle_count();
-        forward_pass(inputs, outputs);
+        mlp_model_forward(&g_model, inputs, outputs);
         end = esp_cpu_get_cycle_count();
-        portEXIT_CRITICAL(&lock);
+        INFERENCE_EXIT();
         ESP_LOGI("esp_mlp", "Inference took %" PRIu32 " cycles", end - start);
 
         printf("******************************\n");
@@ -637,5 +391,38 @@ void app_main(void)
             printf("Class %" PRIu32 " => %d\n", i, outputs[i]);
         }
         printf("******************************\n");
+
+        // same inference, winning class only (no softmax)
+        uint32_t best;
+        int8_t best_logit;
+        INFERENCE_ENTER();
+        start = esp_cpu_get_cycle_count();
+        mlp_model_topk(&g_model, inputs, 1, 1, &best, &best_logit);
+        end = esp_cpu_get_cycle_count();
+        INFERENCE_EXIT();
+        ESP_LOGI("esp_mlp", "Top-1 took %" PRIu32 " cycles: class %" PRIu32 " (logit %d)", end - start, best, best_logit);
+
+        // same inference, incrementally from the previously selected digit
+        uint32_t changed;
+        INFERENCE_ENTER();
+        start = esp_cpu_get_cycle_count();
+        changed = mlp_delta_forward(&g_delta, inputs, outputs);
+        end = esp_cpu_get_cycle_count();
+        INFERENCE_EXIT();
+        ESP_LOGI("esp_mlp", "Delta inference took %" PRIu32 " cycles (%" PRIu32 " pixels changed)", end - start, changed);
+
+#if CONFIG_MLP_STREAM
+        // same inference with the weights streamed: it blocks on the loader
+        // task, so never inside a critical section
+        if (g_stream_open)
+        {
+            int8_t streamed[OUTPUT_SIZE];
+            start = esp_cpu_get_cycle_count();
+            int result = mlp_stream_forward(&g_stream, inputs, streamed);
+            end = esp_cpu_get_cycle_count();
+            ESP_LOGI("esp_mlp", "Streamed inference took %" PRIu32 " cycles (%s)", end - start,
+                     (result != 0) ? "read failed" : (memcmp(streamed, outputs, OUTPUT_SIZE) == 0) ? "same scores" : "different scores");
+        }
+#endif
     }
 }
@@ -0,0 +1,566 @@
+from argparse import ArgumentParser
+import math
+import struct
+import sys
+import zlib
+from pathlib import *
+
+import numpy as np
+
+_SCRIPT_PATH = Path(__file__).resolve()
+
+# plan.h
+_PLAN_MAGIC = 0x4e414c50
+_PLAN_VERSION = 3
+_PLAN_ALIGN = 16
+_PLAN_NONE = 0xffffffff
+_LAYER_DENSE = 1
+_LAYER_SOFTMAX = 2
+_ACTIVATION_NONE = 0
+_ACTIVATION_RELU = 1
+_ACTIVATION_RELU6 = 2
+_ACTIVATION_LUT = 3
+
+# dense.h
+_LUT_SIZE = 256
+
+# container.h
+_CONTAINER_MAGIC = 0x4d504c4d
+_CONTAINER_VERSION = 1
+_CONTAINER_ALIGN = 16
+_CONTAINER_HEADER_SIZE = 48
+_CONTAINER_TENSOR_SIZE = 32
+_DTYPE_UINT8 = 1
+_DTYPE_INT8 = 2
+_DTYPE_INT32 = 3
+_DTYPE_UINT32 = 4
+_QUANT_NONE = 0
+_QUANT_PER_CHANNEL = 2
+
+# softmax.c
+_SOFTMAX_DIFF_INTEGER_BITS = 5
+
+# TFLite schema: tensor types, builtin operators, activations
+_TFLITE_INT8 = 9
+_TFLITE_INT32 = 2
+_TFLITE_FULLY_CONNECTED = 9
+_TFLITE_SOFTMAX = 25
+_TFLITE_LOGISTIC = 14
+_TFLITE_TANH = 28
+_TFLITE_RELU = 1
+_TFLITE_RELU6 = 3
+
+
+def _align_up(size, align):
+    return (size + align - 1) // align * align
+
+
+# -----------------------------------------------------------------------------
+# flatbuffers, read-only and just enough of them for the TFLite schema
+class _Table:
+    def __init__(self, buf, pos):
+        self.buf = buf
+        self.pos = pos
+        self.vtable = pos - struct.unpack_from('<i', buf, pos)[0]
+        self.vtable_size = struct.unpack_from('<H', buf, self.vtable)[0]
+
+    def _field(self, index):
+        entry = 4 + 2 * index
+        if entry >= self.vtable_size:
+            return 0
+        return struct.unpack_from('<H', self.buf, self.vtable + entry)[0]
+
+    def _indirect(self, index):
+        field = self._field(index)
+        if field == 0:
+            return None
+        pos = self.pos + field
+        return pos + struct.unpack_from('<I', self.buf, pos)[0]
+
+    def scalar(self, index, fmt, default=0):
+        field = self._field(index)
+        if field == 0:
+            return default
+        return struct.unpack_from('<' + fmt, self.buf, self.pos + field)[0]
+
+    def table(self, index):
+        pos = self._indirect(index)
+        return None if pos is None else _Table(self.buf, pos)
+
+    def tables(self, index):
+        pos = self._indirect(index)
+        if pos is None:
+            return []
+        count = struct.unpack_from('<I', self.buf, pos)[0]
+        items = []
+        for i in range(count):
+            item = pos + 4 + 4 * i
+            items.append(_Table(self.buf, item + struct.unpack_from('<I', self.buf, item)[0]))
+        return items
+
+    def vector(self, index, dtype):
+        pos = self._indirect(index)
+        if pos is None:
+            return None
+        count = struct.unpack_from('<I', self.buf, pos)[0]
+        return np.frombuffer(self.buf, dtype=dtype, count=count, offset=pos + 4)
+
+    def string(self, index):
+        data = self.vector(index, np.uint8)
+        return None if data is None else data.tobytes().decode()
+
+
+# -----------------------------------------------------------------------------
+# model: two dense layers (the first one with an activation) and a softmax,
+# quantized as the engine runs it; activation is 'none', 'relu', 'relu6', or
+# 'sigmoid'/'tanh' (a lookup table from the dense output quantization to
+# activation_scale/activation_zp, which the next layer reads)
+class _Dense:
+    def __init__(self, weights, weight_scales, weight_zps, biases, input_scale, input_zp, output_scale, output_zp,
+                 activation, activation_scale=None, activation_zp=None):
+        self.weights = weights              # int8 [output][input]
+        self.weight_scales = weight_scales  # float [output]
+        self.weight_zps = weight_zps        # int8 [output]
+        self.biases = biases                # int32 [output]
+        self.input_scale = input_scale
+        self.input_zp = input_zp
+        self.output_scale = output_scale
+        self.output_zp = output_zp
+        self.activation = activation
+        self.activation_scale = activation_scale
+        self.activation_zp = activation_zp
+
+
+class _Model:
+    def __init__(self, hidden, output, beta):
+        self.hidden = hidden
+        self.output = output
+        self.beta = beta
+
+
+def _quantization(tensor, size):
+    quant = tensor.table(4)
+    if quant is None or quant.vector(2, np.float32) is None:
+        raise RuntimeError(f"tensor {tensor.string(3)} isn't quantized")
+    scales = quant.vector(2, np.float32).astype(np.float64)
+    zero_points = quant.vector(3, np.int64)
+    if zero_points is None:
+        zero_points = np.zeros(len(scales), dtype=np.int64)
+    if len(scales) == 1:
+        scales = np.repeat(scales, size)
+        zero_points = np.repeat(zero_points, size)
+    if len(scales) != size:
+        raise RuntimeError(f"tensor {tensor.string(3)} has {len(scales)} scales, expected {size}")
+    return scales, zero_points
+
+
+def load_tflite(path):
+    buf = open(path, 'rb').read()
+    model = _Table(buf, struct.unpack_from('<I', buf, 0)[0])
+    opcodes = []
+    for opcode in model.tables(1):
+        # builtin_code, or the deprecated int8 one for old converters
+        opcodes.append(max(opcode.scalar(3, 'i'), opcode.scalar(0, 'b')))
+    buffers = model.tables(4)
+    subgraphs = model.tables(2)
+    if len(subgraphs) != 1:
+        raise RuntimeError(f"{path}: {len(subgraphs)} subgraphs, expected 1")
+    tensors = subgraphs[0].tables(0)
+    operators = subgraphs[0].tables(3)
+
+    def constant(index, dtype):
+        data = buffers[tensors[index].scalar(2, 'I')].vector(0, np.uint8)
+        if data is None:
+            raise RuntimeError(f"tensor {tensors[index].string(3)} has no data")
+        return np.frombuffer(data.tobytes(), dtype=dtype)
+
+    def activation(index):
+        tensor = tensors[index]
+        if tensor.scalar(1, 'b') != _TFLITE_INT8:
+            raise RuntimeError(f"tensor {tensor.string(3)} isn't int8")
+        scales, zero_points = _quantization(tensor, 1)
+        return float(scales[0]), int(zero_points[0])
+
+    kinds = [opcodes[op.scalar(0, 'I')] for op in operators]
+    lookups = {_TFLITE_LOGISTIC: 'sigmoid', _TFLITE_TANH: 'tanh'}
+    lookup = None
+    if len(kinds) == 4 and kinds[1] in lookups:
+        lookup = operators[1]
+        operators = [operators[0], operators[2], operators[3]]
+        kinds = [kinds[0], kinds[2], kinds[3]]
+    if kinds != [_TFLITE_FULLY_CONNECTED, _TFLITE_FULLY_CONNECTED, _TFLITE_SOFTMAX]:
+        raise RuntimeError(f"{path}: operators {kinds}, expected FULLY_CONNECTED, [LOGISTIC|TANH,] FULLY_CONNECTED, SOFTMAX")
+
+    layers = []
+    for op in operators[:2]:
+        inputs = op.vector(1, np.int32)
+        outputs = op.vector(2, np.int32)
+        weights_tensor = tensors[inputs[1]]
+        shape = weights_tensor.vector(0, np.int32)
+        if weights_tensor.scalar(1, 'b') != _TFLITE_INT8 or len(shape) != 2:
+            raise RuntimeError(f"tensor {weights_tensor.string(3)}: expected int8 [output][input] weights")
+        if len(inputs) < 3 or inputs[2] < 0 or tensors[inputs[2]].scalar(1, 'b') != _TFLITE_INT32:
+            raise RuntimeError(f"layer {len(layers)}: expected int32 biases")
+        output_size, input_size = int(shape[0]), int(shape[1])
+        weight_scales, weight_zps = _quantization(weights_tensor, output_size)
+        input_scale, input_zp = activation(inputs[0])
+        output_scale, output_zp = activation(outputs[0])
+        options = op.table(4)
+        fused = 0 if options is None else options.scalar(0, 'b')
+        if fused not in (0, _TFLITE_RELU, _TFLITE_RELU6):
+            raise RuntimeError(f"layer {len(layers)}: unsupported fused activation {fused}")
+        layers.append(_Dense(
+            constant(inputs[1], np.int8).reshape(output_size, input_size),
+            weight_scales,
+            weight_zps.astype(np.int8),
+            constant(inputs[2], np.int32),
+            input_scale, input_zp, output_scale, output_zp,
+            {0: 'none', _TFLITE_RELU: 'relu', _TFLITE_RELU6: 'relu6'}[fused]))
+
+    if lookup is not None:
+        hidden = layers[0]
+        if hidden.activation != 'none' or lookup.vector(1, np.int32)[0] != operators[0].vector(2, np.int32)[0]:
+            raise RuntimeError(f"{path}: {lookups[opcodes[lookup.scalar(0, 'I')]]} must directly follow the hidden layer")
+        hidden.activation = lookups[opcodes[lookup.scalar(0, 'I')]]
+        hidden.activation_scale, hidden.activation_zp = activation(lookup.vector(2, np.int32)[0])
+    # the built-in sequence runs the hidden layer with ReLU unless the blob
+    # carries HIDDEN_ACTIVATION, which 'none' doesn't
+    if layers[0].activation == 'none':
+        raise RuntimeError(f"{path}: the hidden layer has no activation, expected RELU, RELU6, LOGISTIC or TANH")
+
+    softmax = operators[2]
+    softmax_options = softmax.table(4)
+    beta = 1.0 if softmax_options is None else float(softmax_options.scalar(0, 'f', 1.0))
+    if activation(softmax.vector(2, np.int32)[0]) != (1.0 / 256.0, -128):
+        raise RuntimeError(f"{path}: softmax output isn't quantized with scale 1/256, zero-point -128")
+
+    return _Model(layers[0], layers[1], beta)
+
+
+# -----------------------------------------------------------------------------
+# float model (npz): hidden_weights/output_weights [output][input] and
+# hidden_biases/output_biases, plus the calibrated (min, max) of the input,
+# hidden and output activations as input_range/hidden_range/output_range, an
+# optional softmax beta and an optional hidden_activation ('relu', the
+# default, 'relu6', 'sigmoid' or 'tanh'; hidden_range is then the range before
+# the activation); quantized as the TFLite converter does (int8 asymmetric
+# activations, per-channel symmetric int8 weights, int32 biases, sigmoid and
+# tanh outputs at 1/256, -128 and 1/128, 0)
+def _activation_quantization(value_range):
+    low, high = min(float(value_range[0]), 0.0), max(float(value_range[1]), 0.0)
+    scale = (high - low) / 255.0 if high > low else 1.0
+    zero_point = int(np.clip(round(-128 - low / scale), -128, 127))
+    return scale, zero_point
+
+
+def _quantize_dense(weights, biases, input_q, output_q, activation):
+    weights = np.asarray(weights, dtype=np.float64)
+    biases = np.asarray(biases, dtype=np.float64)
+    weight_scales = np.abs(weights).max(axis=1) / 127.0
+    weight_scales[weight_scales == 0.0] = 1.0
+    quantized = np.clip(np.round(weights / weight_scales[:, None]), -127, 127).astype(np.int8)
+    bias_scales = input_q[0] * weight_scales
+    quantized_biases = np.round(biases / bias_scales).astype(np.int32)
+    return _Dense(
+        quantized, weight_scales, np.zeros(len(weight_scales), dtype=np.int8), quantized_biases,
+        input_q[0], input_q[1], output_q[0], output_q[1], activation)
+
+
+def load_float(path):
+    data = np.load(path)
+    input_q = _activation_quantization(data['input_range'])
+    hidden_q = _activation_quantization(data['hidden_range'])
+    output_q = _activation_quantization(data['output_range'])
+    beta = float(data['beta']) if 'beta' in data else 1.0
+    activation = str(data['hidden_activation']) if 'hidden_activation' in data else 'relu'
+    lookups = {'sigmoid': (1.0 / 256.0, -128), 'tanh': (1.0 / 128.0, 0)}
+    if activation not in ('relu', 'relu6') and activation not in lookups:
+        raise RuntimeError(f"{path}: unsupported hidden_activation {activation}")
+    hidden = _quantize_dense(data['hidden_weights'], data['hidden_biases'], input_q, hidden_q, activation)
+    if activation in lookups:
+        hidden.activation_scale, hidden.activation_zp = lookups[activation]
+        hidden_q = lookups[activation]
+    output = _quantize_dense(data['output_weights'], data['output_biases'], hidden_q, output_q, 'none')
+    if hidden.weights.shape[0] != output.weights.shape[1]:
+        raise RuntimeError(f"{path}: hidden layer has {hidden.weights.shape[0]} outputs, output layer {output.weights.shape[1]} inputs")
+    return _Model(hidden, output, beta)
+
+
+# -----------------------------------------------------------------------------
+# quantize.c: real = multiplier * 2^-31 * 2^-shift, multiplier in [2^30, 2^31)
+def _quantize_multiplier(real):
+    if real <= 0.0:
+        return 0, 0
+    fraction, exponent = math.frexp(real)
+    q = math.floor(math.ldexp(fraction, 31) + 0.5)
+    if q == 1 << 31:
+        q //= 2
+        exponent += 1
+    if exponent > 0:
+        raise RuntimeError(f"multiplier {real} is >= 1, the kernels only shift right")
+    return q, -exponent
+
+
+# softmax.c softmax_prepare
+def _softmax_params(input_scale, beta):
+    real = min(beta * input_scale * float(1 << (31 - _SOFTMAX_DIFF_INTEGER_BITS)), float((1 << 31) - 1))
+    fraction, exponent = math.frexp(real)
+    q = math.floor(math.ldexp(fraction, 31) + 0.5)
+    if q == 1 << 31:
+        q //= 2
+        exponent += 1
+    if exponent < 0 or exponent > 30:
+        raise RuntimeError(f"softmax input scale * beta {real} is out of range")
+    radius = math.ldexp(float((1 << _SOFTMAX_DIFF_INTEGER_BITS) - 1), 31 - _SOFTMAX_DIFF_INTEGER_BITS - exponent)
+    return np.array([q, exponent, -math.floor(radius)], dtype=np.int32)
+
+
+def _requantization(layer):
+    pairs = [_quantize_multiplier(layer.input_scale * float(s) / layer.output_scale) for s in layer.weight_scales]
+    return (np.array([m for m, _ in pairs], dtype=np.uint32),
+            np.array([s for _, s in pairs], dtype=np.int32))
+
+
+_ACTIVATION_NAMES = {'none': 'linear', 'relu': 'ReLU', 'relu6': 'ReLU6', 'sigmoid': 'sigmoid', 'tanh': 'tanh'}
+
+
+# dense_epilogue.c: real -> int8, rounded half away from zero
+def _quantize_int8(real, scale, zero_point):
+    q = math.copysign(math.floor(abs(real / scale) + 0.5), real) + zero_point
+    return int(min(max(q, -128), 127))
+
+
+# the parameters of a plan activation (see plan.h), or None: dense_relu6_max,
+# dense_activation_lut
+def _activation_params(layer):
+    if layer.activation == 'relu6':
+        return np.array([_quantize_int8(6.0, layer.output_scale, layer.output_zp)], dtype=np.int8)
+    if layer.activation in ('sigmoid', 'tanh'):
+        lut = []
+        for i in range(_LUT_SIZE):
+            x = (i - 128 - layer.output_zp) * layer.output_scale
+            y = 1.0 / (1.0 + math.exp(-x)) if layer.activation == 'sigmoid' else math.tanh(x)
+            lut.append(_quantize_int8(y, layer.activation_scale, layer.activation_zp))
+        return np.array(lut, dtype=np.int8)
+    return None
+
+
+# dense.c dense_fold_zero_points
+def _folded_biases(layer):
+    weight_sums = layer.weights.astype(np.int64).sum(axis=1)
+    input_size = layer.weights.shape[1]
+    folded = (layer.biases.astype(np.int64) - layer.input_zp * weight_sums +
+              input_size * layer.input_zp * layer.weight_zps.astype(np.int64))
+    return folded.astype(np.int32)
+
+
+# -----------------------------------------------------------------------------
+# the tensors of the params blob, in params.h order: (macro, comment of the
+# section it opens or None, data)
+def _tensors(model):
+    hidden, output = model.hidden, model.output
+    hidden_multipliers, hidden_shifts = _requantization(hidden)
+    output_multipliers, output_shifts = _requantization(output)
+    softmax = _softmax_params(output.output_scale, model.beta)
+    tensors = [
+        ('HIDDEN_WEIGHT', 'hidden layer weights', hidden.weights),
+        ('HIDDEN_BIAS', 'hidden layer biases', hidden.biases),
+        ('OUTPUT_WEIGHT', 'output layer weights', output.weights),
+        ('OUTPUT_BIAS', 'output layer biases', output.biases),
+        ('INPUT_ZP', 'input layer zero-point', np.array([hidden.input_zp], dtype=np.int8)),
+        ('HIDDEN_ZP', 'hidden layer zero-point', np.array([hidden.output_zp], dtype=np.int8)),
+        ('HIDDEN_WEIGHT_ZP', 'hidden layer weights zero-point', hidden.weight_zps),
+        ('LAYER1_MULTIPLIER', 'layer1 multipler/shift', hidden_multipliers),
+        ('LAYER1_SCALE', None, hidden_shifts),
+        ('OUTPUT_ZP', 'output layer zero-point', np.array([output.output_zp], dtype=np.int8)),
+        ('OUTPUT_WEIGHT_ZP', 'output layer weights zero-point', output.weight_zps),
+        ('LAYER2_MULTIPLIER', 'layer2 multipler/shift', output_multipliers),
+        ('LAYER2_SCALE', None, output_shifts),
+        ('PLAN', f'execution plan (see plan.h): dense+{_ACTIVATION_NAMES[hidden.activation]}, dense, softmax', None),
+        ('HIDDEN_FOLDED_BIAS', 'hidden/output layer biases with the zero-points folded in, for the plan', _folded_biases(hidden)),
+        ('OUTPUT_FOLDED_BIAS', None, _folded_biases(output)),
+        ('SOFTMAX_PARAMS', f'output softmax params (see softmax.h), from the logits scale\n// ({output.output_scale:.8f}) and beta ({model.beta}) in the model', softmax),
+    ]
+    activation = _activation_params(hidden)
+    if activation is not None:
+        tensors.append(('HIDDEN_ACTIVATION', f'hidden layer {hidden.activation} parameters, for the plan (see plan.h)', activation))
+    return tensors
+
+
+# plan.h: dense+activation, dense, softmax over the tensors at offsets[macro]
+def _plan(model, offsets):
+    hidden, output = model.hidden, model.output
+    input_size = hidden.weights.shape[1]
+    hidden_size = hidden.weights.shape[0]
+    output_size = output.weights.shape[0]
+
+    def zps(macro, layer):
+        return offsets[macro] if layer.weight_zps.any() else _PLAN_NONE
+
+    codes = {'none': _ACTIVATION_NONE, 'relu': _ACTIVATION_RELU, 'relu6': _ACTIVATION_RELU6,
+             'sigmoid': _ACTIVATION_LUT, 'tanh': _ACTIVATION_LUT}
+    hidden_params = offsets.get('HIDDEN_ACTIVATION', _PLAN_NONE)
+    if output.activation not in ('none', 'relu'):
+        raise RuntimeError(f"output layer: unsupported activation {output.activation}")
+
+    # the first layer reads the caller's inputs, the second one writes the
+    # caller's outputs: only the hidden activations live in the arena
+    arena_size = _align_up(hidden_size, _PLAN_ALIGN)
+    plan = struct.pack('<IHHIII', _PLAN_MAGIC, _PLAN_VERSION, 3, input_size, output_size, arena_size)
+    plan += struct.pack('<BBbbIIIIIIII', _LAYER_DENSE, codes[hidden.activation],
+                        hidden.input_zp, hidden.output_zp, input_size, hidden_size,
+                        offsets['HIDDEN_WEIGHT'], zps('HIDDEN_WEIGHT_ZP', hidden), offsets['HIDDEN_FOLDED_BIAS'],
+                        offsets['LAYER1_MULTIPLIER'], offsets['LAYER1_SCALE'], hidden_params)
+    plan += struct.pack('<BBbbIIIIIIII', _LAYER_DENSE, codes[output.activation],
+                        output.input_zp, output.output_zp, hidden_size, output_size,
+                        offsets['OUTPUT_WEIGHT'], zps('OUTPUT_WEIGHT_ZP', output), offsets['OUTPUT_FOLDED_BIAS'],
+                        offsets['LAYER2_MULTIPLIER'], offsets['LAYER2_SCALE'], _PLAN_NONE)
+    plan += struct.pack('<BBbbIIIIIIII', _LAYER_SOFTMAX, _ACTIVATION_NONE, output.output_zp, output.output_zp,
+                        output_size, output_size, _PLAN_NONE, _PLAN_NONE, _PLAN_NONE, offsets['SOFTMAX_PARAMS'],
+                        _PLAN_NONE, _PLAN_NONE)
+    return plan, arena_size
+
+
+def _place(tensors, align, plan_size):
+    offsets = {}
+    end = 0
+    for macro, _, data in tensors:
+        offsets[macro] = _align_up(end, align)
+        end = offsets[macro] + (plan_size if data is None else data.nbytes)
+    return offsets, _align_up(end, align)
+
+
+# -----------------------------------------------------------------------------
+# params.h/params.c: every tensor on an align boundary of the blob, which is
+# itself aligned to that much
+def write_params(model, directory, align, source):
+    tensors = _tensors(model)
+    plan_size = len(_plan(model, {macro: 0 for macro, _, _ in tensors})[0])
+    offsets, params_size = _place(tensors, align, plan_size)
+    plan, arena_size = _plan(model, offsets)
+
+    blob = bytearray(params_size)
+    for macro, _, data in tensors:
+        payload = plan if data is None else data.tobytes()
+        blob[offsets[macro]:offsets[macro] + len(payload)] = payload
+
+    input_size = model.hidden.weights.shape[1]
+    width = math.isqrt(input_size)
+    height = input_size // width if width * width == input_size else 1
+    width = width if width * width == input_size else input_size
+    notice = f"// generated by gen_params.py from {Path(source).name}; do not edit\n"
+
+    header = ["#ifndef PARAMS_H_\n#define PARAMS_H_\n\n", notice, "\n#include <inttypes.h>\n\n",
+              "// -----------------------------------------------------------------------------\n// params\n\n"]
+    for name, value in [('BATCH_SIZE', 1), ('INPUT_WIDTH', width), ('INPUT_HEIGHT', height),
+                        ('INPUT_SIZE', input_size), ('HIDDEN_SIZE', model.hidden.weights.shape[0]),
+                        ('OUTPUT_SIZE', model.output.weights.shape[0])]:
+        header.append(f"#define {name:<27} {value}\n")
+    header.append("\n// -----------------------------------------------------------------------------\n"
+                  "// every tensor starts on a PARAMS_ALIGN boundary of g_params\n"
+                  f"#define {'PARAMS_ALIGN':<27} {align}\n")
+    for macro, comment, data in tensors:
+        if comment is not None:
+            header.append(f"\n// -----------------------------------------------------------------------------\n// {comment}\n")
+        header.append(f"#define {macro + '_OFFSET':<27} {offsets[macro]}\n")
+        header.append(f"#define {macro + '_SIZE':<27} {plan_size if data is None else data.nbytes}\n")
+        if macro == 'PLAN':
+            header.append(f"#define {'PLAN_ARENA_SIZE':<27} {arena_size}\n")
+    header.append("\n// -----------------------------------------------------------------------------\n// total size\n")
+    header.append(f"#define {'PARAMS_SIZE':<27} {params_size}\n\nextern const uint8_t g_params[];\n\n#endif\n")
+
+    source_lines = [notice, '\n#include "params.h"\n\n',
+                    "// -----------------------------------------------------------------------------\n"
+                    "// the int32_t/uint32_t tables are read in place, so they must be word-aligned\n"
+                    "_Static_assert(PARAMS_ALIGN % 4 == 0, \"PARAMS_ALIGN must be a multiple of 4\");\n"]
+    for macro, _, _ in tensors:
+        source_lines.append(f"_Static_assert({macro}_OFFSET % PARAMS_ALIGN == 0, \"{macro}_OFFSET is misaligned\");\n")
+    source_lines.append("\nconst uint8_t g_params[PARAMS_SIZE] __attribute__((aligned(PARAMS_ALIGN))) = {\n")
+    rows = [", ".join(f"0x{b:02x}" for b in blob[i:i + 12]) for i in range(0, len(blob), 12)]
+    source_lines.append(",\n".join("    " + row for row in rows) + "};\n")
+
+    directory = Path(directory)
+    (directory / 'include' / 'params.h').write_text("".join(header))
+    (directory / 'params.c').write_text("".join(source_lines))
+    print(f"{directory / 'params.c'}: {params_size} bytes, tensors aligned to {align}")
+
+
+# -----------------------------------------------------------------------------
+# container.h: header, tensor table, data section with every tensor on a
+# MLP_CONTAINER_ALIGN boundary and the plan offsets relative to it
+_CONTAINER_TENSORS = [
+    (1, 'HIDDEN_WEIGHT', _DTYPE_INT8, _QUANT_PER_CHANNEL),
+    (2, 'HIDDEN_BIAS', _DTYPE_INT32, _QUANT_PER_CHANNEL),
+    (3, 'HIDDEN_WEIGHT_ZP', _DTYPE_INT8, _QUANT_NONE),
+    (4, 'HIDDEN_FOLDED_BIAS', _DTYPE_INT32, _QUANT_PER_CHANNEL),
+    (5, 'LAYER1_MULTIPLIER', _DTYPE_UINT32, _QUANT_NONE),
+    (6, 'LAYER1_SCALE', _DTYPE_INT32, _QUANT_NONE),
+    (7, 'OUTPUT_WEIGHT', _DTYPE_INT8, _QUANT_PER_CHANNEL),
+    (8, 'OUTPUT_BIAS', _DTYPE_INT32, _QUANT_PER_CHANNEL),
+    (9, 'OUTPUT_WEIGHT_ZP', _DTYPE_INT8, _QUANT_NONE),
+    (10, 'OUTPUT_FOLDED_BIAS', _DTYPE_INT32, _QUANT_PER_CHANNEL),
+    (11, 'LAYER2_MULTIPLIER', _DTYPE_UINT32, _QUANT_NONE),
+    (12, 'LAYER2_SCALE', _DTYPE_INT32, _QUANT_NONE),
+    (13, 'SOFTMAX_PARAMS', _DTYPE_INT32, _QUANT_NONE),
+    (14, 'PLAN', _DTYPE_UINT8, _QUANT_NONE),
+    (15, 'HIDDEN_ACTIVATION', _DTYPE_INT8, _QUANT_NONE),
+]
+
+
+def write_container(model, path):
+    tensors = {macro: data for macro, _, data in _tensors(model)}
+    layout = [entry for entry in _CONTAINER_TENSORS if entry[1] in tensors]
+    plan_size = len(_plan(model, {macro: 0 for macro in tensors})[0])
+    offsets, _ = _place([(macro, None, tensors[macro]) for _, macro, _, _ in layout], _CONTAINER_ALIGN, plan_size)
+    plan, _ = _plan(model, offsets)
+    tensors['PLAN'] = np.frombuffer(plan, dtype=np.uint8)
+
+    data = bytearray()
+    table = bytearray()
+    for tensor_id, macro, dtype, quant in layout:
+        payload = tensors[macro]
+        shape = payload.shape if payload.ndim == 2 else (payload.size, 1)
+        data += bytes(offsets[macro] - len(data)) + payload.tobytes()
+        table += struct.pack('<HBB2IIIBBHif', tensor_id, dtype, payload.ndim, shape[0], shape[1],
+                             offsets[macro], payload.nbytes, quant, 0, 0, 0, 0.0)
+
+    data_offset = _align_up(_CONTAINER_HEADER_SIZE + len(table), _CONTAINER_ALIGN)
+    header = struct.pack('<IHHIIIIIIIbbb9x', _CONTAINER_MAGIC, _CONTAINER_VERSION, len(layout),
+                         _CONTAINER_HEADER_SIZE + len(table), data_offset, len(data), zlib.crc32(data),
+                         model.hidden.weights.shape[1], model.hidden.weights.shape[0], model.output.weights.shape[0],
+                         model.hidden.input_zp, model.hidden.output_zp, model.output.output_zp)
+    container = header + table
+    container += bytes(data_offset - len(container)) + data
+    Path(path).write_bytes(container)
+    print(f"{path}: {len(container)} bytes")
+
+
+def main():
+    parser = ArgumentParser(description="params.c/params.h and/or a model container from a TFLite or float model")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--tflite', type=str, help="int8 TFLite model: FULLY_CONNECTED (ReLU/ReLU6), [LOGISTIC|TANH,] FULLY_CONNECTED, SOFTMAX")
+    source.add_argument('--float', type=str, help="float model and activation ranges (npz)")
+    parser.add_argument('--params', type=str, help="component directory to write params.c and include/params.h to")
+    parser.add_argument('--align', type=int, default=16, choices=[16, 32, 64],
+                        help="tensor alignment in g_params (16, or a cache line)")
+    parser.add_argument('--container', type=str, help="model container to write (see container.h)")
+    args = parser.parse_args()
+
+    if args.params is None and args.container is None:
+        parser.error("nothing to write: pass --params and/or --container")
+
+    try:
+        model = load_tflite(args.tflite) if args.tflite else load_float(args.float)
+        if args.params is not None:
+            write_params(model, args.params, args.align, args.tflite or args.float)
+        if args.container is not None:
+            write_container(model, args.container)
+        sys.exit(0)
+    except (RuntimeError, KeyError, OSError) as e:
+        print()
+        print(e)
+        sys.exit(-1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,185 @@
+from argparse import ArgumentParser
+import json
+import statistics
+import struct
+import sys
+import time
+from pathlib import *
+
+# profile.h
+_PROFILE_MAGIC = 0x544c504d
+_PROFILE_VERSION = 1
+_HEADER_FORMAT = '<IHHQIIII'
+_RECORD_FORMAT = '<QIBBH'
+_HEADER_SIZE = struct.calcsize(_HEADER_FORMAT)
+_RECORD_SIZE = struct.calcsize(_RECORD_FORMAT)
+_SCOPES = ['forward', 'dense1', 'requant', 'relu', 'dense2', 'softmax']
+_SCOPE_FORWARD = 0
+_SHARED_CLOCK = 0x1
+
+
+# -----------------------------------------------------------------------------
+# the last complete dump in data (a raw capture of the console, or mlp_bench
+# --profile): (clock_hz, dropped, shared, records), records as (start,
+# duration, scope, context, arg) with the starts unwrapped; shared is False
+# when every context has a clock of its own (the device cores), whose starts
+# can't be compared across contexts; None if there's none yet
+def parse_dump(data):
+    magic = struct.pack('<I', _PROFILE_MAGIC)
+    position = data.rfind(magic)
+    while position >= 0:
+        dump = _parse_at(data, position)
+        if dump is not None:
+            return dump
+        position = data.rfind(magic, 0, position)
+    return None
+
+
+def _parse_at(data, position):
+    if len(data) - position < _HEADER_SIZE:
+        return None
+    magic, version, record_size, clock_hz, clock_bits, count, dropped, flags = \
+        struct.unpack_from(_HEADER_FORMAT, data, position)
+    if version != _PROFILE_VERSION or record_size != _RECORD_SIZE or clock_hz == 0 or clock_bits not in (32, 64):
+        return None
+    end = position + _HEADER_SIZE + count * _RECORD_SIZE
+    if end > len(data):
+        return None
+
+    records = [struct.unpack_from(_RECORD_FORMAT, data, position + _HEADER_SIZE + i * _RECORD_SIZE)
+               for i in range(count)]
+    if clock_bits < 64:
+        records = _unwrap(records, clock_bits)
+    return clock_hz, dropped, (flags & _SHARED_CLOCK) != 0, records
+
+
+# -----------------------------------------------------------------------------
+# 32-bit cycle counters wrap (every ~18 s at 240 MHz); records come in the
+# order they ended, so consecutive starts of one core are close together and
+# each is unwrapped relative to the previous one; cores keep separate counters
+def _unwrap(records, clock_bits):
+    modulo = 1 << clock_bits
+    last = {}
+    unwrapped = []
+    for start, duration, scope, context, arg in records:
+        start &= modulo - 1
+        if context in last:
+            delta = (start - last[context]) % modulo
+            if delta >= modulo // 2:
+                delta -= modulo
+            start = last[context] + delta
+        last[context] = start
+        unwrapped.append((start, duration, scope, context, arg))
+    return unwrapped
+
+
+def _label(scope, arg):
+    name = _SCOPES[scope] if scope < len(_SCOPES) else f"scope{scope}"
+    return name if arg == 0 else f"{name} (layer {arg - 1})"
+
+
+# -----------------------------------------------------------------------------
+# per-stage breakdown: count, min/median/mean/max (cycles and us) and the
+# share of the forward passes' total; nested stages (relu inside dense1, in
+# dumps from builds that still ran it as a pass of its own) are counted in
+# both
+def print_breakdown(clock_hz, dropped, shared, records):
+    stages = {}
+    for _, duration, scope, _, arg in records:
+        stages.setdefault((scope, arg), []).append(duration)
+    forward = sum(sum(d) for (scope, _), d in stages.items() if scope == _SCOPE_FORWARD)
+    us = 1e6 / clock_hz
+
+    timebase = "shared" if shared else "one per context"
+    print(f"{len(records)} records ({dropped} dropped), clock {clock_hz / 1e6:.1f} MHz ({timebase})")
+    print(f"{'stage':<20} {'count':>6} {'min':>10} {'median':>10} {'mean':>10} {'max':>10} {'mean us':>9} {'share':>7}")
+    for scope, arg in sorted(stages):
+        durations = stages[(scope, arg)]
+        share = f"{100.0 * sum(durations) / forward:6.1f}%" if forward else f"{'-':>7}"
+        print(f"{_label(scope, arg):<20} {len(durations):>6} {min(durations):>10} "
+              f"{int(statistics.median(durations)):>10} {statistics.mean(durations):>10.0f} {max(durations):>10} "
+              f"{statistics.mean(durations) * us:>9.2f} {share}")
+
+
+# -----------------------------------------------------------------------------
+# Chrome trace (chrome://tracing, Perfetto): one complete event per record,
+# one thread per core (device) or thread (host), times in us from the first;
+# without a shared clock every context is a process of its own with its own
+# origin, so events of different cores line up by accident only
+def write_trace(clock_hz, shared, records, path):
+    origins = {}
+    for start, _, _, context, _ in records:
+        key = None if shared else context
+        origins[key] = min(origins.get(key, start), start)
+    events = []
+    if not shared:
+        for context in sorted(origins):
+            events.append({
+                'name': 'process_name',
+                'ph': 'M',
+                'pid': context,
+                'args': {'name': f"core {context} (own clock)"},
+            })
+    for start, duration, scope, context, arg in records:
+        events.append({
+            'name': _label(scope, arg),
+            'cat': 'mlp',
+            'ph': 'X',
+            'ts': (start - origins[None if shared else context]) * 1e6 / clock_hz,
+            'dur': duration * 1e6 / clock_hz,
+            'pid': 0 if shared else context,
+            'tid': context,
+            'args': {'cycles': duration},
+        })
+    Path(path).write_text(json.dumps({'traceEvents': events, 'displayTimeUnit': 'ns'}))
+    print(f"{path}: {len(records)} events")
+
+
+# -----------------------------------------------------------------------------
+# send the demo's "p" key and read until a complete dump came back
+def read_port(port, baud, timeout):
+    import serial
+
+    with serial.Serial(port, baud, timeout=0.1) as connection:
+        connection.reset_input_buffer()
+        connection.write(b'p')
+        data = bytearray()
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            data += connection.read(4096)
+            if parse_dump(bytes(data)) is not None:
+                return bytes(data)
+    raise RuntimeError(f"{port}: no profile dump within {timeout} s (is CONFIG_MLP_PROFILE on?)")
+
+
+def main():
+    parser = ArgumentParser(description="per-stage breakdown and Chrome trace from an esp_mlp profile dump (see profile.h)")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--input', type=str, help="raw capture of the console, or mlp_bench --profile output")
+    source.add_argument('--port', type=str, help="serial port of the demo: sends \"p\" and reads the dump")
+    parser.add_argument('--baud', type=int, default=115200, help="console baud rate")
+    parser.add_argument('--timeout', type=float, default=10.0, help="seconds to wait for the dump on --port")
+    parser.add_argument('--save', type=str, help="raw dump to write (with --port)")
+    parser.add_argument('--trace', type=str, help="Chrome trace JSON to write")
+    args = parser.parse_args()
+
+    try:
+        data = read_port(args.port, args.baud, args.timeout) if args.port else Path(args.input).read_bytes()
+        if args.save is not None:
+            Path(args.save).write_bytes(data)
+        dump = parse_dump(data)
+        if dump is None:
+            raise RuntimeError("no complete profile dump found")
+        clock_hz, dropped, shared, records = dump
+        print_breakdown(clock_hz, dropped, shared, records)
+        if args.trace is not None:
+            write_trace(clock_hz, shared, records, args.trace)
+        sys.exit(0)
+    except (RuntimeError, OSError, ImportError) as e:
+        print()
+        print(e)
+        sys.exit(-1)
+
+
+if __name__ == "__main__":
+    main()
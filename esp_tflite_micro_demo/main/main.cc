@@ -1,6 +1,7 @@
 #include "esp_cpu.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "latency_bench.h"
 #include "led_strip.h"
 #include "model.h"
 #include "portmacro.h"
@@ -118,6 +119,38 @@ static void hsv2rgb(uint8_t hsv[], uint8_t rgb[])
     }
 }
 
+// Invoke() benchmarked once at boot (see latency_bench.h), on x = 0: in a
+// critical section, then preemptible, then with a cold cache
+// (CONFIG_LATENCY_BENCH_COLD)
+static void bench_invoke(void *arg)
+{
+    static_cast<tflite::MicroInterpreter *>(arg)->Invoke();
+}
+
+static void run_benchmark(tflite::MicroInterpreter *interpreter)
+{
+    const latency_bench_mode_t modes[] = {LATENCY_BENCH_CRITICAL, LATENCY_BENCH_PREEMPTIBLE};
+    for (latency_bench_mode_t mode : modes)
+    {
+        latency_bench_stats_t stats;
+        if (latency_bench_run(mode, bench_invoke, interpreter, &stats) != 0)
+        {
+            MicroPrintf("Benchmark failed");
+            return;
+        }
+        latency_bench_print("tflite_micro_hello_world", "Invoke", &stats);
+    }
+#if CONFIG_LATENCY_BENCH_COLD
+    latency_bench_stats_t stats;
+    if (latency_bench_run_cold(LATENCY_BENCH_CRITICAL, bench_invoke, interpreter, &stats) != 0)
+    {
+        MicroPrintf("Cold benchmark failed (no \"%s\" partition?)", CONFIG_LATENCY_BENCH_EVICT_PARTITION);
+        return;
+    }
+    latency_bench_print("tflite_micro_hello_world", "Invoke", &stats);
+#endif
+}
+
 extern "C" void app_main(void)
 {
     led_strip_config_t strip_config = {
@@ -167,6 +200,9 @@ extern "C" void app_main(void)
     TfLiteTensor *input = interpreter.input(0);
     TfLiteTensor *output = interpreter.output(0);
 
+    input->data.int8[0] = input->params.zero_point;
+    run_benchmark(&interpreter);
+
     int inference_count = 0;
     while (true)
     {
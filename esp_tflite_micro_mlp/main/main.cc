@@ -4,6 +4,7 @@
 #include "driver/uart.h"
 #include "driver/uart_vfs.h"
 #include "input.h"
+#include "latency_bench.h"
 #include "model.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
 #include "tensorflow/lite/micro/micro_log.h"
@@ -141,6 +142,38 @@ void print_TfLiteTensor(const TfLiteTensor *tensor)
     MicroPrintf("\n");
 }
 
+// 'm' benchmarks Invoke() on the selected digit (see latency_bench.h): in a
+// critical section, then preemptible, then with a cold cache
+// (CONFIG_LATENCY_BENCH_COLD)
+static void bench_invoke(void *arg)
+{
+    static_cast<tflite::MicroInterpreter *>(arg)->Invoke();
+}
+
+static void run_benchmark(tflite::MicroInterpreter *interpreter)
+{
+    const latency_bench_mode_t modes[] = {LATENCY_BENCH_CRITICAL, LATENCY_BENCH_PREEMPTIBLE};
+    for (latency_bench_mode_t mode : modes)
+    {
+        latency_bench_stats_t stats;
+        if (latency_bench_run(mode, bench_invoke, interpreter, &stats) != 0)
+        {
+            MicroPrintf("Benchmark failed");
+            return;
+        }
+        latency_bench_print("esp_tflite_micro_mlp", "Invoke", &stats);
+    }
+#if CONFIG_LATENCY_BENCH_COLD
+    latency_bench_stats_t stats;
+    if (latency_bench_run_cold(LATENCY_BENCH_CRITICAL, bench_invoke, interpreter, &stats) != 0)
+    {
+        MicroPrintf("Cold benchmark failed (no \"%s\" partition?)", CONFIG_LATENCY_BENCH_EVICT_PARTITION);
+        return;
+    }
+    latency_bench_print("esp_tflite_micro_mlp", "Invoke", &stats);
+#endif
+}
+
 extern "C" void app_main(void)
 {
     uart_driver_install(uart_port_t(CONFIG_ESP_CONSOLE_UART_NUM), 256, 0, 0, nullptr, 0);
@@ -211,9 +244,11 @@ extern "C" void app_main(void)
     TfLiteTensor *output = interpreter.output(0);
     assert(output->bytes == 10);
 
+    memcpy((void *)input->data.raw, (void *)g_zero_input, g_input_len);
+
     while (true)
     {
-        MicroPrintf("Select digit [0-9]: ");
+        MicroPrintf("Select digit [0-9], benchmark it [m]: ");
         char c = (char)getchar();
         MicroPrintf("%c", c);
         switch (c)
@@ -248,6 +283,9 @@ extern "C" void app_main(void)
         case '9':
             memcpy((void *)input->data.raw, (void *)g_nine_input, g_input_len);
             break;
+        case 'm':
+            run_benchmark(&interpreter);
+            continue;
         default:
             MicroPrintf("Invalid digit: %c", c);
             continue;